@@ -3,6 +3,16 @@ const C3 = globalThis.C3;
 
 C3.Plugins.EpicGames_Ext.Acts =
 {
+	async SetEOSLogLevels(logLevels)
+    {
+        await this.setEOSLogLevels(logLevels);
+    },
+
+	async SetSpanTracing(enable)
+    {
+        await this.setSpanTracing(enable);
+    },
+
 	async LogInPortal()
     {
         await this.logInPortal();
@@ -31,5 +41,16 @@ C3.Plugins.EpicGames_Ext.Acts =
     async UnlockAchievement(achievementId)
     {
         await this.unlockAchievement(achievementId);
+    },
+
+    async UnlockAchievements(achievementIds)
+    {
+        const idArr = achievementIds.split(",").map(id => id.trim()).filter(id => id);
+        await this.unlockAchievements(idArr);
+    },
+
+    async RefreshMetrics(reset)
+    {
+        await this.getMetrics(reset);
     }
 };
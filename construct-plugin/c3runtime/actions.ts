@@ -5,6 +5,16 @@ const C3 = globalThis.C3;
 
 C3.Plugins.EpicGames_Ext.Acts =
 {
+	async SetEOSLogLevels(this: SDKInstanceClass, logLevels: string)
+    {
+        await this.setEOSLogLevels(logLevels);
+    },
+
+	async SetSpanTracing(this: SDKInstanceClass, enable: boolean)
+    {
+        await this.setSpanTracing(enable);
+    },
+
 	async LogInPortal(this: SDKInstanceClass)
     {
         await this.logInPortal();
@@ -33,5 +43,16 @@ C3.Plugins.EpicGames_Ext.Acts =
     async UnlockAchievement(this: SDKInstanceClass, achievementId: string)
     {
         await this.unlockAchievement(achievementId);
+    },
+
+    async UnlockAchievements(this: SDKInstanceClass, achievementIds: string)
+    {
+        const idArr = achievementIds.split(",").map(id => id.trim()).filter(id => id);
+        await this.unlockAchievements(idArr);
+    },
+
+    async RefreshMetrics(this: SDKInstanceClass, reset: boolean)
+    {
+        await this.getMetrics(reset);
     }
 };
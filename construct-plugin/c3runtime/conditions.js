@@ -59,6 +59,16 @@ C3.Plugins.EpicGames_Ext.Cnds =
 	},
 
 	OnAchievementUnlockError(achievement)
+	{
+		return achievement.toLowerCase() === this._triggerAchievement.toLowerCase();
+	},
+
+	OnAnyAchievementUnlockDeferred()
+	{
+		return true;
+	},
+
+	OnAchievementUnlockDeferred(achievement)
 	{
 		return achievement.toLowerCase() === this._triggerAchievement.toLowerCase();
 	}
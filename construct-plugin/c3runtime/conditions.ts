@@ -61,6 +61,16 @@ C3.Plugins.EpicGames_Ext.Cnds =
 	},
 
 	OnAchievementUnlockError(this: SDKInstanceClass, achievement: string)
+	{
+		return achievement.toLowerCase() === this._triggerAchievement.toLowerCase();
+	},
+
+	OnAnyAchievementUnlockDeferred(this: SDKInstanceClass)
+	{
+		return true;
+	},
+
+	OnAchievementUnlockDeferred(this: SDKInstanceClass, achievement: string)
 	{
 		return achievement.toLowerCase() === this._triggerAchievement.toLowerCase();
 	}
@@ -46,5 +46,20 @@ C3.Plugins.EpicGames_Ext.Exps =
     Achievement()
 	{
 		return this._triggerAchievement;
-	}
+	},
+
+    MessageLatencyP50(message, stage)
+    {
+        return this._getMetricsValue(message, stage, "p50Ms");
+    },
+
+    MessageLatencyP99(message, stage)
+    {
+        return this._getMetricsValue(message, stage, "p99Ms");
+    },
+
+    MessageLatencyCount(message, stage)
+    {
+        return this._getMetricsValue(message, stage, "count");
+    }
 };
@@ -48,5 +48,20 @@ C3.Plugins.EpicGames_Ext.Exps =
     Achievement(this: SDKInstanceClass)
 	{
 		return this._triggerAchievement;
-	}
+	},
+
+    MessageLatencyP50(this: SDKInstanceClass, message: string, stage: string)
+    {
+        return this._getMetricsValue(message, stage, "p50Ms");
+    },
+
+    MessageLatencyP99(this: SDKInstanceClass, message: string, stage: string)
+    {
+        return this._getMetricsValue(message, stage, "p99Ms");
+    },
+
+    MessageLatencyCount(this: SDKInstanceClass, message: string, stage: string)
+    {
+        return this._getMetricsValue(message, stage, "count");
+    }
 };
@@ -13,6 +13,9 @@ C3.Plugins.EpicGames_Ext.Instance = class EpicGames_ExtInstance extends globalTh
 		// For ticking while loading
 		this._loadingTimerId = -1;
 
+		// When using native tick, the wrapper extension ticks the Epic Games SDK itself
+		this._useNativeTick = false;
+
 		// Properties
 		// Auth scope flags
 		this._scopeBasicProfile = true;
@@ -36,6 +39,9 @@ C3.Plugins.EpicGames_Ext.Instance = class EpicGames_ExtInstance extends globalTh
 
 		// For triggers
 		this._triggerAchievement = "";
+
+		// Latency metrics from the last "Refresh metrics" action
+		this._metrics = {};
 		
 		const properties = this._getInitProperties();
 		if (properties)
@@ -48,6 +54,7 @@ C3.Plugins.EpicGames_Ext.Instance = class EpicGames_ExtInstance extends globalTh
 			this._scopeFriendsList = properties[8];
 			this._scopePresence = properties[9];
 			this._scopeCountry = properties[10];
+			this._useNativeTick = properties[11];
 		}
 
 		// Listen for login status change events from the extension.
@@ -64,16 +71,21 @@ C3.Plugins.EpicGames_Ext.Instance = class EpicGames_ExtInstance extends globalTh
 			// once the loading screen finishes. In order to allow Epic Games to continue ticking while
 			// the loading screen is showing, set a timer to tick every 20ms until the first tick,
 			// which then clears the timer.
-			this._loadingTimerId = globalThis.setInterval(() => this._platformTick(), 20);
-
-			this._setTicking(true);
+			// In native tick mode the wrapper extension ticks on its own thread instead, so none of
+			// this is necessary.
+			if (!this._useNativeTick)
+			{
+				this._loadingTimerId = globalThis.setInterval(() => this._platformTick(), 20);
+
+				this._setTicking(true);
+			}
 		}
 	}
 	
 	async _init()
 	{
 		// Send init message to wrapper extension and wait for result.
-		const result = await this._sendWrapperExtensionMessageAsync("init");
+		const result = await this._sendMessageAsync("init", []);
 		
 		// Check availability of Epic Games features.
 		this._isAvailable = result["isAvailable"];
@@ -90,6 +102,18 @@ C3.Plugins.EpicGames_Ext.Instance = class EpicGames_ExtInstance extends globalTh
 		super._release();
 	}
 
+	// Wrappers for sending messages to the wrapper extension. The parameters for each message
+	// must match the message table in WebMessages.h.
+	_sendMessage(messageId, params)
+	{
+		this._sendWrapperExtensionMessage(messageId, params);
+	}
+
+	_sendMessageAsync(messageId, params)
+	{
+		return this._sendWrapperExtensionMessageAsync(messageId, params);
+	}
+
 	_tick()
 	{
 		// On the first tick, clear the timer running for the loading screen.
@@ -105,7 +129,93 @@ C3.Plugins.EpicGames_Ext.Instance = class EpicGames_ExtInstance extends globalTh
 	_platformTick()
 	{
 		// Tell extension to call EOS_Platform_Tick().
-		this._sendWrapperExtensionMessage("platform-tick");
+		this._sendMessage("platform-tick", []);
+	}
+
+	async getTickStatus()
+	{
+		// Retrieve diagnostic details about the wrapper extension's adaptive tick rate, including the
+		// current tick rate and the number of in-flight async operations.
+		if (!this._isAvailable)
+			return null;
+
+		return await this._sendMessageAsync("get-tick-status", []);
+	}
+
+	async setEOSLogLevels(logLevels)
+	{
+		// Change the Epic Games SDK log levels per category, e.g. "all=warning, auth=verbose". Returns the
+		// resulting levels for all categories in the same format, or null if the string was not valid.
+		if (!this._isAvailable)
+			return null;
+
+		const result = await this._sendMessageAsync("set-eos-log-levels", [logLevels]);
+		return result["isOk"] ? result["logLevels"] : null;
+	}
+
+	async setSpanTracing(enable)
+	{
+		// Start or stop recording a timeline of the wrapper extension's message handling, Epic Games SDK ticks
+		// and callbacks. Stopping writes it as Chrome trace-event JSON, which can be loaded in chrome://tracing
+		// or Perfetto, and returns the path of the file. Returns null if it could not be written.
+		if (!this._isAvailable)
+			return null;
+
+		const result = await this._sendMessageAsync("set-span-tracing", [enable]);
+		if (!result["isOk"])
+			return null;
+
+		return enable ? "" : result["path"];
+	}
+
+	async getTickProfile(reset)
+	{
+		// Retrieve the wrapper extension's profile of ticking the Epic Games SDK: percentiles of tick durations,
+		// and the worst ticks over the spike threshold with timings of the callbacks that ran in them. If reset
+		// is true the profile is cleared afterwards.
+		if (!this._isAvailable)
+			return null;
+
+		const result = await this._sendMessageAsync("get-tick-profile", [reset]);
+		if (!result["isOk"])
+			return null;
+
+		return JSON.parse(result["profile"]);
+	}
+
+	async runBenchmarks()
+	{
+		// Run the wrapper extension's built-in benchmarks. These are only available if the wrapper
+		// extension was built with EPICEXT_BENCHMARKS defined, otherwise the result has isOk false.
+		// The results are also saved as JSON in the app data folder, at the path in the result.
+		if (!this._isAvailable)
+			return null;
+
+		return await this._sendMessageAsync("run-benchmarks", []);
+	}
+
+	async getMetrics(reset)
+	{
+		// Retrieve latency histogram percentiles for each stage of handling each kind of message, keyed by
+		// message name then stage name. If reset is true the histograms are cleared afterwards, so the next
+		// call only covers the time since this one. The result is also kept for the metrics expressions.
+		if (!this._isAvailable)
+			return null;
+
+		const result = await this._sendMessageAsync("get-metrics", [reset]);
+		if (!result["isOk"])
+			return null;
+
+		this._metrics = JSON.parse(result["metrics"]);
+		return this._metrics;
+	}
+
+	_getMetricsValue(message, stage, key)
+	{
+		// Return 0 for any message or stage with nothing recorded.
+		const messageMetrics = this._metrics[message];
+		const stageMetrics = messageMetrics?.[stage];
+		return stageMetrics?.[key] ?? 0;
 	}
 
 	get isAvailable()
@@ -131,7 +241,7 @@ C3.Plugins.EpicGames_Ext.Instance = class EpicGames_ExtInstance extends globalTh
 		// Set portal login type for 'Compare login type' condition
 		this._loginType = 0;
 
-		const result = await this._sendWrapperExtensionMessageAsync("log-in-portal", [
+		const result = await this._sendMessageAsync("log-in-portal", [
 			this._scopeBasicProfile,
 			this._scopeFriendsList,
 			this._scopePresence,
@@ -149,7 +259,7 @@ C3.Plugins.EpicGames_Ext.Instance = class EpicGames_ExtInstance extends globalTh
 		// Set persistent login type for 'Compare login type' condition
 		this._loginType = 1;
 
-		const result = await this._sendWrapperExtensionMessageAsync("log-in-persistent", [
+		const result = await this._sendMessageAsync("log-in-persistent", [
 			this._scopeBasicProfile,
 			this._scopeFriendsList,
 			this._scopePresence,
@@ -167,7 +277,7 @@ C3.Plugins.EpicGames_Ext.Instance = class EpicGames_ExtInstance extends globalTh
 		// Set exchange code login type for 'Compare login type' condition
 		this._loginType = 2;
 
-		const result = await this._sendWrapperExtensionMessageAsync("log-in-exchange-code", [
+		const result = await this._sendMessageAsync("log-in-exchange-code", [
 			this._scopeBasicProfile,
 			this._scopeFriendsList,
 			this._scopePresence,
@@ -186,7 +296,7 @@ C3.Plugins.EpicGames_Ext.Instance = class EpicGames_ExtInstance extends globalTh
 		// Set DevAuthTool login type for 'Compare login type' condition
 		this._loginType = 3;
 
-		const result = await this._sendWrapperExtensionMessageAsync("log-in-devauthtool", [
+		const result = await this._sendMessageAsync("log-in-devauthtool", [
 			this._scopeBasicProfile,
 			this._scopeFriendsList,
 			this._scopePresence,
@@ -223,7 +333,7 @@ C3.Plugins.EpicGames_Ext.Instance = class EpicGames_ExtInstance extends globalTh
 		if (!this._isAvailable)
 			return;
 
-		const result = await this._sendWrapperExtensionMessageAsync("log-out");
+		const result = await this._sendMessageAsync("log-out", []);
 
 		if (result["isOk"])
 		{
@@ -309,12 +419,18 @@ C3.Plugins.EpicGames_Ext.Instance = class EpicGames_ExtInstance extends globalTh
 		if (!this._isAvailable)
 			return false;
 		
-		const result = await this._sendWrapperExtensionMessageAsync("unlock-achievement", [achievement]);
+		const result = await this._sendMessageAsync("unlock-achievement", [achievement]);
 
 		this._triggerAchievement = achievement;
 
+		// A deferred unlock could not be sent yet, but is saved by the wrapper extension to retry later.
 		const isOk = result["isOk"];
-		if (isOk)
+		if (isOk && result["isDeferred"])
+		{
+			this._trigger(C3.Plugins.EpicGames_Ext.Cnds.OnAnyAchievementUnlockDeferred);
+			this._trigger(C3.Plugins.EpicGames_Ext.Cnds.OnAchievementUnlockDeferred);
+		}
+		else if (isOk)
 		{
 			this._trigger(C3.Plugins.EpicGames_Ext.Cnds.OnAnyAchievementUnlockSuccess);
 			this._trigger(C3.Plugins.EpicGames_Ext.Cnds.OnAchievementUnlockSuccess);
@@ -328,6 +444,69 @@ C3.Plugins.EpicGames_Ext.Instance = class EpicGames_ExtInstance extends globalTh
 		// Return result for script interface
 		return isOk;
 	}
+
+	async isAchievementUnlocked(achievement)
+	{
+		// Answered from the wrapper extension's cache of the player's achievements, without a backend
+		// call. Returns null if the achievement state is not loaded yet or the achievement is unknown.
+		if (!this._isAvailable)
+			return null;
+		
+		const result = await this._sendMessageAsync("is-achievement-unlocked", [achievement]);
+		return result["isOk"] ? result["isUnlocked"] : null;
+	}
+
+	async getAchievementProgress(achievement)
+	{
+		// Also answered from the cache. Returns an object with the progress from 0-1 and the unlock time
+		// as a POSIX timestamp (or -1 if locked), or null if not known.
+		if (!this._isAvailable)
+			return null;
+		
+		const result = await this._sendMessageAsync("get-achievement-progress", [achievement]);
+		if (!result["isOk"])
+			return null;
+		
+		return {
+			progress: result["progress"],
+			unlockTime: result["unlockTime"]
+		};
+	}
+
+	async unlockAchievements(achievements)
+	{
+		if (!this._isAvailable || achievements.length === 0)
+			return false;
+		
+		// Sent as one message with a JSON array of IDs. The result applies to the whole list.
+		const result = await this._sendMessageAsync("unlock-achievements", [JSON.stringify(achievements)]);
+
+		const isOk = result["isOk"];
+		const isDeferred = isOk && result["isDeferred"];
+		for (const achievement of achievements)
+		{
+			this._triggerAchievement = achievement;
+
+			if (isDeferred)
+			{
+				this._trigger(C3.Plugins.EpicGames_Ext.Cnds.OnAnyAchievementUnlockDeferred);
+				this._trigger(C3.Plugins.EpicGames_Ext.Cnds.OnAchievementUnlockDeferred);
+			}
+			else if (isOk)
+			{
+				this._trigger(C3.Plugins.EpicGames_Ext.Cnds.OnAnyAchievementUnlockSuccess);
+				this._trigger(C3.Plugins.EpicGames_Ext.Cnds.OnAchievementUnlockSuccess);
+			}
+			else
+			{
+				this._trigger(C3.Plugins.EpicGames_Ext.Cnds.OnAnyAchievementUnlockError);
+				this._trigger(C3.Plugins.EpicGames_Ext.Cnds.OnAchievementUnlockError);
+			}
+		}
+
+		// Return result for script interface
+		return isOk;
+	}
 	
 	_saveToJson()
 	{
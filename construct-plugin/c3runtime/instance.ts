@@ -1,10 +1,33 @@
 
 const C3 = globalThis.C3;
 
+// Parameter types for each message sent to the wrapper extension. This must be kept in sync with the
+// message table in WebMessages.h, which rejects messages with parameters that don't match.
+type WrapperMessageParams = {
+	"init": [],
+	"platform-tick": [],
+	"get-tick-status": [],
+	"run-benchmarks": [],
+	"get-metrics": [boolean],		// reset after reading
+	"get-tick-profile": [boolean],	// reset after reading
+	"set-eos-log-levels": [string],	// e.g. "all=warning, auth=verbose"
+	"set-span-tracing": [boolean],	// enable, or disable and write the trace
+	"log-in-portal": [boolean, boolean, boolean, boolean],
+	"log-in-persistent": [boolean, boolean, boolean, boolean],
+	"log-in-exchange-code": [boolean, boolean, boolean, boolean, string],
+	"log-in-devauthtool": [boolean, boolean, boolean, boolean, string, string],
+	"log-out": [],
+	"unlock-achievement": [string],
+	"unlock-achievements": [string],		// JSON array of achievement IDs
+	"is-achievement-unlocked": [string],
+	"get-achievement-progress": [string]
+};
+
 class EpicGames_ExtInstance extends globalThis.ISDKInstanceBase
 {
 	_isAvailable: boolean;
 	_loadingTimerId: number;
+	_useNativeTick: boolean;
 
 	_scopeBasicProfile: boolean;
 	_scopeFriendsList: boolean;
@@ -25,6 +48,8 @@ class EpicGames_ExtInstance extends globalThis.ISDKInstanceBase
 
 	_triggerAchievement: string;
 
+	_metrics: JSONObject;
+
 	constructor()
 	{
 		// Set "scirra-epic-games" component ID, matching the same component ID set by the wrapper extension.
@@ -35,6 +60,9 @@ class EpicGames_ExtInstance extends globalThis.ISDKInstanceBase
 		// For ticking while loading
 		this._loadingTimerId = -1;
 
+		// When using native tick, the wrapper extension ticks the Epic Games SDK itself
+		this._useNativeTick = false;
+
 		// Properties
 		// Auth scope flags
 		this._scopeBasicProfile = true;
@@ -58,6 +86,9 @@ class EpicGames_ExtInstance extends globalThis.ISDKInstanceBase
 
 		// For triggers
 		this._triggerAchievement = "";
+
+		// Latency metrics from the last "Refresh metrics" action
+		this._metrics = {};
 		
 		const properties = this._getInitProperties();
 		if (properties)
@@ -70,6 +101,7 @@ class EpicGames_ExtInstance extends globalThis.ISDKInstanceBase
 			this._scopeFriendsList = properties[8] as boolean;
 			this._scopePresence = properties[9] as boolean;
 			this._scopeCountry = properties[10] as boolean;
+			this._useNativeTick = properties[11] as boolean;
 		}
 
 		// Listen for login status change events from the extension.
@@ -86,16 +118,21 @@ class EpicGames_ExtInstance extends globalThis.ISDKInstanceBase
 			// once the loading screen finishes. In order to allow Epic Games to continue ticking while
 			// the loading screen is showing, set a timer to tick every 20ms until the first tick,
 			// which then clears the timer.
-			this._loadingTimerId = globalThis.setInterval(() => this._platformTick(), 20);
-
-			this._setTicking(true);
+			// In native tick mode the wrapper extension ticks on its own thread instead, so none of
+			// this is necessary.
+			if (!this._useNativeTick)
+			{
+				this._loadingTimerId = globalThis.setInterval(() => this._platformTick(), 20);
+
+				this._setTicking(true);
+			}
 		}
 	}
 	
 	async _init()
 	{
 		// Send init message to wrapper extension and wait for result.
-		const result = await this._sendWrapperExtensionMessageAsync("init") as JSONObject;
+		const result = await this._sendMessageAsync("init", []);
 		
 		// Check availability of Epic Games features.
 		this._isAvailable = result["isAvailable"] as boolean;
@@ -112,6 +149,18 @@ class EpicGames_ExtInstance extends globalThis.ISDKInstanceBase
 		super._release();
 	}
 
+	// Typed wrappers for sending messages to the wrapper extension, using WrapperMessageParams
+	// to check the correct parameters are sent for each message.
+	_sendMessage<K extends keyof WrapperMessageParams>(messageId: K, params: WrapperMessageParams[K])
+	{
+		this._sendWrapperExtensionMessage(messageId, params);
+	}
+
+	_sendMessageAsync<K extends keyof WrapperMessageParams>(messageId: K, params: WrapperMessageParams[K])
+	{
+		return this._sendWrapperExtensionMessageAsync(messageId, params) as Promise<JSONObject>;
+	}
+
 	_tick()
 	{
 		// On the first tick, clear the timer running for the loading screen.
@@ -127,7 +176,93 @@ class EpicGames_ExtInstance extends globalThis.ISDKInstanceBase
 	_platformTick()
 	{
 		// Tell extension to call EOS_Platform_Tick().
-		this._sendWrapperExtensionMessage("platform-tick");
+		this._sendMessage("platform-tick", []);
+	}
+
+	async getTickStatus()
+	{
+		// Retrieve diagnostic details about the wrapper extension's adaptive tick rate, including the
+		// current tick rate and the number of in-flight async operations.
+		if (!this._isAvailable)
+			return null;
+
+		return await this._sendMessageAsync("get-tick-status", []);
+	}
+
+	async setEOSLogLevels(logLevels: string)
+	{
+		// Change the Epic Games SDK log levels per category, e.g. "all=warning, auth=verbose". Returns the
+		// resulting levels for all categories in the same format, or null if the string was not valid.
+		if (!this._isAvailable)
+			return null;
+
+		const result = await this._sendMessageAsync("set-eos-log-levels", [logLevels]);
+		return result["isOk"] ? result["logLevels"] as string : null;
+	}
+
+	async setSpanTracing(enable: boolean)
+	{
+		// Start or stop recording a timeline of the wrapper extension's message handling, Epic Games SDK ticks
+		// and callbacks. Stopping writes it as Chrome trace-event JSON, which can be loaded in chrome://tracing
+		// or Perfetto, and returns the path of the file. Returns null if it could not be written.
+		if (!this._isAvailable)
+			return null;
+
+		const result = await this._sendMessageAsync("set-span-tracing", [enable]);
+		if (!result["isOk"])
+			return null;
+
+		return enable ? "" : result["path"] as string;
+	}
+
+	async getTickProfile(reset: boolean)
+	{
+		// Retrieve the wrapper extension's profile of ticking the Epic Games SDK: percentiles of tick durations,
+		// and the worst ticks over the spike threshold with timings of the callbacks that ran in them. If reset
+		// is true the profile is cleared afterwards.
+		if (!this._isAvailable)
+			return null;
+
+		const result = await this._sendMessageAsync("get-tick-profile", [reset]);
+		if (!result["isOk"])
+			return null;
+
+		return JSON.parse(result["profile"] as string) as JSONObject;
+	}
+
+	async runBenchmarks()
+	{
+		// Run the wrapper extension's built-in benchmarks. These are only available if the wrapper
+		// extension was built with EPICEXT_BENCHMARKS defined, otherwise the result has isOk false.
+		// The results are also saved as JSON in the app data folder, at the path in the result.
+		if (!this._isAvailable)
+			return null;
+
+		return await this._sendMessageAsync("run-benchmarks", []);
+	}
+
+	async getMetrics(reset: boolean)
+	{
+		// Retrieve latency histogram percentiles for each stage of handling each kind of message, keyed by
+		// message name then stage name. If reset is true the histograms are cleared afterwards, so the next
+		// call only covers the time since this one. The result is also kept for the metrics expressions.
+		if (!this._isAvailable)
+			return null;
+
+		const result = await this._sendMessageAsync("get-metrics", [reset]);
+		if (!result["isOk"])
+			return null;
+
+		this._metrics = JSON.parse(result["metrics"] as string) as JSONObject;
+		return this._metrics;
+	}
+
+	_getMetricsValue(message: string, stage: string, key: string)
+	{
+		// Return 0 for any message or stage with nothing recorded.
+		const messageMetrics = this._metrics[message] as JSONObject | undefined;
+		const stageMetrics = messageMetrics?.[stage] as JSONObject | undefined;
+		return (stageMetrics?.[key] ?? 0) as number;
 	}
 
 	get isAvailable()
@@ -153,14 +288,14 @@ class EpicGames_ExtInstance extends globalThis.ISDKInstanceBase
 		// Set portal login type for 'Compare login type' condition
 		this._loginType = 0;
 
-		const result = await this._sendWrapperExtensionMessageAsync("log-in-portal", [
+		const result = await this._sendMessageAsync("log-in-portal", [
 			this._scopeBasicProfile,
 			this._scopeFriendsList,
 			this._scopePresence,
 			this._scopeCountry
 		]);
 
-		this._handleLogInResult(result as JSONObject);
+		this._handleLogInResult(result);
 	}
 
 	async logInPersistent()
@@ -171,14 +306,14 @@ class EpicGames_ExtInstance extends globalThis.ISDKInstanceBase
 		// Set persistent login type for 'Compare login type' condition
 		this._loginType = 1;
 
-		const result = await this._sendWrapperExtensionMessageAsync("log-in-persistent", [
+		const result = await this._sendMessageAsync("log-in-persistent", [
 			this._scopeBasicProfile,
 			this._scopeFriendsList,
 			this._scopePresence,
 			this._scopeCountry
 		]);
 
-		this._handleLogInResult(result as JSONObject);
+		this._handleLogInResult(result);
 	}
 
 	async logInExchangeCode(exchangeCode: string)
@@ -189,7 +324,7 @@ class EpicGames_ExtInstance extends globalThis.ISDKInstanceBase
 		// Set exchange code login type for 'Compare login type' condition
 		this._loginType = 2;
 
-		const result = await this._sendWrapperExtensionMessageAsync("log-in-exchange-code", [
+		const result = await this._sendMessageAsync("log-in-exchange-code", [
 			this._scopeBasicProfile,
 			this._scopeFriendsList,
 			this._scopePresence,
@@ -197,7 +332,7 @@ class EpicGames_ExtInstance extends globalThis.ISDKInstanceBase
 			exchangeCode
 		]);
 
-		this._handleLogInResult(result as JSONObject);
+		this._handleLogInResult(result);
 	}
 
 	async logInDevAuthTool(host: string, credentialName: string)
@@ -208,7 +343,7 @@ class EpicGames_ExtInstance extends globalThis.ISDKInstanceBase
 		// Set DevAuthTool login type for 'Compare login type' condition
 		this._loginType = 3;
 
-		const result = await this._sendWrapperExtensionMessageAsync("log-in-devauthtool", [
+		const result = await this._sendMessageAsync("log-in-devauthtool", [
 			this._scopeBasicProfile,
 			this._scopeFriendsList,
 			this._scopePresence,
@@ -217,7 +352,7 @@ class EpicGames_ExtInstance extends globalThis.ISDKInstanceBase
 			credentialName
 		]);
 
-		this._handleLogInResult(result as JSONObject);
+		this._handleLogInResult(result);
 	}
 
 	_handleLogInResult(result: JSONObject)
@@ -245,7 +380,7 @@ class EpicGames_ExtInstance extends globalThis.ISDKInstanceBase
 		if (!this._isAvailable)
 			return;
 
-		const result = await this._sendWrapperExtensionMessageAsync("log-out") as JSONObject;
+		const result = await this._sendMessageAsync("log-out", []);
 
 		if (result["isOk"])
 		{
@@ -331,12 +466,18 @@ class EpicGames_ExtInstance extends globalThis.ISDKInstanceBase
 		if (!this._isAvailable)
 			return false;
 		
-		const result = await this._sendWrapperExtensionMessageAsync("unlock-achievement", [achievement]) as JSONObject;
+		const result = await this._sendMessageAsync("unlock-achievement", [achievement]);
 
 		this._triggerAchievement = achievement;
 
+		// A deferred unlock could not be sent yet, but is saved by the wrapper extension to retry later.
 		const isOk = result["isOk"];
-		if (isOk)
+		if (isOk && result["isDeferred"])
+		{
+			this._trigger(C3.Plugins.EpicGames_Ext.Cnds.OnAnyAchievementUnlockDeferred);
+			this._trigger(C3.Plugins.EpicGames_Ext.Cnds.OnAchievementUnlockDeferred);
+		}
+		else if (isOk)
 		{
 			this._trigger(C3.Plugins.EpicGames_Ext.Cnds.OnAnyAchievementUnlockSuccess);
 			this._trigger(C3.Plugins.EpicGames_Ext.Cnds.OnAchievementUnlockSuccess);
@@ -350,6 +491,69 @@ class EpicGames_ExtInstance extends globalThis.ISDKInstanceBase
 		// Return result for script interface
 		return isOk;
 	}
+
+	async isAchievementUnlocked(achievement: string)
+	{
+		// Answered from the wrapper extension's cache of the player's achievements, without a backend
+		// call. Returns null if the achievement state is not loaded yet or the achievement is unknown.
+		if (!this._isAvailable)
+			return null;
+		
+		const result = await this._sendMessageAsync("is-achievement-unlocked", [achievement]);
+		return result["isOk"] ? result["isUnlocked"] : null;
+	}
+
+	async getAchievementProgress(achievement: string)
+	{
+		// Also answered from the cache. Returns an object with the progress from 0-1 and the unlock time
+		// as a POSIX timestamp (or -1 if locked), or null if not known.
+		if (!this._isAvailable)
+			return null;
+		
+		const result = await this._sendMessageAsync("get-achievement-progress", [achievement]);
+		if (!result["isOk"])
+			return null;
+		
+		return {
+			progress: result["progress"],
+			unlockTime: result["unlockTime"]
+		};
+	}
+
+	async unlockAchievements(achievements: string[])
+	{
+		if (!this._isAvailable || achievements.length === 0)
+			return false;
+		
+		// Sent as one message with a JSON array of IDs. The result applies to the whole list.
+		const result = await this._sendMessageAsync("unlock-achievements", [JSON.stringify(achievements)]);
+
+		const isOk = result["isOk"];
+		const isDeferred = isOk && result["isDeferred"];
+		for (const achievement of achievements)
+		{
+			this._triggerAchievement = achievement;
+
+			if (isDeferred)
+			{
+				this._trigger(C3.Plugins.EpicGames_Ext.Cnds.OnAnyAchievementUnlockDeferred);
+				this._trigger(C3.Plugins.EpicGames_Ext.Cnds.OnAchievementUnlockDeferred);
+			}
+			else if (isOk)
+			{
+				this._trigger(C3.Plugins.EpicGames_Ext.Cnds.OnAnyAchievementUnlockSuccess);
+				this._trigger(C3.Plugins.EpicGames_Ext.Cnds.OnAchievementUnlockSuccess);
+			}
+			else
+			{
+				this._trigger(C3.Plugins.EpicGames_Ext.Cnds.OnAnyAchievementUnlockError);
+				this._trigger(C3.Plugins.EpicGames_Ext.Cnds.OnAchievementUnlockError);
+			}
+		}
+
+		// Return result for script interface
+		return isOk;
+	}
 	
 	_saveToJson()
 	{
@@ -48,10 +48,21 @@ const PLUGIN_CLASS = SDK.Plugins.EpicGames_Ext = class EpicGames_Ext extends SDK
 			new SDK.PluginProperty("check", "scope-friends-list"),
 			new SDK.PluginProperty("check", "scope-presence"),
 			new SDK.PluginProperty("check", "scope-country"),
+
+			new SDK.PluginProperty("group", "advanced"),
+			new SDK.PluginProperty("check", "native-tick"),
+			new SDK.PluginProperty("integer", "native-tick-rate", { initialValue: 60, minValue: 1, maxValue: 1000 }),
+			new SDK.PluginProperty("integer", "achievement-batch-window", { initialValue: 0, minValue: 0, maxValue: 5000 }),
+			new SDK.PluginProperty("float", "tick-spike-threshold", { initialValue: 4, minValue: 0 }),
+			new SDK.PluginProperty("text", "eos-log-levels"),
+			new SDK.PluginProperty("check", "binary-trace-log"),
+			new SDK.PluginProperty("check", "message-recording"),
 		]);
 
 		this._info.SetWrapperExportProperties("scirra-epic-games", ["product-name", "product-version",
-			"product-id", "client-id", "client-secret", "sandbox-id", "deployment-id"]);
+			"product-id", "client-id", "client-secret", "sandbox-id", "deployment-id",
+			"native-tick", "native-tick-rate", "achievement-batch-window", "tick-spike-threshold",
+			"eos-log-levels", "binary-trace-log", "message-recording"]);
 		
 		SDK.Lang.PopContext();		// .properties
 		
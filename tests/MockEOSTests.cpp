@@ -0,0 +1,290 @@
+// Tests of the wrapper extension's behavior against the mock EOS SDK (see MockEOS.h). Each test creates a new
+// extension with a FakeApplication, sends it messages as the Construct plugin would, ticks it, and checks the
+// responses and the files it writes. The extension's files are written to a "MockEOSTestsAppData" folder in
+// the current directory, which is cleared before each test.
+// These are run by ctest from the CMake build in the repository root, e.g.:
+//		cmake -S . -B build && cmake --build build && ctest --test-dir build
+// Usage:
+//		MockEOSTests
+
+#include "pch.h"
+#include "WrapperExtension.h"
+#include "FakeApplication.h"
+#include "MockEOS.h"
+#include "MessageRecordFormat.h"
+#include "AsyncLogger.h"
+#include "json.hpp"
+
+#include <cstdio>
+#include <filesystem>
+#include <functional>
+#include <thread>
+
+extern WrapperExtension* g_Extension;
+
+static int g_FailureCount = 0;
+
+#define CHECK(condition) \
+	do { \
+		if (!(condition)) \
+		{ \
+			fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+			g_FailureCount++; \
+		} \
+	} while (0)
+
+// An extension initialized against the mock SDK with a fresh app data folder, for the duration of a test.
+class TestExtension {
+public:
+	// Extra exported properties can be passed to set, e.g. nlohmann::json{ { "message-recording", true } }.
+	explicit TestExtension(const nlohmann::json& properties = nlohmann::json::object())
+		: appDataFolder(std::filesystem::current_path() / "MockEOSTestsAppData"),
+		  app(ResetAppDataFolder(appDataFolder), GetPackageJson(properties)),
+		  ext(&app),
+		  isReleased(false)
+	{
+		MockEOSReset();
+
+		g_Extension = &ext;
+		ext.Init();
+		ext.OnWebMessage("init", 0, nullptr, 0.5);
+	}
+
+	~TestExtension()
+	{
+		Release();
+	}
+
+	// Release the extension before the end of the test, e.g. so it closes its files.
+	void Release()
+	{
+		if (isReleased)
+			return;
+
+		ext.Release();
+		g_Extension = nullptr;
+		isReleased = true;
+	}
+
+	void Send(const char* messageId, std::vector<ExtensionParameter> params, double asyncId)
+	{
+		std::vector<ExtensionParameterPOD> paramPods = PackExtensionParameters(params);
+		ext.OnWebMessage(messageId, paramPods.size(), paramPods.data(), asyncId);
+	}
+
+	// Tick until the condition is met, or fail after a few seconds.
+	bool TickUntil(const std::function<bool()>& condition)
+	{
+		auto endTime = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+		while (!condition())
+		{
+			if (std::chrono::steady_clock::now() >= endTime)
+				return false;
+
+			ext.OnWebMessage("platform-tick", 0, nullptr, -1.0);
+			CollectResponses();
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+
+		return true;
+	}
+
+	// Return the response for an asyncId, if one has been received.
+	const RecordedWebMessage* GetResponse(double asyncId)
+	{
+		CollectResponses();
+
+		for (const RecordedWebMessage& message : responses)
+		{
+			if (message.messageId.empty() && message.asyncId == asyncId)
+				return &message;
+		}
+
+		return nullptr;
+	}
+
+	std::string ReadAppDataFile(const char* name)
+	{
+		std::string content;
+		PlatformReadFile((appDataFolder / name).string(), content);
+		return content;
+	}
+
+	std::filesystem::path appDataFolder;
+	FakeApplication app;
+	WrapperExtension ext;
+	std::vector<RecordedWebMessage> responses;
+	bool isReleased;
+
+protected:
+	void CollectResponses()
+	{
+		for (RecordedWebMessage& message : app.TakeWebMessages())
+			responses.push_back(std::move(message));
+	}
+
+	static std::string ResetAppDataFolder(const std::filesystem::path& path)
+	{
+		std::error_code ec;
+		std::filesystem::remove_all(path, ec);
+		std::filesystem::create_directories(path, ec);
+		return path.string();
+	}
+
+	static std::string GetPackageJson(const nlohmann::json& properties)
+	{
+		nlohmann::json packageJson;
+		packageJson["project-details"] = { { "name", "Mock EOS tests" }, { "version", "1.0.0.0" } };
+		packageJson["exported-properties"]["scirra-epic-games"] = {
+			{ "product-name", "" },
+			{ "product-version", "" },
+			{ "product-id", "mock-product-id" },
+			{ "client-id", "mock-client-id" },
+			{ "client-secret", "mock-client-secret" },
+			{ "sandbox-id", "mock-sandbox-id" },
+			{ "deployment-id", "mock-deployment-id" },
+			{ "achievement-batch-window", 0 }
+		};
+		packageJson["exported-properties"]["scirra-epic-games"].update(properties);
+		return packageJson.dump();
+	}
+};
+
+// An unlock parked while connect login is in progress is saved to the journal if connect login then fails,
+// and reported as deferred, while a parked query fails.
+static void TestParkedUnlockJournaledOnConnectLoginFailure()
+{
+	TestExtension test;
+	MockEOSSetBehavior(MockEOSCall::ConnectLogin, { std::chrono::milliseconds(50), EOS_EResult::EOS_NoConnection });
+
+	test.Send("log-in-portal", { ExtensionParameter(true), ExtensionParameter(true), ExtensionParameter(true), ExtensionParameter(true) }, 1.0);
+	CHECK(test.TickUntil([&]() { return test.GetResponse(1.0) != nullptr; }));
+
+	// Connect login is now in progress, so these are parked.
+	test.Send("unlock-achievement", { ExtensionParameter(std::string("parked-achievement")) }, 2.0);
+	test.Send("is-achievement-unlocked", { ExtensionParameter(std::string("parked-achievement")) }, 3.0);
+	CHECK(test.GetResponse(2.0) == nullptr);
+
+	CHECK(test.TickUntil([&]() { return test.GetResponse(2.0) != nullptr && test.GetResponse(3.0) != nullptr; }));
+
+	const RecordedWebMessage* unlockResponse = test.GetResponse(2.0);
+	if (unlockResponse != nullptr)
+	{
+		auto params = unlockResponse->params;
+		CHECK(params["isOk"].number == 1.0);
+		CHECK(params["isDeferred"].number == 1.0);
+		CHECK(params.count("parkedWaitMs") == 1);
+	}
+
+	const RecordedWebMessage* queryResponse = test.GetResponse(3.0);
+	if (queryResponse != nullptr)
+	{
+		auto params = queryResponse->params;
+		CHECK(params["isOk"].number == 0.0);
+	}
+
+	CHECK(test.ReadAppDataFile("EOSAchievementJournal.txt").find(" parked-achievement ") != std::string::npos);
+	CHECK(MockEOSGetCallCount(MockEOSCall::AchievementsUnlock) == 0);
+}
+
+// Credentials passed with log in messages are not written to the message recording.
+static void TestMessageRecordingOmitsCredentials()
+{
+	const std::string exchangeCode = "secret-exchange-code-0123456789";
+
+	TestExtension test(nlohmann::json{ { "message-recording", true } });
+
+	test.Send("log-in-exchange-code", { ExtensionParameter(true), ExtensionParameter(true), ExtensionParameter(true), ExtensionParameter(true), ExtensionParameter(exchangeCode) }, 1.0);
+	CHECK(test.TickUntil([&]() { return test.GetResponse(1.0) != nullptr; }));
+
+	test.Release();
+
+	std::string recording = test.ReadAppDataFile("EOSExtMessages.bin");
+	CHECK(recording.find("log-in-exchange-code") != std::string::npos);
+	CHECK(recording.find(MESSAGE_RECORD_REDACTED) != std::string::npos);
+	CHECK(recording.find(exchangeCode) == std::string::npos);
+}
+
+// Acknowledging an unlock appends to the journal rather than rewriting it, even when nothing is left pending,
+// and the journal is compacted when the extension is released.
+static void TestJournalCompactedOnRelease()
+{
+	TestExtension test;
+
+	test.Send("log-in-portal", { ExtensionParameter(true), ExtensionParameter(true), ExtensionParameter(true), ExtensionParameter(true) }, 1.0);
+	CHECK(test.TickUntil([&]() { return test.GetResponse(1.0) != nullptr; }));
+
+	test.Send("unlock-achievement", { ExtensionParameter(std::string("compacted-achievement")) }, 2.0);
+	CHECK(test.TickUntil([&]() { return test.ReadAppDataFile("EOSAchievementJournal.txt").find("A ") != std::string::npos; }));
+
+	std::string journal = test.ReadAppDataFile("EOSAchievementJournal.txt");
+	CHECK(journal.find("U ") != std::string::npos);
+	CHECK(MockEOSGetCallCount(MockEOSCall::AchievementsUnlock) == 1);
+
+	test.Release();
+
+	CHECK(test.ReadAppDataFile("EOSAchievementJournal.txt").empty());
+}
+
+// Every message logged while the async logger stops is still emitted (or counted as dropped if the buffer
+// was full) by the time Stop() returns.
+static void TestAsyncLoggerStopEmitsEverything()
+{
+	const int ITERATIONS = 50;
+	const int THREAD_COUNT = 4;
+	const int MESSAGES_PER_THREAD = 200;
+
+	for (int iteration = 0; iteration < ITERATIONS; ++iteration)
+	{
+		FakeApplication app(std::filesystem::current_path().string(), "");
+		AsyncLogger logger;
+		logger.Start(&app);
+
+		std::atomic<int> startedCount(0);
+		std::vector<std::thread> threads;
+		for (int t = 0; t < THREAD_COUNT; ++t)
+		{
+			threads.emplace_back([&]()
+			{
+				startedCount++;
+				for (int i = 0; i < MESSAGES_PER_THREAD; ++i)
+					logger.LogExtensionMessage(IApplication::LogLevel::normal, "message");
+			});
+		}
+
+		// Stop while the threads are logging.
+		while (startedCount < THREAD_COUNT)
+			std::this_thread::yield();
+
+		logger.Stop();
+
+		for (std::thread& thread : threads)
+			thread.join();
+
+		size_t emittedCount = 0;
+		for (const std::string& message : app.GetConsoleMessages())
+		{
+			if (message == "[EpicExt] message")
+				emittedCount++;
+		}
+
+		CHECK(emittedCount + logger.GetDroppedCount() == THREAD_COUNT * MESSAGES_PER_THREAD);
+	}
+}
+
+int main()
+{
+	TestParkedUnlockJournaledOnConnectLoginFailure();
+	TestMessageRecordingOmitsCredentials();
+	TestJournalCompactedOnRelease();
+	TestAsyncLoggerStopEmitsEverything();
+
+	if (g_FailureCount > 0)
+	{
+		fprintf(stderr, "%d check(s) failed\n", g_FailureCount);
+		return 1;
+	}
+
+	printf("All tests passed\n");
+	return 0;
+}
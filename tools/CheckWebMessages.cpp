@@ -0,0 +1,108 @@
+// Checks the WrapperMessageParams type in the Construct plugin's instance.ts matches the wrapper extension's
+// message table in WebMessages.h, i.e. both list the same messages with the same parameter types in the same
+// order. The CMake build in the repository root and the Visual Studio project both run this after building it, so
+// the build fails if they differ.
+// Usage:
+//		CheckWebMessages <path to instance.ts>
+
+#include "pch.h"
+#include "WebMessages.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <regex>
+
+static const char* GetTypeScriptType(ExtensionParameterType type)
+{
+	switch (type) {
+	case EPT_Boolean:
+		return "boolean";
+	case EPT_Number:
+		return "number";
+	case EPT_String:
+		return "string";
+	default:
+		return "?";
+	}
+}
+
+// The parameter types of a message as they would be written in WrapperMessageParams, e.g. "boolean, string".
+static std::string GetTypeScriptParams(const WebMessageDesc& desc)
+{
+	std::string ret;
+	for (size_t i = 0; i < desc.paramCount; ++i)
+	{
+		if (i > 0)
+			ret += ", ";
+
+		ret += GetTypeScriptType(desc.paramTypes[i]);
+	}
+
+	return ret;
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc != 2)
+	{
+		fprintf(stderr, "Usage: CheckWebMessages <path to instance.ts>\n");
+		return 1;
+	}
+
+	std::ifstream file(argv[1]);
+	if (!file)
+	{
+		fprintf(stderr, "Failed to open '%s'\n", argv[1]);
+		return 1;
+	}
+
+	std::string source((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+	// Find the body of the WrapperMessageParams type, and remove comments from it.
+	size_t start = source.find("type WrapperMessageParams = {");
+	size_t end = start == std::string::npos ? std::string::npos : source.find("};", start);
+	if (end == std::string::npos)
+	{
+		fprintf(stderr, "%s: WrapperMessageParams type not found\n", argv[1]);
+		return 1;
+	}
+
+	std::string body = std::regex_replace(source.substr(start, end - start), std::regex("//[^\n]*"), "");
+
+	// Read each "message-name": [types] entry, normalizing the whitespace in the types.
+	std::vector<std::pair<std::string, std::string>> tsMessages;
+	std::regex entryRegex("\"([^\"]+)\"\\s*:\\s*\\[([^\\]]*)\\]");
+	for (std::sregex_iterator i(body.begin(), body.end(), entryRegex), iEnd; i != iEnd; ++i)
+	{
+		std::string types = std::regex_replace((*i)[2].str(), std::regex("\\s*,\\s*"), ", ");
+		types = std::regex_replace(types, std::regex("^\\s+|\\s+$"), "");
+		tsMessages.emplace_back((*i)[1].str(), types);
+	}
+
+	int errorCount = 0;
+
+	for (size_t i = 0; i < std::max(WEB_MESSAGE_COUNT, tsMessages.size()); ++i)
+	{
+		std::string cppName = i < WEB_MESSAGE_COUNT ? WEB_MESSAGES[i].name : "(none)";
+		std::string cppParams = i < WEB_MESSAGE_COUNT ? GetTypeScriptParams(WEB_MESSAGES[i]) : "";
+		std::string tsName = i < tsMessages.size() ? tsMessages[i].first : "(none)";
+		std::string tsParams = i < tsMessages.size() ? tsMessages[i].second : "";
+
+		if (cppName != tsName || cppParams != tsParams)
+		{
+			fprintf(stderr, "Message %zu differs: WebMessages.h has \"%s\": [%s] but instance.ts has \"%s\": [%s]\n",
+				i, cppName.c_str(), cppParams.c_str(), tsName.c_str(), tsParams.c_str());
+			errorCount++;
+		}
+	}
+
+	if (errorCount > 0)
+	{
+		fprintf(stderr, "WrapperMessageParams in instance.ts must list the same messages in the same order as WEB_MESSAGES in WebMessages.h\n");
+		return 1;
+	}
+
+	printf("WrapperMessageParams matches WEB_MESSAGES (%zu messages)\n", WEB_MESSAGE_COUNT);
+	return 0;
+}
@@ -0,0 +1,213 @@
+// Converts a binary trace log written by the wrapper extension (EOSExtTrace.bin or EOSExtTrace.bin.prev in the
+// app data folder, with the "Binary trace log" property enabled) back in to text, one line per record.
+// This is a standalone tool that does not depend on Windows or the EOS SDK. Build it with e.g.:
+//		cl /std:c++17 /EHsc /I..\wrapper-extension DecodeTraceLog.cpp
+//		g++ -std=c++17 -I../wrapper-extension DecodeTraceLog.cpp -o DecodeTraceLog
+// or with the CMake build in the repository root, which also builds it.
+// Usage:
+//		DecodeTraceLog <trace file>
+
+#include <stdint.h>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "TraceLogFormat.h"
+
+static const char* GetCategoryName(TraceCategory category)
+{
+	switch (category) {
+	case TraceCategory::Extension:
+		return "EpicExt";
+	case TraceCategory::EOSLog:
+		return "EOS";
+	case TraceCategory::WebMessage:
+		return "message";
+	case TraceCategory::EOSCallback:
+		return "callback";
+	case TraceCategory::Response:
+		return "response";
+	default:
+		return "unknown";
+	}
+}
+
+static const char* GetExtLogLevelName(uint8_t level)
+{
+	static const char* names[] = { "debug", "info", "warning", "error" };
+	return level < 4 ? names[level] : "?";
+}
+
+static const char* GetEOSLogLevelName(uint8_t level)
+{
+	static const char* names[] = { "off", "fatal", "error", "warning", "info", "verbose", "veryverbose" };
+	return level < 7 ? names[level] : "?";
+}
+
+static std::string FormatArg(const TraceRecord& record, uint32_t index)
+{
+	char buf[64];
+
+	if (record.argDoubleMask & (1 << index))
+	{
+		double value;
+		memcpy(&value, &record.args[index], sizeof(value));
+		snprintf(buf, sizeof(buf), "%.17g", value);
+	}
+	else
+	{
+		int64_t value;
+		memcpy(&value, &record.args[index], sizeof(value));
+		snprintf(buf, sizeof(buf), "%lld", static_cast<long long>(value));
+	}
+
+	return buf;
+}
+
+static std::string FormatTime(int64_t startTimeUnixMs, uint64_t timestampUs)
+{
+	int64_t timeMs = startTimeUnixMs + static_cast<int64_t>(timestampUs / 1000);
+	time_t seconds = static_cast<time_t>(timeMs / 1000);
+
+	char buf[64];
+	size_t length = strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", gmtime(&seconds));
+	snprintf(buf + length, sizeof(buf) - length, ".%03d", static_cast<int>(timeMs % 1000));
+	return buf;
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc != 2)
+	{
+		fprintf(stderr, "Usage: DecodeTraceLog <trace file>\n");
+		return 1;
+	}
+
+	std::ifstream file(argv[1], std::ios::binary);
+	if (!file)
+	{
+		fprintf(stderr, "Failed to open '%s'\n", argv[1]);
+		return 1;
+	}
+
+	std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+	TraceFileHeader header;
+	if (data.size() < sizeof(header))
+	{
+		fprintf(stderr, "File is too small to be a trace log\n");
+		return 1;
+	}
+
+	memcpy(&header, data.data(), sizeof(header));
+
+	if (memcmp(header.magic, TRACE_FILE_MAGIC, sizeof(header.magic)) != 0 || header.version != TRACE_FILE_VERSION ||
+		header.recordSize != sizeof(TraceRecord))
+	{
+		fprintf(stderr, "Not a trace log, or an unsupported version\n");
+		return 1;
+	}
+
+	if (static_cast<uint64_t>(header.stringTableOffset) + header.stringTableSize > data.size() ||
+		static_cast<uint64_t>(header.recordsOffset) + static_cast<uint64_t>(header.recordCapacity) * header.recordSize > data.size())
+	{
+		fprintf(stderr, "Trace log is truncated\n");
+		return 1;
+	}
+
+	// Read the string table.
+	std::vector<std::string> strings;
+	size_t pos = header.stringTableOffset;
+	const size_t stringTableEnd = header.stringTableOffset + header.stringTableSize;
+
+	for (uint32_t i = 0; i < header.stringCount; ++i)
+	{
+		uint16_t length;
+		if (pos + sizeof(length) > stringTableEnd)
+			break;
+
+		memcpy(&length, &data[pos], sizeof(length));
+		pos += sizeof(length);
+
+		if (pos + length > stringTableEnd)
+			break;
+
+		strings.emplace_back(&data[pos], length);
+		pos += length;
+	}
+
+	// Collect the records that were written, in the order they were written.
+	std::vector<TraceRecord> records;
+	for (uint32_t i = 0; i < header.recordCapacity; ++i)
+	{
+		TraceRecord record;
+		memcpy(&record, &data[header.recordsOffset + static_cast<size_t>(i) * sizeof(TraceRecord)], sizeof(record));
+
+		if (record.sequence != 0)
+			records.push_back(record);
+	}
+
+	std::sort(records.begin(), records.end(), [](const TraceRecord& a, const TraceRecord& b)
+	{
+		return a.sequence < b.sequence;
+	});
+
+	printf("Trace log with %zu record(s) and %zu string(s)\n", records.size(), strings.size());
+
+	if (!records.empty() && records.front().sequence > 1)
+		printf("(%llu earlier record(s) were overwritten)\n", static_cast<unsigned long long>(records.front().sequence - 1));
+
+	for (const TraceRecord& record : records)
+	{
+		const char* message = record.messageId < strings.size() ? strings[record.messageId].c_str() : "<unknown string>";
+		std::string text(record.text, std::min<size_t>(record.textLength, TRACE_MAX_TEXT_LENGTH));
+
+		printf("%s [%u] ", FormatTime(header.startTimeUnixMs, record.timestampUs).c_str(), record.threadId);
+
+		switch (record.category) {
+		case TraceCategory::Extension:
+		{
+			// Messages are usually the start of a sentence with arguments to follow, so drop trailing spaces.
+			std::string messageStr = message;
+			messageStr.erase(messageStr.find_last_not_of(' ') + 1);
+
+			printf("[EpicExt/%s]", GetExtLogLevelName(record.level));
+			if (!messageStr.empty())
+				printf(" %s", messageStr.c_str());
+			if (!text.empty())
+				printf(" %s", text.c_str());
+			break;
+		}
+		case TraceCategory::EOSLog:
+			printf("[EOS][%s/%s] %s", message, GetEOSLogLevelName(record.level), text.c_str());
+			break;
+		case TraceCategory::EOSCallback:
+			printf("callback %s asyncId=%s result=%s", message, FormatArg(record, 0).c_str(), FormatArg(record, 1).c_str());
+			break;
+		default:
+			printf("%s %s asyncId=%s", GetCategoryName(record.category), message, FormatArg(record, 0).c_str());
+			break;
+		}
+
+		// List any arguments of log messages, which were not formatted in to the text.
+		if (record.category == TraceCategory::Extension && record.argCount > 0)
+		{
+			printf(" [");
+			for (uint32_t i = 0; i < record.argCount && i < TRACE_MAX_ARGS; ++i)
+				printf(i == 0 ? "%s" : ", %s", FormatArg(record, i).c_str());
+			printf("]");
+		}
+
+		if (record.textLength >= TRACE_MAX_TEXT_LENGTH)
+			printf("...");
+
+		printf("\n");
+	}
+
+	return 0;
+}
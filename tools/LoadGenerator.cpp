@@ -0,0 +1,465 @@
+// Stress tests the wrapper extension with many concurrent async messages against the mock EOS SDK, to check
+// every message gets exactly one response under load, and to measure throughput and tail latency.
+// This acts like the Construct plugin: it keeps up to the given number of async messages in flight, each with a
+// random asyncId, and sends "platform-tick" messages in between (unless using native tick). The workload is a
+// mix of achievement unlocks and queries, with a log out and log back in every so often, as in QA builds that
+// spam achievements and repeatedly log in and out. Every EOS call completes after a random latency, so callbacks
+// complete in a different order to the one the calls were made in.
+// Responses are matched to messages by asyncId. Any asyncId with no response, more than one response, or a
+// response to a message never sent, is reported, as is any work the extension still has pending at the end
+// (from a final "get-tick-status" message). The exit code is 1 if any of these are found.
+// The extension's own files, such as the achievement journal, are written to a "LoadGeneratorAppData" folder in
+// the current directory, which is cleared first.
+// This builds the extension's sources with the mock SDK, so it needs the EOS SDK headers but not the library.
+// Build it with the CMake build in the repository root, e.g.:
+//		cmake -S . -B build && cmake --build build --target LoadGenerator
+// Usage:
+//		LoadGenerator [--requests <count>] [--concurrency <count>] [--min-latency <ms>] [--max-latency <ms>]
+//					  [--log-out-every <count>] [--batch-window <ms>] [--native-tick] [--seed <number>]
+
+#include "pch.h"
+#include "WrapperExtension.h"
+#include "FakeApplication.h"
+#include "MockEOS.h"
+#include "json.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <random>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+extern WrapperExtension* g_Extension;
+
+struct LoadGeneratorOptions {
+	uint64_t requestCount = 10000;
+	size_t concurrency = 1000;
+	int64_t minLatencyMs = 0;
+	int64_t maxLatencyMs = 50;
+	uint64_t logOutEvery = 500;				// 0 to never log out
+	int64_t batchWindowMs = 0;				// the "achievement-batch-window" property
+	bool useNativeTick = false;
+	uint32_t seed = 1;
+};
+
+struct PendingRequest {
+	const char* messageId;
+	std::chrono::steady_clock::time_point sendTime;
+};
+
+static const int ACHIEVEMENT_COUNT = 20;
+
+// If nothing completes for this long, the remaining requests are assumed to never get a response.
+static const std::chrono::seconds STALL_TIMEOUT(10);
+
+// How long to keep ticking with no EOS calls pending after the last response, to let work the extension does
+// after responding (such as obtaining a product user ID) finish, and to catch any duplicate responses.
+static const std::chrono::milliseconds SETTLE_TIME(250);
+
+static bool ReadOptions(int argc, char* argv[], LoadGeneratorOptions& options)
+{
+	for (int i = 1; i < argc; ++i)
+	{
+		const char* arg = argv[i];
+		const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+		if (strcmp(arg, "--native-tick") == 0)
+		{
+			options.useNativeTick = true;
+			continue;
+		}
+
+		if (value == nullptr)
+			return false;
+
+		if (strcmp(arg, "--requests") == 0)
+			options.requestCount = strtoull(value, nullptr, 10);
+		else if (strcmp(arg, "--concurrency") == 0)
+			options.concurrency = static_cast<size_t>(strtoull(value, nullptr, 10));
+		else if (strcmp(arg, "--min-latency") == 0)
+			options.minLatencyMs = strtoll(value, nullptr, 10);
+		else if (strcmp(arg, "--max-latency") == 0)
+			options.maxLatencyMs = strtoll(value, nullptr, 10);
+		else if (strcmp(arg, "--log-out-every") == 0)
+			options.logOutEvery = strtoull(value, nullptr, 10);
+		else if (strcmp(arg, "--batch-window") == 0)
+			options.batchWindowMs = strtoll(value, nullptr, 10);
+		else if (strcmp(arg, "--seed") == 0)
+			options.seed = static_cast<uint32_t>(strtoul(value, nullptr, 10));
+		else
+			return false;
+
+		++i;
+	}
+
+	return options.concurrency > 0 && options.minLatencyMs >= 0 && options.maxLatencyMs >= options.minLatencyMs && options.batchWindowMs >= 0;
+}
+
+// The package JSON for the fake host, with placeholder IDs and the settings under test.
+static std::string GetPackageJson(const LoadGeneratorOptions& options)
+{
+	nlohmann::json packageJson;
+	packageJson["project-details"] = { { "name", "Load generator" }, { "version", "1.0.0.0" } };
+	packageJson["exported-properties"]["scirra-epic-games"] = {
+		{ "product-name", "" },
+		{ "product-version", "" },
+		{ "product-id", "mock-product-id" },
+		{ "client-id", "mock-client-id" },
+		{ "client-secret", "mock-client-secret" },
+		{ "sandbox-id", "mock-sandbox-id" },
+		{ "deployment-id", "mock-deployment-id" },
+		{ "native-tick", options.useNativeTick },
+		{ "achievement-batch-window", options.batchWindowMs }
+	};
+	return packageJson.dump();
+}
+
+static void PrintLatencyRow(const char* name, const LatencyHistogram& histogram)
+{
+	printf("%-28s %10llu %10.3f %10.3f %10.3f %10.3f %10.3f\n", name, static_cast<unsigned long long>(histogram.GetCount()),
+		histogram.GetMeanMs(), histogram.GetPercentileMs(0.5), histogram.GetPercentileMs(0.99), histogram.GetPercentileMs(0.999), histogram.GetMaxMs());
+}
+
+class LoadGenerator {
+public:
+	LoadGenerator(const LoadGeneratorOptions& options_, WrapperExtension& ext_, FakeApplication& app_)
+		: options(options_),
+		  ext(ext_),
+		  app(app_),
+		  random(options_.seed),
+		  sentCount(0),
+		  loadTime(0),
+		  duplicateCount(0),
+		  unexpectedCount(0)
+	{}
+
+	void Run();
+	bool Report();
+
+private:
+	double NewAsyncId();
+	void Send(const char* messageId, std::vector<ExtensionParameter> params);
+	void SendNext();
+	void Tick();
+	bool ReadResponses();
+	void Settle();
+
+	std::string RandomAchievementId();
+
+	const LoadGeneratorOptions& options;
+	WrapperExtension& ext;
+	FakeApplication& app;
+	std::mt19937_64 random;
+
+	uint64_t sentCount;
+	std::chrono::steady_clock::duration loadTime;
+	std::unordered_map<double, PendingRequest> pending;
+	std::unordered_set<double> usedAsyncIds;
+	std::unordered_set<double> respondedAsyncIds;
+	uint64_t duplicateCount;
+	uint64_t unexpectedCount;
+
+	std::map<std::string, LatencyHistogram> messageLatencies;
+	LatencyHistogram allLatencies;
+
+	nlohmann::json finalTickStatus;
+};
+
+// Random asyncIds which are never reused and never -1, as JavaScript uses -1 for messages without a response.
+// They are kept within the integer range a double can represent exactly, like the plugin's own IDs.
+double LoadGenerator::NewAsyncId()
+{
+	std::uniform_int_distribution<uint64_t> dist(0, (1ull << 53) - 1);
+
+	double asyncId;
+	do {
+		asyncId = static_cast<double>(dist(random));
+	}
+	while (!usedAsyncIds.insert(asyncId).second);
+
+	return asyncId;
+}
+
+void LoadGenerator::Send(const char* messageId, std::vector<ExtensionParameter> params)
+{
+	double asyncId = NewAsyncId();
+	pending[asyncId] = { messageId, std::chrono::steady_clock::now() };
+	sentCount++;
+
+	std::vector<ExtensionParameterPOD> paramPods = PackExtensionParameters(params);
+	ext.OnWebMessage(messageId, paramPods.size(), paramPods.data(), asyncId);
+}
+
+std::string LoadGenerator::RandomAchievementId()
+{
+	std::uniform_int_distribution<int> dist(0, ACHIEVEMENT_COUNT - 1);
+	return "achievement-" + std::to_string(dist(random));
+}
+
+void LoadGenerator::SendNext()
+{
+	// Start up like the Construct plugin, then log out and back in periodically.
+	if (sentCount == 0)
+	{
+		Send("init", {});
+		return;
+	}
+
+	if (sentCount == 1 || (options.logOutEvery > 0 && sentCount % options.logOutEvery == 0))
+	{
+		if (sentCount > 1)
+			Send("log-out", {});
+
+		Send("log-in-portal", { ExtensionParameter(true), ExtensionParameter(true), ExtensionParameter(true), ExtensionParameter(true) });
+		return;
+	}
+
+	std::uniform_int_distribution<int> dist(0, 99);
+	int choice = dist(random);
+
+	if (choice < 40)
+		Send("unlock-achievement", { ExtensionParameter(RandomAchievementId()) });
+	else if (choice < 50)
+	{
+		nlohmann::json achievementIds = { RandomAchievementId(), RandomAchievementId(), RandomAchievementId() };
+		Send("unlock-achievements", { ExtensionParameter(achievementIds.dump()) });
+	}
+	else if (choice < 70)
+		Send("is-achievement-unlocked", { ExtensionParameter(RandomAchievementId()) });
+	else if (choice < 90)
+		Send("get-achievement-progress", { ExtensionParameter(RandomAchievementId()) });
+	else if (choice < 95)
+		Send("get-tick-status", {});
+	else
+		Send("get-metrics", { ExtensionParameter(false) });
+}
+
+void LoadGenerator::Tick()
+{
+	// In native tick mode the extension ignores these, as it ticks itself.
+	ext.OnWebMessage("platform-tick", 0, nullptr, -1.0);
+	std::this_thread::sleep_for(std::chrono::milliseconds(1));
+}
+
+// Match up any responses received. Returns true if any pending message was responded to.
+bool LoadGenerator::ReadResponses()
+{
+	bool isProgress = false;
+	auto now = std::chrono::steady_clock::now();
+
+	for (const RecordedWebMessage& message : app.TakeWebMessages())
+	{
+		// Ignore messages the extension sends of its own accord, such as login status changes.
+		if (!message.messageId.empty())
+			continue;
+
+		auto it = pending.find(message.asyncId);
+		if (it == pending.end())
+		{
+			if (respondedAsyncIds.count(message.asyncId) > 0)
+				duplicateCount++;
+			else
+				unexpectedCount++;
+
+			continue;
+		}
+
+		auto latency = now - it->second.sendTime;
+		messageLatencies[it->second.messageId].Record(latency);
+		allLatencies.Record(latency);
+
+		// Keep the last tick status for the report, which is the final one sent in Run().
+		if (strcmp(it->second.messageId, "get-tick-status") == 0)
+		{
+			finalTickStatus = nlohmann::json::object();
+			for (const auto& [key, value] : message.params)
+				finalTickStatus[key] = value.type == EPT_String ? nlohmann::json(value.str) : nlohmann::json(value.number);
+		}
+
+		respondedAsyncIds.insert(message.asyncId);
+		pending.erase(it);
+		isProgress = true;
+	}
+
+	return isProgress;
+}
+
+void LoadGenerator::Run()
+{
+	auto startTime = std::chrono::steady_clock::now();
+	auto lastProgressTime = startTime;
+
+	while (sentCount < options.requestCount || !pending.empty())
+	{
+		while (sentCount < options.requestCount && pending.size() < options.concurrency)
+			SendNext();
+
+		Tick();
+
+		auto now = std::chrono::steady_clock::now();
+		if (ReadResponses())
+			lastProgressTime = now;
+		else if (now - lastProgressTime >= STALL_TIMEOUT)
+			break;
+	}
+
+	loadTime = std::chrono::steady_clock::now() - startTime;
+
+	Settle();
+
+	// Check the extension's own view of the work once everything has been responded to.
+	finalTickStatus = nullptr;
+	Send("get-tick-status", {});
+
+	auto endTime = std::chrono::steady_clock::now() + STALL_TIMEOUT;
+	while (finalTickStatus.is_null() && std::chrono::steady_clock::now() < endTime)
+	{
+		Tick();
+		ReadResponses();
+	}
+}
+
+// Keep ticking until no EOS calls have been pending for SETTLE_TIME.
+void LoadGenerator::Settle()
+{
+	auto endTime = std::chrono::steady_clock::now() + STALL_TIMEOUT;
+	auto idleStartTime = std::chrono::steady_clock::now();
+
+	while (std::chrono::steady_clock::now() < endTime)
+	{
+		Tick();
+		ReadResponses();
+
+		auto now = std::chrono::steady_clock::now();
+		if (MockEOSGetPendingCallbackCount() > 0)
+			idleStartTime = now;
+		else if (now - idleStartTime >= SETTLE_TIME)
+			break;
+	}
+}
+
+// Print the results, returning false if any problems were found.
+bool LoadGenerator::Report()
+{
+	double elapsedSeconds = std::chrono::duration<double>(loadTime).count();
+
+	printf("Sent %llu async message(s) in %.2f s, %.0f responses per second\n", static_cast<unsigned long long>(sentCount),
+		elapsedSeconds, respondedAsyncIds.size() / elapsedSeconds);
+
+	printf("\n%-28s %10s %10s %10s %10s %10s %10s\n", "message", "count", "mean ms", "p50 ms", "p99 ms", "p99.9 ms", "max ms");
+	for (const auto& [messageId, histogram] : messageLatencies)
+		PrintLatencyRow(messageId.c_str(), histogram);
+
+	PrintLatencyRow("(all)", allLatencies);
+
+	bool isOk = true;
+	printf("\n");
+
+	if (!pending.empty())
+	{
+		printf("%zu message(s) never got a response, e.g.:\n", pending.size());
+
+		size_t shown = 0;
+		for (const auto& [asyncId, request] : pending)
+		{
+			if (shown++ == 10)
+				break;
+
+			printf("\t%s asyncId=%.17g\n", request.messageId, asyncId);
+		}
+
+		isOk = false;
+	}
+
+	if (duplicateCount > 0)
+	{
+		printf("%llu duplicate response(s)\n", static_cast<unsigned long long>(duplicateCount));
+		isOk = false;
+	}
+
+	if (unexpectedCount > 0)
+	{
+		printf("%llu response(s) to messages that were never sent\n", static_cast<unsigned long long>(unexpectedCount));
+		isOk = false;
+	}
+
+	// Apart from the final "get-tick-status" message itself, nothing should still be pending in the extension.
+	if (finalTickStatus.is_object())
+	{
+		for (const char* key : { "pendingOperationCount", "parkedMessageCount", "callbackSlotsInUse" })
+		{
+			double value = finalTickStatus.value(key, 0.0);
+			if (value != 0.0)
+			{
+				printf("Extension still has %s = %g\n", key, value);
+				isOk = false;
+			}
+		}
+	}
+	else
+	{
+		printf("No final tick status received\n");
+		isOk = false;
+	}
+
+	if (isOk)
+		printf("Every message got exactly one response\n");
+
+	return isOk;
+}
+
+int main(int argc, char* argv[])
+{
+	LoadGeneratorOptions options;
+	if (!ReadOptions(argc, argv, options))
+	{
+		fprintf(stderr, "Usage: LoadGenerator [--requests <count>] [--concurrency <count>] [--min-latency <ms>] [--max-latency <ms>]\n");
+		fprintf(stderr, "                     [--log-out-every <count>] [--batch-window <ms>] [--native-tick] [--seed <number>]\n");
+		return 1;
+	}
+
+	// Every async EOS call completes after a random latency in the given range.
+	MockEOSSeedRandom(options.seed);
+
+	MockEOSBehavior behavior = { std::chrono::milliseconds(options.minLatencyMs), EOS_EResult::EOS_Success,
+		std::chrono::milliseconds(options.maxLatencyMs - options.minLatencyMs) };
+
+	for (MockEOSCall call : { MockEOSCall::AuthLogin, MockEOSCall::AuthLogout, MockEOSCall::AuthDeletePersistentAuth,
+		MockEOSCall::ConnectLogin, MockEOSCall::ConnectCreateUser, MockEOSCall::AchievementsUnlock,
+		MockEOSCall::AchievementsQueryDefinitions, MockEOSCall::AchievementsQueryPlayer })
+	{
+		MockEOSSetBehavior(call, behavior);
+	}
+
+	std::vector<std::string> achievementIds;
+	for (int i = 0; i < ACHIEVEMENT_COUNT; ++i)
+		achievementIds.push_back("achievement-" + std::to_string(i));
+
+	MockEOSSetAchievementDefinitions(achievementIds);
+
+	std::filesystem::path appDataFolder = std::filesystem::current_path() / "LoadGeneratorAppData";
+	std::error_code ec;
+	std::filesystem::remove_all(appDataFolder, ec);
+	std::filesystem::create_directories(appDataFolder, ec);
+
+	FakeApplication app(appDataFolder.string(), GetPackageJson(options));
+	bool isOk;
+
+	{
+		WrapperExtension ext(&app);
+		g_Extension = &ext;
+		ext.Init();
+
+		LoadGenerator generator(options, ext, app);
+		generator.Run();
+
+		ext.Release();
+		g_Extension = nullptr;
+
+		isOk = generator.Report();
+	}
+
+	return isOk ? 0 : 1;
+}
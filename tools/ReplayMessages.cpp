@@ -0,0 +1,421 @@
+// Replays a recording of web messages written by the wrapper extension (EOSExtMessages.bin or
+// EOSExtMessages.bin.prev in the app data folder, with the "Record messages" property enabled) against the mock
+// EOS SDK, and reports how long the extension took to process each kind of message. This is for reproducing
+// problems such as hitches without the original game or Epic's backend.
+// The mock SDK is scripted from the recorded EOS callbacks, so each call completes with the recorded result
+// after the recorded latency (scaled by the replay speed). Calls of the same kind are given the recorded
+// results in the order their callbacks happened, which is also the order they were made unless they overlapped.
+// Messages are replayed at their original times scaled by the speed, or as fast as possible with a speed of 0.
+// In native tick mode, the time recorded for a message is only the time to hand it to the tick thread.
+// Credentials such as exchange codes are not recorded. The mock SDK accepts any credentials, so they are
+// replayed with a placeholder value instead.
+// The extension's own files, such as the achievement journal, are written to a "ReplayAppData" folder in the
+// current directory, which is cleared first so replays are repeatable.
+// This builds the extension's sources with the mock SDK, so it needs the EOS SDK headers but not the library.
+// Build it with the CMake build in the repository root, e.g.:
+//		cmake -S . -B build && cmake --build build --target ReplayMessages
+// Usage:
+//		ReplayMessages <recording file> [--speed <factor>]
+
+#include "pch.h"
+#include "WrapperExtension.h"
+#include "FakeApplication.h"
+#include "MockEOS.h"
+#include "MessageRecordFormat.h"
+#include "json.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <thread>
+
+extern WrapperExtension* g_Extension;
+
+struct RecordedMessage {
+	uint64_t timeUs;				// since the start of the recording
+	std::string messageId;
+	double asyncId;
+	std::vector<ExtensionParameter> params;
+};
+
+struct RecordedCallback {
+	std::string operationName;
+	EOS_EResult result;
+	uint64_t latencyUs;
+};
+
+struct Recording {
+	std::string settingsJson;
+	std::vector<RecordedMessage> messages;
+	std::vector<RecordedCallback> callbacks;
+	bool isTruncated = false;
+};
+
+// Reads the values in a record, noting if the data runs out, which happens if the process ended mid-record.
+class RecordReader {
+public:
+	RecordReader(const std::vector<char>& data_, size_t pos_)
+		: data(data_),
+		  pos(pos_),
+		  isOk(true)
+	{}
+
+	bool IsAtEnd() const { return pos >= data.size(); }
+	bool IsOk() const { return isOk; }
+
+	uint8_t ReadByte()
+	{
+		if (pos >= data.size())
+		{
+			isOk = false;
+			return 0;
+		}
+
+		return static_cast<uint8_t>(data[pos++]);
+	}
+
+	uint64_t ReadVarint()
+	{
+		uint64_t value = 0;
+		for (int shift = 0; shift < 64 && isOk; shift += 7)
+		{
+			uint8_t b = ReadByte();
+			value |= static_cast<uint64_t>(b & 0x7F) << shift;
+			if ((b & 0x80) == 0)
+				break;
+		}
+
+		return value;
+	}
+
+	double ReadDouble()
+	{
+		double value = 0.0;
+		if (pos + sizeof(value) > data.size())
+		{
+			isOk = false;
+			return value;
+		}
+
+		memcpy(&value, &data[pos], sizeof(value));
+		pos += sizeof(value);
+		return value;
+	}
+
+	std::string ReadString()
+	{
+		uint64_t length = ReadVarint();
+		if (!isOk || length > data.size() - pos)
+		{
+			isOk = false;
+			return std::string();
+		}
+
+		std::string ret(&data[pos], static_cast<size_t>(length));
+		pos += static_cast<size_t>(length);
+		return ret;
+	}
+
+private:
+	const std::vector<char>& data;
+	size_t pos;
+	bool isOk;
+};
+
+static bool ReadRecording(const char* path, Recording& recording)
+{
+	std::ifstream file(path, std::ios::binary);
+	if (!file)
+	{
+		fprintf(stderr, "Failed to open '%s'\n", path);
+		return false;
+	}
+
+	std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+	MessageRecordFileHeader header;
+	if (data.size() < sizeof(header))
+	{
+		fprintf(stderr, "File is too small to be a message recording\n");
+		return false;
+	}
+
+	memcpy(&header, data.data(), sizeof(header));
+
+	if (memcmp(header.magic, MESSAGE_RECORD_MAGIC, sizeof(header.magic)) != 0 || header.version != MESSAGE_RECORD_VERSION)
+	{
+		fprintf(stderr, "Not a message recording, or an unsupported version\n");
+		return false;
+	}
+
+	RecordReader reader(data, sizeof(header));
+	std::vector<std::string> strings;
+	uint64_t timeUs = 0;
+
+	while (!reader.IsAtEnd())
+	{
+		MessageRecordType type = static_cast<MessageRecordType>(reader.ReadByte());
+		timeUs += reader.ReadVarint();
+
+		switch (type) {
+		case MessageRecordType::String:
+			strings.push_back(reader.ReadString());
+			break;
+		case MessageRecordType::Settings:
+			recording.settingsJson = reader.ReadString();
+			break;
+		case MessageRecordType::WebMessage:
+		{
+			RecordedMessage message;
+			message.timeUs = timeUs;
+
+			uint64_t nameId = reader.ReadVarint();
+			message.messageId = nameId < strings.size() ? strings[nameId] : "";
+			message.asyncId = reader.ReadDouble();
+
+			uint8_t paramCount = reader.ReadByte();
+			for (uint8_t i = 0; i < paramCount && reader.IsOk(); ++i)
+			{
+				ExtensionParameter param;
+				param.type = static_cast<ExtensionParameterType>(reader.ReadByte());
+
+				if (param.type == EPT_String)
+				{
+					param.str = reader.ReadString();
+
+					if (param.str == MESSAGE_RECORD_REDACTED)
+						param.str = "mock-credential";
+				}
+				else
+					param.number = reader.ReadDouble();
+
+				message.params.push_back(std::move(param));
+			}
+
+			if (reader.IsOk())
+				recording.messages.push_back(std::move(message));
+			break;
+		}
+		case MessageRecordType::EOSCallback:
+		{
+			RecordedCallback callback;
+
+			uint64_t nameId = reader.ReadVarint();
+			callback.operationName = nameId < strings.size() ? strings[nameId] : "";
+			reader.ReadDouble();		// asyncId, not needed to script the mock
+			callback.result = static_cast<EOS_EResult>(reader.ReadVarint());
+			callback.latencyUs = reader.ReadVarint();
+
+			if (reader.IsOk())
+				recording.callbacks.push_back(std::move(callback));
+			break;
+		}
+		default:
+			// Without knowing the record's size, nothing after it can be read.
+			fprintf(stderr, "Unknown record type %d, ignoring the rest of the file\n", static_cast<int>(type));
+			recording.isTruncated = true;
+			return true;
+		}
+
+		if (!reader.IsOk())
+		{
+			recording.isTruncated = true;
+			break;
+		}
+	}
+
+	return true;
+}
+
+// Map the extension's names for its async operations (see NewCallbackInfo()) to the mock SDK's calls.
+static bool GetMockEOSCall(const std::string& operationName, MockEOSCall& call)
+{
+	static const std::map<std::string, MockEOSCall> calls = {
+		{ "auth-login",						MockEOSCall::AuthLogin },
+		{ "auth-logout",					MockEOSCall::AuthLogout },
+		{ "auth-delete-persistent",			MockEOSCall::AuthDeletePersistentAuth },
+		{ "connect-login",					MockEOSCall::ConnectLogin },
+		{ "connect-create-user",			MockEOSCall::ConnectCreateUser },
+		{ "achievements-unlock",			MockEOSCall::AchievementsUnlock },
+		{ "achievements-query-definitions",	MockEOSCall::AchievementsQueryDefinitions },
+		{ "achievements-query-player",		MockEOSCall::AchievementsQueryPlayer }
+	};
+
+	auto i = calls.find(operationName);
+	if (i == calls.end())
+		return false;
+
+	call = i->second;
+	return true;
+}
+
+static void ScriptMockEOS(const Recording& recording, double speed)
+{
+	bool isFirstConnectLogin = true;
+
+	for (const RecordedCallback& callback : recording.callbacks)
+	{
+		MockEOSCall call;
+		if (!GetMockEOSCall(callback.operationName, call))
+			continue;
+
+		std::chrono::milliseconds latency(0);
+		if (speed > 0.0)
+			latency = std::chrono::milliseconds(static_cast<int64_t>(callback.latencyUs / 1000.0 / speed));
+
+		EOS_EResult result = callback.result;
+
+		// The mock backend returns EOS_InvalidUser by itself until a product user is created, so script that
+		// as a success. If the recorded session already had a product user, start the mock user with one too.
+		if (call == MockEOSCall::ConnectLogin)
+		{
+			if (isFirstConnectLogin && result == EOS_EResult::EOS_Success)
+				MockEOSSetHasProductUser(true);
+
+			isFirstConnectLogin = false;
+
+			if (result == EOS_EResult::EOS_InvalidUser)
+				result = EOS_EResult::EOS_Success;
+		}
+
+		MockEOSQueueBehavior(call, { latency, result });
+	}
+}
+
+// The package JSON for the fake host, with placeholder IDs and the recorded settings.
+static std::string GetPackageJson(const std::string& settingsJson)
+{
+	nlohmann::json epicProps = {
+		{ "product-name", "" },
+		{ "product-version", "" },
+		{ "product-id", "mock-product-id" },
+		{ "client-id", "mock-client-id" },
+		{ "client-secret", "mock-client-secret" },
+		{ "sandbox-id", "mock-sandbox-id" },
+		{ "deployment-id", "mock-deployment-id" }
+	};
+
+	if (!settingsJson.empty())
+	{
+		try {
+			epicProps.update(nlohmann::json::parse(settingsJson));
+		}
+		catch (...)
+		{
+			fprintf(stderr, "Failed to read recorded settings, using defaults\n");
+		}
+	}
+
+	nlohmann::json packageJson;
+	packageJson["project-details"] = { { "name", "Replay" }, { "version", "1.0.0.0" } };
+	packageJson["exported-properties"]["scirra-epic-games"] = epicProps;
+	return packageJson.dump();
+}
+
+int main(int argc, char* argv[])
+{
+	const char* path = nullptr;
+	double speed = 1.0;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		if (strcmp(argv[i], "--speed") == 0 && i + 1 < argc)
+			speed = atof(argv[++i]);
+		else if (path == nullptr)
+			path = argv[i];
+		else
+			path = nullptr, i = argc;		// too many arguments
+	}
+
+	if (path == nullptr || speed < 0.0)
+	{
+		fprintf(stderr, "Usage: ReplayMessages <recording file> [--speed <factor>]\n");
+		fprintf(stderr, "A speed of 0 replays as fast as possible.\n");
+		return 1;
+	}
+
+	Recording recording;
+	if (!ReadRecording(path, recording))
+		return 1;
+
+	printf("Recording with %zu message(s) and %zu EOS callback(s)\n", recording.messages.size(), recording.callbacks.size());
+	if (recording.isTruncated)
+		printf("(the last record was incomplete and was ignored)\n");
+
+	std::filesystem::path appDataFolder = std::filesystem::current_path() / "ReplayAppData";
+	std::error_code ec;
+	std::filesystem::remove_all(appDataFolder, ec);
+	std::filesystem::create_directories(appDataFolder, ec);
+
+	ScriptMockEOS(recording, speed);
+
+	FakeApplication app(appDataFolder.string(), GetPackageJson(recording.settingsJson));
+	std::map<std::string, LatencyHistogram> messageTimes;
+	std::chrono::steady_clock::duration replayTime;
+
+	{
+		WrapperExtension ext(&app);
+		g_Extension = &ext;
+		ext.Init();
+
+		auto startTime = std::chrono::steady_clock::now();
+
+		for (const RecordedMessage& message : recording.messages)
+		{
+			if (speed > 0.0)
+				std::this_thread::sleep_until(startTime + std::chrono::microseconds(static_cast<int64_t>(message.timeUs / speed)));
+
+			std::vector<ExtensionParameterPOD> paramPods = PackExtensionParameters(message.params);
+
+			auto messageStart = std::chrono::steady_clock::now();
+			ext.OnWebMessage(message.messageId.c_str(), paramPods.size(), paramPods.data(), message.asyncId);
+			messageTimes[message.messageId].Record(std::chrono::steady_clock::now() - messageStart);
+		}
+
+		// Let any remaining work finish, ticking as Construct would if the recording did not use native tick. Work
+		// such as batched achievement unlocks is only sent after a delay, so wait until no callbacks are pending
+		// and the extension has sent nothing for a while.
+		auto drainEnd = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+		auto lastActivityTime = std::chrono::steady_clock::now();
+		size_t lastSentCount = app.GetWebMessageCount();
+
+		while (std::chrono::steady_clock::now() < drainEnd)
+		{
+			ext.OnWebMessage("platform-tick", 0, nullptr, -1.0);
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+			auto now = std::chrono::steady_clock::now();
+			size_t sentCount = app.GetWebMessageCount();
+			if (MockEOSGetPendingCallbackCount() > 0 || sentCount != lastSentCount)
+			{
+				lastSentCount = sentCount;
+				lastActivityTime = now;
+			}
+			else if (now - lastActivityTime >= std::chrono::milliseconds(250))
+				break;
+		}
+
+		replayTime = std::chrono::steady_clock::now() - startTime;
+
+		ext.Release();
+		g_Extension = nullptr;
+	}
+
+	printf("\n%-28s %10s %10s %10s %10s %10s\n", "message", "count", "mean ms", "p50 ms", "p99 ms", "max ms");
+	for (const auto& [messageId, histogram] : messageTimes)
+	{
+		printf("%-28s %10llu %10.3f %10.3f %10.3f %10.3f\n", messageId.c_str(), static_cast<unsigned long long>(histogram.GetCount()),
+			histogram.GetMeanMs(), histogram.GetPercentileMs(0.5), histogram.GetPercentileMs(0.99), histogram.GetMaxMs());
+	}
+
+	printf("\nReplayed in %.1f ms, the extension sent %zu message(s)",
+		std::chrono::duration<double, std::milli>(replayTime).count(), app.GetWebMessageCount());
+
+	if (MockEOSGetPendingCallbackCount() > 0)
+		printf(", %zu EOS callback(s) never completed", MockEOSGetPendingCallbackCount());
+
+	printf("\n");
+	return 0;
+}
@@ -0,0 +1,62 @@
+// Runs the message bridge benchmarks (see Benchmarks.cpp) outside of Construct, by sending the extension a
+// "run-benchmarks" message as the Construct plugin's "Run benchmarks" action does, and prints the results.
+// As with the action, the results are also saved to EOSExtBenchmarks.json, here in the current directory, for
+// comparing between builds.
+// This needs the extension built with both EPICEXT_BENCHMARKS and EPICEXT_MOCK_EOS, which the CMake build
+// does for this tool. Build it with e.g.:
+//		cmake -S . -B build && cmake --build build --target RunBenchmarks
+// Usage:
+//		RunBenchmarks
+
+#include "pch.h"
+#include "WrapperExtension.h"
+#include "FakeApplication.h"
+#include "json.hpp"
+
+#include <cstdio>
+#include <filesystem>
+
+extern WrapperExtension* g_Extension;
+
+int main()
+{
+	FakeApplication app(std::filesystem::current_path().string());
+	std::vector<RecordedWebMessage> responses;
+
+	{
+		WrapperExtension ext(&app);
+		g_Extension = &ext;
+
+		// The benchmarks run synchronously, so the response is sent before this returns.
+		ext.OnWebMessage("run-benchmarks", 0, nullptr, 1.0);
+		responses = app.TakeWebMessages();
+
+		ext.Release();
+		g_Extension = nullptr;
+	}
+
+	auto it = std::find_if(responses.begin(), responses.end(), [](const RecordedWebMessage& message)
+	{
+		return message.asyncId == 1.0;
+	});
+
+	if (it == responses.end() || it->params["isOk"].number == 0.0)
+	{
+		fprintf(stderr, "Benchmarks are not available: rebuild with EPICEXT_BENCHMARKS defined\n");
+		return 1;
+	}
+
+	nlohmann::json results = nlohmann::json::parse(it->params["results"].str);
+
+	printf("%-56s %12s %14s %14s\n", "benchmark", "iterations", "ns/op", "allocs/op");
+	for (const auto& result : results)
+	{
+		printf("%-56s %12llu %14.1f %14.2f\n", result["name"].get<std::string>().c_str(), result["iterations"].get<unsigned long long>(),
+			result["nsPerOp"].get<double>(), result["allocationsPerOp"].get<double>());
+	}
+
+	if (!it->params["path"].str.empty())
+		printf("\nSaved results to %s\n", it->params["path"].str.c_str());
+
+	return 0;
+}
@@ -0,0 +1,159 @@
+
+#include "pch.h"
+#include "AchievementCache.h"
+
+const size_t INITIAL_CAPACITY = 64;		// must be a power of two
+
+AchievementCache::AchievementCache()
+	: entries(INITIAL_CAPACITY),
+	  count(0),
+	  isReady(false)
+{
+}
+
+void AchievementCache::Clear()
+{
+	entries.assign(INITIAL_CAPACITY, Entry{});
+	idStorage.clear();
+	count = 0;
+	isReady = false;
+}
+
+bool AchievementCache::IsReady() const
+{
+	return isReady;
+}
+
+void AchievementCache::SetReady()
+{
+	isReady = true;
+}
+
+void AchievementCache::AddDefinition(std::string_view achievementId)
+{
+	if (achievementId.empty())
+		return;
+
+	FindOrInsert(achievementId).isDefined = true;
+}
+
+void AchievementCache::SetProgress(std::string_view achievementId, double progress, int64_t unlockTime)
+{
+	if (achievementId.empty())
+		return;
+
+	AchievementState& state = FindOrInsert(achievementId);
+	state.progress = progress;
+	state.unlockTime = unlockTime;
+}
+
+void AchievementCache::SetUnlocked(std::string_view achievementId, int64_t unlockTime)
+{
+	if (achievementId.empty())
+		return;
+
+	AchievementState& state = FindOrInsert(achievementId);
+	state.progress = 1.0;
+
+	// Keep the original unlock time if it was already unlocked.
+	if (state.unlockTime == -1)
+		state.unlockTime = unlockTime;
+}
+
+const AchievementState* AchievementCache::Find(std::string_view achievementId) const
+{
+	const Entry& entry = entries[FindSlot(achievementId, HashId(achievementId))];
+	return entry.idLength == 0 ? nullptr : &entry.state;
+}
+
+bool AchievementCache::IsUnlocked(std::string_view achievementId) const
+{
+	const AchievementState* state = Find(achievementId);
+	return state != nullptr && state->IsUnlocked();
+}
+
+size_t AchievementCache::size() const
+{
+	return count;
+}
+
+// FNV-1a hash, the same as used for web message names.
+uint32_t AchievementCache::HashId(std::string_view achievementId)
+{
+	uint32_t hash = 2166136261u;
+	for (char c : achievementId)
+	{
+		hash ^= static_cast<uint8_t>(c);
+		hash *= 16777619u;
+	}
+
+	return hash;
+}
+
+std::string_view AchievementCache::GetEntryId(const Entry& entry) const
+{
+	return std::string_view(idStorage.data() + entry.idOffset, entry.idLength);
+}
+
+// Return the slot holding the given ID, or the empty slot where it would be inserted.
+size_t AchievementCache::FindSlot(std::string_view achievementId, uint32_t hash) const
+{
+	size_t mask = entries.size() - 1;
+	size_t slot = hash & mask;
+
+	while (true)
+	{
+		const Entry& entry = entries[slot];
+		if (entry.idLength == 0 || (entry.hash == hash && GetEntryId(entry) == achievementId))
+			return slot;
+
+		slot = (slot + 1) & mask;
+	}
+}
+
+// Note the ID must not be empty, as a zero length marks an empty slot.
+AchievementState& AchievementCache::FindOrInsert(std::string_view achievementId)
+{
+	uint32_t hash = HashId(achievementId);
+	size_t slot = FindSlot(achievementId, hash);
+
+	if (entries[slot].idLength != 0)
+		return entries[slot].state;
+
+	// Keep the load factor under 3/4 so probe sequences stay short.
+	if ((count + 1) * 4 > entries.size() * 3)
+	{
+		Grow();
+		slot = FindSlot(achievementId, hash);
+	}
+
+	Entry& entry = entries[slot];
+	entry.hash = hash;
+	entry.idOffset = static_cast<uint32_t>(idStorage.size());
+	entry.idLength = static_cast<uint32_t>(achievementId.size());
+	entry.state = AchievementState{ false, 0.0, -1 };
+	idStorage.append(achievementId);
+	count++;
+
+	return entry.state;
+}
+
+void AchievementCache::Grow()
+{
+	std::vector<Entry> oldEntries(entries.size() * 2);
+	oldEntries.swap(entries);
+
+	size_t mask = entries.size() - 1;
+
+	for (const Entry& oldEntry : oldEntries)
+	{
+		if (oldEntry.idLength == 0)
+			continue;
+
+		size_t slot = oldEntry.hash & mask;
+		while (entries[slot].idLength != 0)
+			slot = (slot + 1) & mask;
+
+		entries[slot] = oldEntry;
+	}
+}
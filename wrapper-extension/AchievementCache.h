@@ -0,0 +1,62 @@
+#pragma once
+
+#include <stdint.h>
+
+// Locally cached state of one achievement for the logged in player.
+struct AchievementState {
+	bool isDefined;				// listed in the achievement definitions for the product
+	double progress;			// 0-1, where 1 means unlocked
+	int64_t unlockTime;			// POSIX timestamp, or -1 if not unlocked
+
+	bool IsUnlocked() const
+	{
+		return unlockTime != -1 || progress >= 1.0;
+	}
+};
+
+// A compact hash table of achievement states, keyed by achievement ID. This is filled in from
+// EOS_Achievements_QueryDefinitions() and EOS_Achievements_QueryPlayerAchievements() after
+// ConnectLogin() succeeds, and then updated as unlocks succeed. It allows skipping unlocks of
+// achievements the player already has, and answering queries without a backend call.
+// The table uses open addressing with linear probing, and all the IDs are stored back-to-back in a
+// single string, so it makes no per-entry allocations.
+class AchievementCache {
+public:
+	AchievementCache();
+
+	void Clear();
+
+	// The cache is ready once the player's achievements have been loaded. Until then it has no
+	// information about which achievements are unlocked.
+	bool IsReady() const;
+	void SetReady();
+
+	void AddDefinition(std::string_view achievementId);
+	void SetProgress(std::string_view achievementId, double progress, int64_t unlockTime);
+	void SetUnlocked(std::string_view achievementId, int64_t unlockTime);
+
+	// Returns nullptr if the achievement is not in the cache.
+	const AchievementState* Find(std::string_view achievementId) const;
+	bool IsUnlocked(std::string_view achievementId) const;
+
+	size_t size() const;
+
+protected:
+	struct Entry {
+		uint32_t hash;
+		uint32_t idOffset;			// into idStorage
+		uint32_t idLength;			// 0 means the slot is empty
+		AchievementState state;
+	};
+
+	static uint32_t HashId(std::string_view achievementId);
+	std::string_view GetEntryId(const Entry& entry) const;
+	size_t FindSlot(std::string_view achievementId, uint32_t hash) const;
+	AchievementState& FindOrInsert(std::string_view achievementId);
+	void Grow();
+
+	std::vector<Entry> entries;			// size is always a power of two
+	std::string idStorage;
+	size_t count;
+	bool isReady;
+};
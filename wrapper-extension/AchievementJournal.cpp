@@ -0,0 +1,292 @@
+
+#include "pch.h"
+#include "AchievementJournal.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+// Compact the journal once it has this many stale records. Each compaction rewrites and flushes the whole
+// file, so this is not done on every acknowledgement, even when nothing is left pending.
+const size_t JOURNAL_COMPACT_THRESHOLD = 64;
+
+static bool IsSameUnlock(const JournaledAchievementUnlock& unlock, const std::string& accountId, const std::string& achievementId)
+{
+	return unlock.accountId == accountId && unlock.achievementId == achievementId;
+}
+
+static uint32_t RecordChecksum(const char* str, size_t len)
+{
+	// FNV-1a
+	uint32_t hash = 2166136261u;
+	for (size_t i = 0; i < len; ++i)
+	{
+		hash ^= static_cast<uint8_t>(str[i]);
+		hash *= 16777619u;
+	}
+
+	return hash;
+}
+
+AchievementJournal::AchievementJournal()
+	: staleRecordCount(0)
+{
+}
+
+AchievementJournal::~AchievementJournal()
+{
+	Close();
+}
+
+bool AchievementJournal::Open(const std::string& path_)
+{
+	Close();
+
+	path = path_;
+	Load();
+
+	// Drop any acknowledged or damaged records from the last session before appending more.
+	if (staleRecordCount > 0)
+		Rewrite();
+	else
+		file.Open(path, PlatformFile::Mode::Append);
+
+	return IsOpen();
+}
+
+void AchievementJournal::Close()
+{
+	Compact();
+	file.Close();
+}
+
+void AchievementJournal::Compact()
+{
+	if (IsOpen() && staleRecordCount > 0)
+		Rewrite();
+}
+
+bool AchievementJournal::IsOpen() const
+{
+	return file.IsOpen();
+}
+
+bool AchievementJournal::AddPending(const std::string& accountId, const std::vector<std::string>& achievementIds)
+{
+	if (!IsValidId(accountId))
+		return false;
+
+	std::vector<std::string> newIds;
+	for (const std::string& achievementId : achievementIds)
+	{
+		if (IsValidId(achievementId) && !IsPending(accountId, achievementId) &&
+			std::find(newIds.begin(), newIds.end(), achievementId) == newIds.end())
+		{
+			newIds.push_back(achievementId);
+		}
+	}
+
+	if (newIds.empty())
+		return true;
+
+	if (!AppendRecords('U', accountId, newIds, true))
+		return false;
+
+	for (const std::string& achievementId : newIds)
+		pending.push_back({ accountId, achievementId });
+
+	return true;
+}
+
+void AchievementJournal::Acknowledge(const std::string& accountId, const std::vector<std::string>& achievementIds)
+{
+	std::vector<std::string> ackIds;
+	for (const std::string& achievementId : achievementIds)
+	{
+		auto it = std::find_if(pending.begin(), pending.end(), [&](const JournaledAchievementUnlock& unlock)
+		{
+			return IsSameUnlock(unlock, accountId, achievementId);
+		});
+
+		if (it != pending.end())
+		{
+			pending.erase(it);
+			ackIds.push_back(achievementId);
+		}
+	}
+
+	if (ackIds.empty())
+		return;
+
+	AppendRecords('A', accountId, ackIds, false);
+	staleRecordCount += 2 * ackIds.size();		// both the unlock and its acknowledgement
+
+	if (staleRecordCount >= JOURNAL_COMPACT_THRESHOLD)
+		Rewrite();
+}
+
+std::vector<std::string> AchievementJournal::GetPending(const std::string& accountId) const
+{
+	std::vector<std::string> ret;
+	for (const JournaledAchievementUnlock& unlock : pending)
+	{
+		if (unlock.accountId == accountId)
+			ret.push_back(unlock.achievementId);
+	}
+
+	return ret;
+}
+
+bool AchievementJournal::HasPending(const std::string& accountId) const
+{
+	return std::any_of(pending.begin(), pending.end(), [&](const JournaledAchievementUnlock& unlock)
+	{
+		return unlock.accountId == accountId;
+	});
+}
+
+size_t AchievementJournal::GetPendingCount() const
+{
+	return pending.size();
+}
+
+bool AchievementJournal::IsPending(const std::string& accountId, const std::string& achievementId) const
+{
+	return std::any_of(pending.begin(), pending.end(), [&](const JournaledAchievementUnlock& unlock)
+	{
+		return IsSameUnlock(unlock, accountId, achievementId);
+	});
+}
+
+void AchievementJournal::Load()
+{
+	pending.clear();
+	staleRecordCount = 0;
+
+	std::string content;
+	if (!PlatformReadFile(path, content))
+		return;		// no journal yet
+
+	// Every record that does not end up pending is stale, including damaged ones.
+	size_t recordCount = 0;
+
+	// Replay each complete line in order. A line is "<op> <accountId> <achievementId> <checksum>", where the
+	// checksum covers "<op> <accountId> <achievementId>". Lines without an account ID are ignored.
+	size_t lineStart = 0;
+	while (true)
+	{
+		size_t lineEnd = content.find('\n', lineStart);
+		if (lineEnd == std::string::npos)
+		{
+			// Ignore any partial last line
+			if (lineStart < content.size())
+				recordCount++;
+
+			break;
+		}
+
+		recordCount++;
+
+		std::string line = content.substr(lineStart, lineEnd - lineStart);
+		lineStart = lineEnd + 1;
+
+		size_t checksumSep = line.rfind(' ');
+		if (line.size() < 3 || line[1] != ' ' || checksumSep == std::string::npos || checksumSep <= 2)
+			continue;
+
+		uint32_t checksum = static_cast<uint32_t>(std::strtoul(line.c_str() + checksumSep + 1, nullptr, 16));
+		if (checksum != RecordChecksum(line.data(), checksumSep))
+			continue;
+
+		size_t accountSep = line.find(' ', 2);
+		if (accountSep == checksumSep || accountSep == 2 || accountSep + 1 == checksumSep)
+			continue;
+
+		char op = line[0];
+		std::string accountId = line.substr(2, accountSep - 2);
+		std::string achievementId = line.substr(accountSep + 1, checksumSep - accountSep - 1);
+
+		auto it = std::find_if(pending.begin(), pending.end(), [&](const JournaledAchievementUnlock& unlock)
+		{
+			return IsSameUnlock(unlock, accountId, achievementId);
+		});
+
+		if (op == 'U' && it == pending.end())
+			pending.push_back({ accountId, achievementId });
+		else if (op == 'A' && it != pending.end())
+			pending.erase(it);
+	}
+
+	staleRecordCount = recordCount - pending.size();
+}
+
+// Write out just the pending records to a temporary file, then replace the journal with it. The
+// replace is atomic, so a crash part way through leaves either the old or the new journal intact.
+void AchievementJournal::Rewrite()
+{
+	file.Close();
+
+	std::string content;
+	for (const JournaledAchievementUnlock& unlock : pending)
+		content += FormatRecord('U', unlock.accountId, unlock.achievementId);
+
+	std::string tempPath = path + ".tmp";
+
+	PlatformFile tempFile;
+	if (tempFile.Open(tempPath, PlatformFile::Mode::Create))
+	{
+		bool isOk = tempFile.Write(content.data(), content.size()) && tempFile.Flush();
+		tempFile.Close();
+
+		if (isOk && PlatformMoveFile(tempPath, path))
+			staleRecordCount = 0;
+		else
+			PlatformDeleteFile(tempPath);
+	}
+
+	// Reopen for appending further records.
+	file.Open(path, PlatformFile::Mode::Append);
+}
+
+bool AchievementJournal::AppendRecords(char op, const std::string& accountId, const std::vector<std::string>& achievementIds, bool flush)
+{
+	if (!IsOpen())
+		return false;
+
+	std::string content;
+	for (const std::string& achievementId : achievementIds)
+		content += FormatRecord(op, accountId, achievementId);
+
+	// Flush if required so the records are on disk before e.g. the unlock is reported as saved.
+	return file.Write(content.data(), content.size()) && (!flush || file.Flush());
+}
+
+// IDs are written as-is, so only allow IDs that cannot break the line format.
+bool AchievementJournal::IsValidId(const std::string& id)
+{
+	if (id.empty())
+		return false;
+
+	for (char c : id)
+	{
+		if (static_cast<uint8_t>(c) <= ' ')
+			return false;
+	}
+
+	return true;
+}
+
+std::string AchievementJournal::FormatRecord(char op, const std::string& accountId, const std::string& achievementId)
+{
+	std::string record;
+	record += op;
+	record += ' ';
+	record += accountId;
+	record += ' ';
+	record += achievementId;
+
+	char checksumStr[16];
+	snprintf(checksumStr, sizeof(checksumStr), " %08x\n", RecordChecksum(record.data(), record.size()));
+	record += checksumStr;
+
+	return record;
+}
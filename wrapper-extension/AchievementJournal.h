@@ -0,0 +1,61 @@
+#pragma once
+
+// A durable record of achievement unlocks that have not yet been confirmed by the backend, so they are
+// not lost if the game is closed while offline or before a product user ID exists. Each unlock is recorded
+// against the Epic account ID of the user who made it, so it is only ever sent for that user. It is stored
+// as an append-only text file in the app data folder, with one record per line:
+//		U <accountId> <achievementId> <checksum>		unlock requested
+//		A <accountId> <achievementId> <checksum>		unlock acknowledged by the backend
+// Unlock requests are flushed to disk before returning. Acknowledgements are not, as losing one only means
+// the unlock is sent again, which the backend ignores. When loading, any line with a bad checksum (such as
+// a partly written last line after a crash) is ignored. Once enough stale records build up, and when the
+// journal is closed, it is compacted by writing just the pending records to a temporary file and replacing
+// the journal with it.
+struct JournaledAchievementUnlock {
+	std::string accountId;
+	std::string achievementId;
+};
+
+class AchievementJournal {
+public:
+	AchievementJournal();
+	~AchievementJournal();
+
+	// Open the journal at the given path, loading any pending unlocks from a previous session.
+	bool Open(const std::string& path_);
+
+	// Close the journal, compacting it first if it has any stale records.
+	void Close();
+
+	// Compact the journal now if it has any stale records, e.g. when a user logs out. Otherwise this only
+	// happens once JOURNAL_COMPACT_THRESHOLD stale records have built up.
+	void Compact();
+
+	bool IsOpen() const;
+
+	// Record unlock requests for the given account, skipping any already pending. Returns false if they
+	// could not be written, including if the account ID is empty.
+	bool AddPending(const std::string& accountId, const std::vector<std::string>& achievementIds);
+
+	// Record that unlocks for the given account were confirmed, removing them from the pending list.
+	void Acknowledge(const std::string& accountId, const std::vector<std::string>& achievementIds);
+
+	std::vector<std::string> GetPending(const std::string& accountId) const;
+	bool HasPending(const std::string& accountId) const;
+	size_t GetPendingCount() const;
+	bool IsPending(const std::string& accountId, const std::string& achievementId) const;
+
+protected:
+	void Load();
+	void Rewrite();
+	bool AppendRecords(char op, const std::string& accountId, const std::vector<std::string>& achievementIds, bool flush);
+
+	static bool IsValidId(const std::string& id);
+	static std::string FormatRecord(char op, const std::string& accountId, const std::string& achievementId);
+
+	std::string path;
+	PlatformFile file;
+
+	std::vector<JournaledAchievementUnlock> pending;
+	size_t staleRecordCount;		// records in the file not needed for the pending list, e.g. acknowledged
+};
@@ -0,0 +1,224 @@
+
+#include "pch.h"
+#include "AsyncLogger.h"
+
+#include <cstring>
+
+AsyncLogger::AsyncLogger()
+	: iApplication(nullptr),
+	  slots(new Slot[CAPACITY]),
+	  enqueuePos(0),
+	  dequeuePos(0),
+	  droppedCount(0),
+	  reportedDroppedCount(0),
+	  wakeCounter(0),
+	  pushingCount(0),
+	  isRunning(false),
+	  isQuitting(false)
+{
+	for (size_t i = 0; i < CAPACITY; ++i)
+		slots[i].sequence.store(i, std::memory_order_relaxed);
+}
+
+AsyncLogger::~AsyncLogger()
+{
+	Stop();
+}
+
+void AsyncLogger::Start(IApplication* iApplication_)
+{
+	if (thread.joinable())
+		return;		// already running
+
+	iApplication = iApplication_;
+	isQuitting = false;
+	isRunning = true;
+
+	thread = std::thread(&AsyncLogger::ThreadMain, this);
+}
+
+// Stop the logger thread after it has emitted everything already logged. Messages logged from now on are
+// logged synchronously.
+void AsyncLogger::Stop()
+{
+	if (!thread.joinable())
+		return;
+
+	isRunning = false;
+
+	// Wait for producers that saw the logger running to publish their records. Any later producer sees it
+	// stopped and logs synchronously instead. Both sides use sequentially consistent operations on
+	// isRunning and pushingCount, so one of the two always sees the other.
+	while (pushingCount.load() > 0)
+		std::this_thread::yield();
+
+	isQuitting = true;
+	wakeCounter.fetch_add(1, std::memory_order_release);
+	wakeCounter.notify_one();
+
+	thread.join();
+}
+
+bool AsyncLogger::IsRunning() const
+{
+	return isRunning;
+}
+
+uint64_t AsyncLogger::GetDroppedCount() const
+{
+	return droppedCount.load(std::memory_order_relaxed);
+}
+
+void AsyncLogger::LogExtensionMessage(IApplication::LogLevel level, std::string_view message)
+{
+	Push(LogSource::Extension, level, 0, "", message);
+}
+
+void AsyncLogger::LogEOSMessage(const char* category, int eosLevel, IApplication::LogLevel level, const char* message)
+{
+	Push(LogSource::EOS, level, eosLevel, category, message);
+}
+
+void AsyncLogger::FillRecord(LogRecord& record, LogSource source, IApplication::LogLevel level, int eosLevel, const char* category, std::string_view message)
+{
+	record.source = source;
+	record.level = level;
+	record.eosLevel = eosLevel;
+
+	size_t categoryLength = std::min(strlen(category), MAX_CATEGORY_LENGTH - 1);
+	memcpy(record.category, category, categoryLength);
+	record.category[categoryLength] = '\0';
+
+	record.textLength = std::min(message.size(), MAX_TEXT_LENGTH);
+	record.isTruncated = (record.textLength < message.size());
+	memcpy(record.text, message.data(), record.textLength);
+}
+
+void AsyncLogger::Push(LogSource source, IApplication::LogLevel level, int eosLevel, const char* category, std::string_view message)
+{
+	// Log synchronously when the logger thread is not running. Count this producer before checking, so
+	// Stop() waits for it if it does go on to push a record.
+	pushingCount.fetch_add(1);
+
+	if (!IsRunning())
+	{
+		pushingCount.fetch_sub(1, std::memory_order_release);
+
+		LogRecord record;
+		FillRecord(record, source, level, eosLevel, category, message);
+		Emit(record);
+		return;
+	}
+
+	// Claim the slot at the enqueue position, unless it is still waiting to be read, in which case the
+	// buffer is full. Another producer may claim the same position first, in which case try the next one.
+	size_t pos = enqueuePos.load(std::memory_order_relaxed);
+	Slot* slot = nullptr;
+
+	while (true)
+	{
+		slot = &slots[pos & (CAPACITY - 1)];
+		size_t sequence = slot->sequence.load(std::memory_order_acquire);
+		intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+
+		if (diff == 0)
+		{
+			if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				break;
+		}
+		else if (diff < 0)
+		{
+			droppedCount.fetch_add(1, std::memory_order_relaxed);
+			pushingCount.fetch_sub(1, std::memory_order_release);
+			return;
+		}
+		else
+		{
+			pos = enqueuePos.load(std::memory_order_relaxed);
+		}
+	}
+
+	FillRecord(slot->record, source, level, eosLevel, category, message);
+
+	// Publish the record to the consumer and wake it.
+	slot->sequence.store(pos + 1, std::memory_order_release);
+
+	wakeCounter.fetch_add(1, std::memory_order_release);
+	wakeCounter.notify_one();
+
+	// Last, as once this reaches zero Stop() can return and the logger may be destroyed.
+	pushingCount.fetch_sub(1, std::memory_order_release);
+}
+
+// Format a record and send it to both the browser console and the debug output, to ensure whichever log
+// we're looking at includes the log messages.
+void AsyncLogger::Emit(const LogRecord& record)
+{
+	std::stringstream ss;
+
+	if (record.source == LogSource::EOS)
+		ss << "[EOS][" << record.category << "/" << record.eosLevel << "] ";
+	else
+		ss << "[EpicExt] ";
+
+	ss.write(record.text, record.textLength);
+
+	if (record.isTruncated)
+		ss << "...";
+
+	if (iApplication != nullptr)
+		iApplication->LogToConsole(record.level, ss.str().c_str());
+
+	// Add trailing newline for debug output
+	ss << "\n";
+	DebugLog(ss.str());
+}
+
+// Emit every record ready to read.
+void AsyncLogger::DrainQueue()
+{
+	while (true)
+	{
+		Slot& slot = slots[dequeuePos & (CAPACITY - 1)];
+		if (slot.sequence.load(std::memory_order_acquire) != dequeuePos + 1)
+			break;
+
+		Emit(slot.record);
+
+		// Mark the slot free for the producer one time around the buffer from now.
+		slot.sequence.store(dequeuePos + CAPACITY, std::memory_order_release);
+		dequeuePos++;
+	}
+
+	// Report any messages dropped since last time, after the messages that were logged.
+	uint64_t totalDroppedCount = droppedCount.load(std::memory_order_relaxed);
+	if (totalDroppedCount > reportedDroppedCount)
+	{
+		LogRecord record;
+		std::string message = "Warning: " + std::to_string(totalDroppedCount - reportedDroppedCount) + " log message(s) dropped as the log buffer was full";
+		FillRecord(record, LogSource::Extension, IApplication::LogLevel::warning, 0, "", message);
+		Emit(record);
+
+		reportedDroppedCount = totalDroppedCount;
+	}
+}
+
+void AsyncLogger::ThreadMain()
+{
+	while (true)
+	{
+		// Read the wake counter before draining, so any record published after draining changes the
+		// counter and the wait returns immediately.
+		uint32_t lastWakeCounter = wakeCounter.load(std::memory_order_acquire);
+
+		DrainQueue();
+
+		if (isQuitting)
+			break;
+
+		wakeCounter.wait(lastWakeCounter, std::memory_order_acquire);
+	}
+
+	// Emit anything logged while quitting.
+	DrainQueue();
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include "IApplication.h"
+
+// Log messages are written to a fixed-size ring buffer by the logging thread, and then formatted and sent
+// to the browser console and debug output by a background thread. This keeps the cost of logging on the
+// calling thread to a copy of the message, which matters most for EOS log messages, as those are mostly
+// sent from callbacks inside EOS_Platform_Tick().
+// The ring buffer is a bounded lock-free queue supporting multiple producers and a single consumer. If it
+// is full the message is dropped and counted, rather than waiting for space, so logging never blocks. The
+// consumer then logs how many were dropped.
+// When the logger is not running, i.e. before Start() or after Stop(), messages are logged synchronously.
+// Note this means IApplication::LogToConsole() is called from the logger thread, which is also the case
+// for native tick mode, where messages are logged from the tick thread.
+class AsyncLogger {
+public:
+	static constexpr size_t CAPACITY = 512;				// must be a power of two
+	static constexpr size_t MAX_TEXT_LENGTH = 480;		// longer messages are truncated
+	static constexpr size_t MAX_CATEGORY_LENGTH = 32;
+
+	AsyncLogger();
+	~AsyncLogger();
+
+	void Start(IApplication* iApplication_);
+	void Stop();
+
+	bool IsRunning() const;
+
+	// A message from the extension, logged with the [EpicExt] prefix.
+	void LogExtensionMessage(IApplication::LogLevel level, std::string_view message);
+
+	// A message from the EOS SDK's log callback, logged with its category and level.
+	void LogEOSMessage(const char* category, int eosLevel, IApplication::LogLevel level, const char* message);
+
+	// Total number of messages dropped since the logger was created, due to the ring buffer being full.
+	uint64_t GetDroppedCount() const;
+
+protected:
+	enum class LogSource : uint8_t {
+		Extension,
+		EOS
+	};
+
+	struct LogRecord {
+		LogSource source;
+		IApplication::LogLevel level;
+		int eosLevel;
+		bool isTruncated;
+		char category[MAX_CATEGORY_LENGTH];
+		char text[MAX_TEXT_LENGTH];
+		size_t textLength;
+	};
+
+	// Each slot's sequence number says whether it is free to write (equal to the enqueue position) or ready
+	// to read (one more than it), so producers and the consumer coordinate without locks.
+	struct Slot {
+		std::atomic<size_t> sequence;
+		LogRecord record;
+	};
+
+	static void FillRecord(LogRecord& record, LogSource source, IApplication::LogLevel level, int eosLevel, const char* category, std::string_view message);
+
+	void Push(LogSource source, IApplication::LogLevel level, int eosLevel, const char* category, std::string_view message);
+	void Emit(const LogRecord& record);
+	void DrainQueue();
+	void ThreadMain();
+
+	IApplication* iApplication;
+	std::unique_ptr<Slot[]> slots;
+	std::atomic<size_t> enqueuePos;
+	size_t dequeuePos;						// only used by the consumer
+
+	std::atomic<uint64_t> droppedCount;
+	uint64_t reportedDroppedCount;			// only used by the consumer
+
+	// Producers increment this after writing a record, to wake the consumer.
+	std::atomic<uint32_t> wakeCounter;
+
+	// Number of producers between checking IsRunning() and publishing their record. Stop() waits for this
+	// to reach zero before the final drain, so a record pushed as it stops is not left in the buffer.
+	std::atomic<uint32_t> pushingCount;
+	std::atomic<bool> isRunning;
+	std::atomic<bool> isQuitting;
+	std::thread thread;
+};
@@ -0,0 +1,302 @@
+
+#include "pch.h"
+#include "Benchmarks.h"
+
+#ifdef EPICEXT_BENCHMARKS
+
+#include "WrapperExtension.h"
+
+#include <cstdlib>
+#include <new>
+
+//////////////////////////////////////////////////////
+// Allocation counting
+// Replace the global allocation functions for this module to count every heap allocation. These are counted
+// per thread, so allocations made by background threads such as the logger thread are not included.
+static thread_local uint64_t t_AllocationCount = 0;
+
+void* operator new(size_t size)
+{
+	t_AllocationCount++;
+
+	void* ptr = std::malloc(size == 0 ? 1 : size);
+	if (ptr == nullptr)
+		throw std::bad_alloc();
+
+	return ptr;
+}
+
+void operator delete(void* ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+	std::free(ptr);
+}
+
+uint64_t GetAllocationCount()
+{
+	return t_AllocationCount;
+}
+
+//////////////////////////////////////////////////////
+// Benchmarks
+
+// Run a function for the given number of iterations, measuring the time and allocations per iteration.
+template<typename Func>
+static BenchmarkResult Measure(const std::string& name, uint64_t iterations, Func func, uint64_t inputSize = 0)
+{
+	// Run once first to warm up any lazily allocated state.
+	func();
+
+	uint64_t startAllocations = GetAllocationCount();
+	auto startTime = std::chrono::steady_clock::now();
+
+	for (uint64_t i = 0; i < iterations; ++i)
+		func();
+
+	auto endTime = std::chrono::steady_clock::now();
+	uint64_t endAllocations = GetAllocationCount();
+
+	BenchmarkResult ret;
+	ret.name = name;
+	ret.inputSize = inputSize;
+	ret.iterations = iterations;
+	ret.nsPerOp = std::chrono::duration<double, std::nano>(endTime - startTime).count() / iterations;
+	ret.allocationsPerOp = static_cast<double>(endAllocations - startAllocations) / iterations;
+	return ret;
+}
+
+std::vector<BenchmarkResult> RunBenchmarks()
+{
+	const uint64_t iterations = 100000;
+
+	std::vector<BenchmarkResult> results;
+
+	// Send messages through a separate extension using a host that discards them.
+	NullApplication nullApp;
+	WrapperExtension ext(&nullApp);
+
+	std::string displayName = "Example display name";
+	std::string country = "GB";
+
+	// Fixed-shape responses using WebMessageParams, which should make no heap allocations.
+	results.push_back(Measure("send-async-response-isok", iterations, [&]()
+	{
+		ext.SendAsyncResponse({
+			{ "isOk", true }
+		}, 1.0);
+	}));
+
+	results.push_back(Measure("send-async-response-login", iterations, [&]()
+	{
+		ext.SendAsyncResponse({
+			{ "isOk", true },
+			{ "epicAccountIdStr", "0123456789abcdef0123456789abcdef" },
+			{ "displayName", displayName },
+			{ "displayNameSanitized", displayName },
+			{ "nickname", displayName },
+			{ "preferredLanguage", "en" },
+			{ "country", country }
+		}, 1.0);
+	}));
+
+	results.push_back(Measure("send-web-message-builder", iterations, [&]()
+	{
+		WebMessageParams params;
+		params.Add("loginStatus", 2.0);
+		ext.SendWebMessage("on-login-status-changed", params);
+	}));
+
+	// Callback info for async EOS calls, which comes from a pool so should make no heap allocations.
+	results.push_back(Measure("callback-info-new-release", iterations, [&]()
+	{
+		ExtCallbackInfo* callbackInfo = ext.NewCallbackInfo("benchmark", 1.0);
+		ext.ReleaseCallbackInfo(ext.LookupCallbackInfo(callbackInfo->clientData));
+	}));
+
+	// Logging a single string, which is only copied in to the logger's ring buffer, so should make no heap allocations.
+	// Note the logger thread may not keep up, in which case messages are dropped, but that is also non-blocking.
+	std::string logMessage = "Example log message for benchmarking";
+
+	results.push_back(Measure("log-message", iterations, [&]()
+	{
+		ext.Log<ExtLogLevel::Info>(logMessage);
+	}));
+
+	// Incoming messages, which are read through a view of the POD array without copying.
+	ExtensionParameterPOD logInParams[4] = {};
+	for (ExtensionParameterPOD& param : logInParams)
+	{
+		param.type = EPT_Boolean;
+		param.number = 1.0;
+	}
+
+	results.push_back(Measure("on-web-message-platform-tick", iterations, [&]()
+	{
+		ext.OnWebMessage("platform-tick", 0, nullptr, -1.0);
+	}));
+
+	results.push_back(Measure("validate-log-in-params", iterations, [&]()
+	{
+		std::string errorMessage;
+		ValidateWebMessageParams(WebMessageId::LogInPortal, ExtensionParameterArrayView(4, logInParams), errorMessage);
+	}));
+
+	// For comparison, the previous approach of copying incoming parameters in to a vector.
+	results.push_back(Measure("unpack-extension-parameter-array", iterations, [&]()
+	{
+		std::vector<ExtensionParameter> params = UnpackExtensionParameterArray(4, logInParams);
+	}));
+
+	// For comparison, the previous approach of building a std::map and packing it in to a vector.
+	results.push_back(Measure("pack-named-parameters-map-isok", iterations, [&]()
+	{
+		std::map<std::string, ExtensionParameter> params = {
+			{ "isOk", true }
+		};
+
+		std::vector<NamedExtensionParameterPOD> paramArr = PackNamedExtensionParameters(params);
+		nullApp.SendWebMessage("", paramArr.size(), paramArr.data(), 1.0);
+	}));
+
+	// The first part of dispatching every message: looking up its ID from the message string and validating its
+	// parameters, as HandleWebMessage() does before calling the handler. This does not include the handler itself.
+	// Most handlers make EOS calls, so only the handlers that just report state are run, through the whole of
+	// OnWebMessage(), in the on-web-message-* benchmarks below.
+	for (const WebMessageDesc& desc : WEB_MESSAGES)
+	{
+		ExtensionParameterPOD params[MAX_WEB_MESSAGE_PARAMS] = {};
+		for (size_t i = 0; i < desc.paramCount; ++i)
+		{
+			params[i].type = desc.paramTypes[i];
+			params[i].str = (desc.paramTypes[i] == EPT_String ? "example" : nullptr);
+		}
+
+		results.push_back(Measure(std::string("lookup-validate-") + desc.name, iterations, [&]()
+		{
+			std::string errorMessage;
+			WebMessageId id = LookupWebMessageId(desc.name);
+			ValidateWebMessageParams(id, ExtensionParameterArrayView(desc.paramCount, params), errorMessage);
+		}, desc.paramCount));
+	}
+
+	ExtensionParameterPOD achievementParam = { EPT_String, 0.0, "example" };
+	ExtensionParameterPOD noResetParam = { EPT_Boolean, 0.0, nullptr };
+
+	results.push_back(Measure("on-web-message-get-tick-status", iterations, [&]()
+	{
+		ext.OnWebMessage("get-tick-status", 0, nullptr, 1.0);
+	}));
+
+	results.push_back(Measure("on-web-message-get-metrics", iterations / 10, [&]()
+	{
+		ext.OnWebMessage("get-metrics", 1, &noResetParam, 1.0);
+	}));
+
+	results.push_back(Measure("on-web-message-get-tick-profile", iterations / 10, [&]()
+	{
+		ext.OnWebMessage("get-tick-profile", 1, &noResetParam, 1.0);
+	}));
+
+	results.push_back(Measure("on-web-message-is-achievement-unlocked", iterations, [&]()
+	{
+		ext.OnWebMessage("is-achievement-unlocked", 1, &achievementParam, 1.0);
+	}));
+
+	// Copying incoming parameters and packing outgoing ones, with varying parameter counts and string lengths.
+	const size_t paramCounts[] = { 1, 2, 4, 6, 16 };
+	const size_t stringLengths[] = { 8, 64, 1024, 16384 };
+
+	for (size_t paramCount : paramCounts)
+	{
+		std::vector<ExtensionParameterPOD> paramArr(paramCount);
+		for (ExtensionParameterPOD& param : paramArr)
+		{
+			param.type = EPT_Number;
+			param.number = 1.0;
+		}
+
+		results.push_back(Measure("unpack-extension-parameter-array-numbers/" + std::to_string(paramCount), iterations, [&]()
+		{
+			std::vector<ExtensionParameter> params = UnpackExtensionParameterArray(paramArr.size(), paramArr.data());
+		}, paramCount));
+	}
+
+	for (size_t length : stringLengths)
+	{
+		std::string str(length, 'x');
+		ExtensionParameterPOD param = { EPT_String, 0.0, str.c_str() };
+
+		results.push_back(Measure("unpack-extension-parameter-array-string/" + std::to_string(length), iterations, [&]()
+		{
+			std::vector<ExtensionParameter> params = UnpackExtensionParameterArray(1, &param);
+		}, length));
+	}
+
+	for (size_t paramCount : paramCounts)
+	{
+		std::map<std::string, ExtensionParameter> params;
+		for (size_t i = 0; i < paramCount; ++i)
+			params.emplace("param" + std::to_string(i), displayName);
+
+		results.push_back(Measure("pack-named-extension-parameters/" + std::to_string(paramCount), iterations, [&]()
+		{
+			std::vector<NamedExtensionParameterPOD> paramArr = PackNamedExtensionParameters(params);
+		}, paramCount));
+	}
+
+	// Sending responses of varying lengths, e.g. for JSON results.
+	for (size_t length : stringLengths)
+	{
+		std::string str(length, 'x');
+
+		results.push_back(Measure("send-async-response-string/" + std::to_string(length), iterations, [&]()
+		{
+			ext.SendAsyncResponse({
+				{ "isOk", true },
+				{ "result", str }
+			}, 1.0);
+		}, length));
+	}
+
+	// Trimming strings with whitespace at both ends. The string is assigned to a buffer that already has enough
+	// capacity, so only the trimming is measured.
+	for (size_t length : stringLengths)
+	{
+		std::string source = "  " + std::string(length, 'x') + "  ";
+		std::string str;
+		str.reserve(source.size());
+
+		results.push_back(Measure("trim-string/" + std::to_string(length), iterations, [&]()
+		{
+			str.assign(source);
+			TrimString(str);
+		}, length));
+	}
+
+#ifdef _WIN32
+	// Conversions to and from the UTF-16 strings used by Windows APIs, e.g. for file paths and the command line.
+	for (size_t length : stringLengths)
+	{
+		std::string utf8(length, 'x');
+		std::wstring wide(length, L'x');
+
+		results.push_back(Measure("utf8-to-wide/" + std::to_string(length), iterations, [&]()
+		{
+			std::wstring result = Utf8ToWide(utf8);
+		}, length));
+
+		results.push_back(Measure("wide-to-utf8/" + std::to_string(length), iterations, [&]()
+		{
+			std::string result = WideToUtf8(wide);
+		}, length));
+	}
+#endif
+
+	return results;
+}
+
+#endif
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "IApplication.h"
+
+// Benchmarks for measuring the cost of the message bridge inside the real extension code.
+// These are only compiled in when EPICEXT_BENCHMARKS is defined (see framework.h), since they also
+// replace the global allocation functions in order to count heap allocations.
+#ifdef EPICEXT_BENCHMARKS
+
+struct BenchmarkResult {
+	std::string name;
+	uint64_t inputSize;			// parameter count or string length for benchmarks run at several sizes, else 0
+	uint64_t iterations;
+	double nsPerOp;
+	double allocationsPerOp;
+};
+
+std::vector<BenchmarkResult> RunBenchmarks();
+
+// Number of heap allocations made by this module so far on the calling thread.
+uint64_t GetAllocationCount();
+
+// A host application that does nothing, for running a separate WrapperExtension instance in benchmarks
+// without sending anything to JavaScript.
+class NullApplication : public IApplication {
+public:
+	bool RegisterComponentId(const char* componentId) { return true; }
+	void SendWebMessage(const char* messageId, size_t paramCount, const NamedExtensionParameterPOD* paramArr, double asyncId) {}
+	const char* GetAppFolder() { return ""; }
+	const char* GetWebResourceFolder() { return ""; }
+	const char* GetCurrentAppDataFolder() { return ""; }
+	void SetSdkVersion(int version) {}
+	void SetSharedPtr(const char* id, void* ptr) {}
+	void* GetSharedPtr(const char* id) { return nullptr; }
+	void RemoveSharedPtr(const char* id) {}
+	const char* GetPathForKnownPickerTag(const char* pickerTag) { return ""; }
+	void LogToConsole(LogLevel level, const char* message) {}
+	uint32_t GetWrapperApiVersion() { return 0; }
+	const char* GetPackageJsonContent() { return "{}"; }
+};
+
+#endif
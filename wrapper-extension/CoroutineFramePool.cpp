@@ -0,0 +1,97 @@
+
+#include "pch.h"
+#include "CoroutineFramePool.h"
+
+#include <cstddef>
+#include <memory>
+
+const size_t FRAME_SIZE_CLASSES[] = { 256, 512, 1024, 2048 };
+const size_t FRAME_SIZE_CLASS_COUNT = sizeof(FRAME_SIZE_CLASSES) / sizeof(FRAME_SIZE_CLASSES[0]);
+const size_t FRAME_BLOCKS_PER_SLAB = 16;
+
+// A block on the free list stores the pointer to the next free block in its own memory.
+struct FreeFrameBlock {
+	FreeFrameBlock* next;
+};
+
+struct FrameSizeClass {
+	FreeFrameBlock* freeList = nullptr;
+	std::vector<std::unique_ptr<std::max_align_t[]>> slabs;
+};
+
+static FrameSizeClass g_FrameSizeClasses[FRAME_SIZE_CLASS_COUNT];
+static CoroutineFramePoolStats g_FramePoolStats = {};
+
+static size_t GetFrameSizeClass(size_t size)
+{
+	for (size_t i = 0; i < FRAME_SIZE_CLASS_COUNT; ++i)
+	{
+		if (size <= FRAME_SIZE_CLASSES[i])
+			return i;
+	}
+
+	return FRAME_SIZE_CLASS_COUNT;		// too large to pool
+}
+
+static void AddFrameSlab(size_t sizeClassIndex)
+{
+	FrameSizeClass& sizeClass = g_FrameSizeClasses[sizeClassIndex];
+	size_t blockSize = FRAME_SIZE_CLASSES[sizeClassIndex];
+	size_t slabSize = blockSize * FRAME_BLOCKS_PER_SLAB;
+
+	// Allocate as max_align_t so every block is suitably aligned for any frame.
+	sizeClass.slabs.push_back(std::make_unique<std::max_align_t[]>(slabSize / sizeof(std::max_align_t)));
+	char* slab = reinterpret_cast<char*>(sizeClass.slabs.back().get());
+
+	for (size_t i = 0; i < FRAME_BLOCKS_PER_SLAB; ++i)
+	{
+		FreeFrameBlock* block = reinterpret_cast<FreeFrameBlock*>(slab + i * blockSize);
+		block->next = sizeClass.freeList;
+		sizeClass.freeList = block;
+	}
+
+	g_FramePoolStats.reservedBytes += slabSize;
+}
+
+void* AllocateCoroutineFrame(size_t size)
+{
+	size_t sizeClassIndex = GetFrameSizeClass(size);
+	if (sizeClassIndex == FRAME_SIZE_CLASS_COUNT)
+	{
+		g_FramePoolStats.fallbackAllocationCount++;
+		return ::operator new(size);
+	}
+
+	FrameSizeClass& sizeClass = g_FrameSizeClasses[sizeClassIndex];
+	if (sizeClass.freeList == nullptr)
+		AddFrameSlab(sizeClassIndex);
+
+	FreeFrameBlock* block = sizeClass.freeList;
+	sizeClass.freeList = block->next;
+
+	g_FramePoolStats.pooledAllocationCount++;
+	g_FramePoolStats.framesInUse++;
+	return block;
+}
+
+void FreeCoroutineFrame(void* ptr, size_t size)
+{
+	size_t sizeClassIndex = GetFrameSizeClass(size);
+	if (sizeClassIndex == FRAME_SIZE_CLASS_COUNT)
+	{
+		::operator delete(ptr);
+		return;
+	}
+
+	FrameSizeClass& sizeClass = g_FrameSizeClasses[sizeClassIndex];
+	FreeFrameBlock* block = static_cast<FreeFrameBlock*>(ptr);
+	block->next = sizeClass.freeList;
+	sizeClass.freeList = block;
+
+	g_FramePoolStats.framesInUse--;
+}
+
+CoroutineFramePoolStats GetCoroutineFramePoolStats()
+{
+	return g_FramePoolStats;
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <stdint.h>
+
+// Allocator for coroutine frames, so running an EOSTask does not use the general heap. Frames are
+// rounded up to one of a few size classes, each with its own free list of blocks carved from slabs.
+// Blocks are reused but never returned to the heap. Frames larger than the biggest size class fall back
+// to the global operator new.
+// Note this is not thread-safe: coroutines are only started and resumed on the thread using the EOS SDK.
+void* AllocateCoroutineFrame(size_t size);
+void FreeCoroutineFrame(void* ptr, size_t size);
+
+struct CoroutineFramePoolStats {
+	uint64_t pooledAllocationCount;
+	uint64_t fallbackAllocationCount;
+	uint64_t framesInUse;
+	uint64_t reservedBytes;
+};
+
+CoroutineFramePoolStats GetCoroutineFramePoolStats();
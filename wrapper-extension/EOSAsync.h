@@ -0,0 +1,72 @@
+#pragma once
+
+#include <type_traits>
+
+// Typed wrapper for async EOS SDK calls, replacing a hand-written EOS_CALL trampoline per call.
+// An async EOS function takes (handle, options, ClientData, callback), where the callback receives a
+// callback info struct with ClientData and ResultCode members. CallEOSAsync() passes a pooled
+// ExtCallbackInfo as ClientData along with a trampoline generated for the given handler method, which
+// looks up the ExtCallbackInfo, records the operation's timing and result, calls the handler, and then
+// releases the ExtCallbackInfo. For example:
+//		CallEOSAsync<&WrapperExtension::OnLogOutCallback>("auth-logout", EOS_Auth_Logout, hAuth, LogoutOptions, asyncId);
+// The handler can take one of these forms, where T is the EOS callback info type:
+//		void OnXCallback(const T* Data);
+//		void OnXCallback(const T* Data, double asyncId);
+//		void OnXCallback(const T* Data, const ExtCallbackInfo& callbackInfo);
+// Note this must only be included in WrapperExtension.cpp, as the trampolines use g_Extension.
+
+extern WrapperExtension* g_Extension;
+
+// Get the callback info type T from an EOS callback function pointer type void (*)(const T*).
+template<typename CallbackFnT>
+struct EOSCallbackInfoOf;
+
+template<typename T>
+struct EOSCallbackInfoOf<void (EOS_CALL*)(const T*)> {
+	typedef T type;
+};
+
+template<auto Handler, typename CallbackInfoT>
+void EOS_CALL EOSAsyncCallbackFn(const CallbackInfoT* Data)
+{
+	// Some operations call back with a result indicating the SDK will retry. Only handle the final result.
+	if (!EOS_EResult_IsOperationComplete(Data->ResultCode))
+		return;
+
+	// Callbacks for operations abandoned in Release() are stale, so are dropped.
+	ExtCallbackInfo* callbackInfo = g_Extension->LookupCallbackInfo(Data->ClientData);
+	if (callbackInfo == nullptr)
+		return;
+
+	WrapperExtension* extension = callbackInfo->extension;
+	TickProfiler::CallbackScope profileScope(extension->GetTickProfiler(), callbackInfo->operationName);
+	SpanTracer::Scope traceScope(extension->GetSpanTracer(), callbackInfo->operationName, "eos-callback", callbackInfo->asyncId);
+
+	extension->CompleteAsyncOperation(*callbackInfo, Data->ResultCode);
+
+	typedef decltype(Handler) HandlerT;
+	if constexpr (std::is_invocable_v<HandlerT, WrapperExtension*, const CallbackInfoT*, double>)
+		(extension->*Handler)(Data, callbackInfo->asyncId);
+	else if constexpr (std::is_invocable_v<HandlerT, WrapperExtension*, const CallbackInfoT*, const ExtCallbackInfo&>)
+		(extension->*Handler)(Data, *callbackInfo);
+	else
+		(extension->*Handler)(Data);
+
+	extension->ReleaseCallbackInfo(callbackInfo);
+}
+
+// Issue an async call using callback info already allocated with NewCallbackInfo(), for operations that
+// need to store extra state in it first.
+template<auto Handler, typename HandleT, typename OptionsT, typename CallbackFnT>
+void WrapperExtension::CallEOSAsync(ExtCallbackInfo* callbackInfo, void (EOS_CALL* eosFunc)(HandleT, const OptionsT*, void*, CallbackFnT), HandleT handle, const OptionsT& options)
+{
+	typedef typename EOSCallbackInfoOf<CallbackFnT>::type CallbackInfoT;
+
+	eosFunc(handle, &options, callbackInfo->clientData, &EOSAsyncCallbackFn<Handler, CallbackInfoT>);
+}
+
+template<auto Handler, typename HandleT, typename OptionsT, typename CallbackFnT>
+void WrapperExtension::CallEOSAsync(const char* operationName, void (EOS_CALL* eosFunc)(HandleT, const OptionsT*, void*, CallbackFnT), HandleT handle, const OptionsT& options, double asyncId)
+{
+	CallEOSAsync<Handler>(NewCallbackInfo(operationName, asyncId), eosFunc, handle, options);
+}
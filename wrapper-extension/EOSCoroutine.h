@@ -0,0 +1,115 @@
+#pragma once
+
+#include <coroutine>
+#include <exception>
+#include "CoroutineFramePool.h"
+
+// C++20 coroutine support for writing multi-step EOS flows as a single function, e.g.:
+//		EOSTask WrapperExtension::SomeFlow()
+//		{
+//			EOS_Auth_LoginCallbackInfo result = co_await AwaitEOS("auth-login", EOS_Auth_Login, hAuth, LoginOptions);
+//			...
+//		}
+// Awaiting an EOS call issues it with pooled callback info, just like CallEOSAsync(), and suspends the
+// coroutine. The coroutine is resumed from inside the EOS callback, which happens during EOS_Platform_Tick(),
+// so it always resumes on the thread using the EOS SDK. The awaited result is a copy of the EOS callback
+// info struct, but any pointers in it are only valid until the next co_await.
+// Note this must only be included in WrapperExtension.cpp, after EOSAsync.h.
+
+// A fire-and-forget coroutine. It starts running immediately, and its frame is destroyed when it finishes.
+// Frames are allocated from the coroutine frame pool rather than the general heap.
+struct EOSTask {
+	struct promise_type {
+		EOSTask get_return_object() noexcept { return {}; }
+		std::suspend_never initial_suspend() noexcept { return {}; }
+		std::suspend_never final_suspend() noexcept { return {}; }
+		void return_void() noexcept {}
+		void unhandled_exception() noexcept { std::terminate(); }
+
+		static void* operator new(size_t size)
+		{
+			return AllocateCoroutineFrame(size);
+		}
+
+		static void operator delete(void* ptr, size_t size)
+		{
+			FreeCoroutineFrame(ptr, size);
+		}
+	};
+};
+
+// Trampoline for awaited EOS calls: record the result, release the callback info, then resume the coroutine.
+template<typename CallbackInfoT>
+void EOS_CALL EOSAwaitCallbackFn(const CallbackInfoT* Data)
+{
+	if (!EOS_EResult_IsOperationComplete(Data->ResultCode))
+		return;
+
+	ExtCallbackInfo* callbackInfo = g_Extension->LookupCallbackInfo(Data->ClientData);
+	if (callbackInfo == nullptr)
+		return;
+
+	// Resuming the coroutine runs the rest of the flow up to its next co_await, which is timed as part of the callback.
+	WrapperExtension* extension = callbackInfo->extension;
+	TickProfiler::CallbackScope profileScope(extension->GetTickProfiler(), callbackInfo->operationName);
+	SpanTracer::Scope traceScope(extension->GetSpanTracer(), callbackInfo->operationName, "eos-callback", callbackInfo->asyncId);
+
+	extension->CompleteAsyncOperation(*callbackInfo, Data->ResultCode);
+
+	*static_cast<CallbackInfoT*>(callbackInfo->awaitResult) = *Data;
+	std::coroutine_handle<> continuation = callbackInfo->continuation;
+
+	extension->ReleaseCallbackInfo(callbackInfo);
+
+	continuation.resume();
+}
+
+template<typename HandleT, typename OptionsT, typename CallbackFnT>
+class EOSAwaitable {
+public:
+	typedef typename EOSCallbackInfoOf<CallbackFnT>::type CallbackInfoT;
+
+	EOSAwaitable(WrapperExtension* extension_, const char* operationName_, void (EOS_CALL* eosFunc_)(HandleT, const OptionsT*, void*, CallbackFnT), HandleT handle_, const OptionsT& options_, double asyncId_)
+		: extension(extension_),
+		  operationName(operationName_),
+		  eosFunc(eosFunc_),
+		  handle(handle_),
+		  options(options_),
+		  asyncId(asyncId_),
+		  result{}
+	{}
+
+	bool await_ready() const noexcept
+	{
+		return false;
+	}
+
+	void await_suspend(std::coroutine_handle<> continuation)
+	{
+		ExtCallbackInfo* callbackInfo = extension->NewCallbackInfo(operationName, asyncId);
+		callbackInfo->continuation = continuation;
+		callbackInfo->awaitResult = &result;
+
+		eosFunc(handle, &options, callbackInfo->clientData, &EOSAwaitCallbackFn<CallbackInfoT>);
+	}
+
+	CallbackInfoT await_resume() const noexcept
+	{
+		return result;
+	}
+
+protected:
+	WrapperExtension* extension;
+	const char* operationName;
+	void (EOS_CALL* eosFunc)(HandleT, const OptionsT*, void*, CallbackFnT);
+	HandleT handle;
+	OptionsT options;
+	double asyncId;
+	CallbackInfoT result;
+};
+
+template<typename HandleT, typename OptionsT, typename CallbackFnT>
+auto WrapperExtension::AwaitEOS(const char* operationName, void (EOS_CALL* eosFunc)(HandleT, const OptionsT*, void*, CallbackFnT), HandleT handle, const OptionsT& options, double asyncId)
+{
+	return EOSAwaitable<HandleT, OptionsT, CallbackFnT>(this, operationName, eosFunc, handle, options, asyncId);
+}
@@ -0,0 +1,165 @@
+
+#include "pch.h"
+#include "EOSLogLevels.h"
+
+struct EOSLogCategoryName {
+	const char* name;
+	EOS_ELogCategory category;
+};
+
+const EOSLogCategoryName EOS_LOG_CATEGORY_NAMES[] = {
+	{ "all",				EOS_ELogCategory::EOS_LC_ALL_CATEGORIES },
+	{ "core",				EOS_ELogCategory::EOS_LC_Core },
+	{ "auth",				EOS_ELogCategory::EOS_LC_Auth },
+	{ "friends",			EOS_ELogCategory::EOS_LC_Friends },
+	{ "presence",			EOS_ELogCategory::EOS_LC_Presence },
+	{ "userinfo",			EOS_ELogCategory::EOS_LC_UserInfo },
+	{ "http",				EOS_ELogCategory::EOS_LC_HttpSerialization },
+	{ "ecom",				EOS_ELogCategory::EOS_LC_Ecom },
+	{ "p2p",				EOS_ELogCategory::EOS_LC_P2P },
+	{ "sessions",			EOS_ELogCategory::EOS_LC_Sessions },
+	{ "ratelimiter",		EOS_ELogCategory::EOS_LC_RateLimiter },
+	{ "playerdatastorage",	EOS_ELogCategory::EOS_LC_PlayerDataStorage },
+	{ "analytics",			EOS_ELogCategory::EOS_LC_Analytics },
+	{ "messaging",			EOS_ELogCategory::EOS_LC_Messaging },
+	{ "connect",			EOS_ELogCategory::EOS_LC_Connect },
+	{ "overlay",			EOS_ELogCategory::EOS_LC_Overlay },
+	{ "achievements",		EOS_ELogCategory::EOS_LC_Achievements },
+	{ "stats",				EOS_ELogCategory::EOS_LC_Stats },
+	{ "ui",					EOS_ELogCategory::EOS_LC_UI }
+};
+
+struct EOSLogLevelName {
+	const char* name;
+	EOS_ELogLevel level;
+};
+
+const EOSLogLevelName EOS_LOG_LEVEL_NAMES[] = {
+	{ "off",			EOS_ELogLevel::EOS_LOG_Off },
+	{ "fatal",			EOS_ELogLevel::EOS_LOG_Fatal },
+	{ "error",			EOS_ELogLevel::EOS_LOG_Error },
+	{ "warning",		EOS_ELogLevel::EOS_LOG_Warning },
+	{ "info",			EOS_ELogLevel::EOS_LOG_Info },
+	{ "verbose",		EOS_ELogLevel::EOS_LOG_Verbose },
+	{ "veryverbose",	EOS_ELogLevel::EOS_LOG_VeryVerbose }
+};
+
+template<typename T, size_t N>
+static const T* FindByName(const T (&arr)[N], std::string_view name)
+{
+	for (const T& entry : arr)
+	{
+		if (name == entry.name)
+			return &entry;
+	}
+
+	return nullptr;
+}
+
+static const char* GetCategoryName(EOS_ELogCategory category)
+{
+	for (const EOSLogCategoryName& entry : EOS_LOG_CATEGORY_NAMES)
+	{
+		if (entry.category == category)
+			return entry.name;
+	}
+
+	return "<unknown>";
+}
+
+static const char* GetLevelName(EOS_ELogLevel level)
+{
+	for (const EOSLogLevelName& entry : EOS_LOG_LEVEL_NAMES)
+	{
+		if (entry.level == level)
+			return entry.name;
+	}
+
+	return "<unknown>";
+}
+
+bool EOSLogLevels::Parse(std::string_view str, std::vector<EOSLogLevelSetting>& result, std::string& errorMessage)
+{
+	result.clear();
+
+	size_t start = 0;
+	while (start <= str.size())
+	{
+		size_t end = std::min(str.find(',', start), str.size());
+
+		std::string part(str.substr(start, end - start));
+		TrimString(part);
+		std::transform(part.begin(), part.end(), part.begin(), [](unsigned char ch) { return static_cast<char>(std::tolower(ch)); });
+
+		start = end + 1;
+
+		// Allow empty parts, e.g. from an empty string or a trailing comma.
+		if (part.empty())
+			continue;
+
+		size_t equals = part.find('=');
+		if (equals == std::string::npos)
+		{
+			errorMessage = "Expected category=level but found '" + part + "'";
+			return false;
+		}
+
+		std::string categoryName = part.substr(0, equals);
+		std::string levelName = part.substr(equals + 1);
+		TrimString(categoryName);
+		TrimString(levelName);
+
+		const EOSLogCategoryName* category = FindByName(EOS_LOG_CATEGORY_NAMES, categoryName);
+		if (category == nullptr)
+		{
+			errorMessage = "Unknown EOS log category '" + categoryName + "'";
+			return false;
+		}
+
+		const EOSLogLevelName* level = FindByName(EOS_LOG_LEVEL_NAMES, levelName);
+		if (level == nullptr)
+		{
+			errorMessage = "Unknown EOS log level '" + levelName + "'";
+			return false;
+		}
+
+		result.push_back({ category->category, level->level });
+	}
+
+	return true;
+}
+
+void EOSLogLevels::Apply(const std::vector<EOSLogLevelSetting>& newSettings)
+{
+	for (const EOSLogLevelSetting& setting : newSettings)
+	{
+		EOS_Logging_SetLogLevel(setting.category, setting.level);
+
+		if (setting.category == EOS_ELogCategory::EOS_LC_ALL_CATEGORIES)
+			settings.clear();
+		else
+		{
+			settings.erase(std::remove_if(settings.begin(), settings.end(), [&setting](const EOSLogLevelSetting& s)
+			{
+				return s.category == setting.category;
+			}), settings.end());
+		}
+
+		settings.push_back(setting);
+	}
+}
+
+std::string EOSLogLevels::ToString() const
+{
+	std::stringstream ss;
+
+	for (size_t i = 0; i < settings.size(); ++i)
+	{
+		if (i > 0)
+			ss << ", ";
+
+		ss << GetCategoryName(settings[i].category) << "=" << GetLevelName(settings[i].level);
+	}
+
+	return ss.str();
+}
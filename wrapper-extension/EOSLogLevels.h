@@ -0,0 +1,29 @@
+#pragma once
+
+// The EOS log level to use for one log category, or all of them with EOS_LC_ALL_CATEGORIES.
+struct EOSLogLevelSetting {
+	EOS_ELogCategory category;
+	EOS_ELogLevel level;
+};
+
+// Per-category EOS log levels, set from a string of comma-separated category=level pairs, e.g.:
+//		all=warning, auth=verbose, achievements=veryverbose
+// Settings apply in order, so "all" should come first. Category names are the EOS_LC_ names in lowercase
+// without the prefix (plus "http" for HttpSerialization), and level names are the EOS_LOG_ names in lowercase.
+// The levels are read from the "eos-log-levels" exported property on startup, and can be changed at runtime
+// with the "set-eos-log-levels" message, so verbose logging can be enabled for just one category.
+class EOSLogLevels {
+public:
+	// Parse a settings string, returning false with an error message if any part of it is invalid.
+	static bool Parse(std::string_view str, std::vector<EOSLogLevelSetting>& result, std::string& errorMessage);
+
+	// Set the levels with EOS_Logging_SetLogLevel() and remember them. Setting all categories replaces any
+	// earlier per-category settings.
+	void Apply(const std::vector<EOSLogLevelSetting>& newSettings);
+
+	// The current settings in the same format that Parse() accepts.
+	std::string ToString() const;
+
+protected:
+	std::vector<EOSLogLevelSetting> settings;
+};
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <sstream>
+
+// Severity levels for the extension's own log messages. Messages are logged with e.g.:
+//		Log<ExtLogLevel::Debug>("Unlocking ", count, " achievement(s)");
+// Messages below EPICEXT_MIN_LOG_LEVEL (see framework.h) compile to nothing, so in release builds diagnostic
+// chatter costs nothing. The arguments are only formatted in to a string for messages that are compiled in,
+// and a single string argument is passed to the logger without formatting or copying it first.
+enum class ExtLogLevel : int {
+	Debug = 0,
+	Info = 1,
+	Warning = 2,
+	Error = 3
+};
+
+constexpr ExtLogLevel EXT_MIN_LOG_LEVEL = static_cast<ExtLogLevel>(EPICEXT_MIN_LOG_LEVEL);
+
+constexpr bool IsExtLogLevelEnabled(ExtLogLevel level)
+{
+	return level >= EXT_MIN_LOG_LEVEL;
+}
+
+// Concatenate arguments using operator<<.
+template<typename... Args>
+std::string FormatLogMessage(const Args&... args)
+{
+	std::stringstream ss;
+	(ss << ... << args);
+	return ss.str();
+}
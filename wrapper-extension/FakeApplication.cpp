@@ -0,0 +1,141 @@
+
+#include "pch.h"
+#include "FakeApplication.h"
+
+#ifdef EPICEXT_MOCK_EOS
+
+// The mock SDK accepts any IDs, but the extension still requires them to be present.
+static const char* DEFAULT_PACKAGE_JSON = R"({
+	"project-details": {
+		"name": "Mock project",
+		"version": "1.0.0.0"
+	},
+	"exported-properties": {
+		"scirra-epic-games": {
+			"product-name": "",
+			"product-version": "",
+			"product-id": "mock-product-id",
+			"client-id": "mock-client-id",
+			"client-secret": "mock-client-secret",
+			"sandbox-id": "mock-sandbox-id",
+			"deployment-id": "mock-deployment-id"
+		}
+	}
+})";
+
+FakeApplication::FakeApplication(const std::string& appDataFolder_, const std::string& packageJsonContent_)
+	: appDataFolder(appDataFolder_),
+	  packageJsonContent(packageJsonContent_.empty() ? DEFAULT_PACKAGE_JSON : packageJsonContent_)
+{
+}
+
+bool FakeApplication::RegisterComponentId(const char* componentId)
+{
+	return true;
+}
+
+void FakeApplication::SendWebMessage(const char* messageId, size_t paramCount, const NamedExtensionParameterPOD* paramArr, double asyncId)
+{
+	RecordedWebMessage message;
+	message.messageId = messageId;
+	message.asyncId = asyncId;
+
+	for (size_t i = 0; i < paramCount; ++i)
+	{
+		const NamedExtensionParameterPOD& param = paramArr[i];
+
+		ExtensionParameter& value = message.params[param.key];
+		value.type = param.value.type;
+		value.number = param.value.number;
+		if (param.value.type == EPT_String)
+			value.str = param.value.str;
+	}
+
+	std::lock_guard<std::mutex> lock(mutex);
+	webMessages.push_back(std::move(message));
+}
+
+const char* FakeApplication::GetAppFolder()
+{
+	return appDataFolder.c_str();
+}
+
+const char* FakeApplication::GetWebResourceFolder()
+{
+	return appDataFolder.c_str();
+}
+
+const char* FakeApplication::GetCurrentAppDataFolder()
+{
+	return appDataFolder.c_str();
+}
+
+void FakeApplication::SetSdkVersion(int version)
+{
+}
+
+void FakeApplication::SetSharedPtr(const char* id, void* ptr)
+{
+	sharedPtrs[id] = ptr;
+}
+
+void* FakeApplication::GetSharedPtr(const char* id)
+{
+	auto i = sharedPtrs.find(id);
+	return i == sharedPtrs.end() ? nullptr : i->second;
+}
+
+void FakeApplication::RemoveSharedPtr(const char* id)
+{
+	sharedPtrs.erase(id);
+}
+
+const char* FakeApplication::GetPathForKnownPickerTag(const char* pickerTag)
+{
+	return "";
+}
+
+void FakeApplication::LogToConsole(LogLevel level, const char* message)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	consoleMessages.push_back(message);
+}
+
+uint32_t FakeApplication::GetWrapperApiVersion()
+{
+	return 0;
+}
+
+const char* FakeApplication::GetPackageJsonContent()
+{
+	return packageJsonContent.c_str();
+}
+
+size_t FakeApplication::GetWebMessageCount() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return webMessages.size();
+}
+
+std::vector<RecordedWebMessage> FakeApplication::GetWebMessages() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return webMessages;
+}
+
+std::vector<RecordedWebMessage> FakeApplication::TakeWebMessages()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	std::vector<RecordedWebMessage> ret;
+	ret.swap(webMessages);
+	return ret;
+}
+
+std::vector<std::string> FakeApplication::GetConsoleMessages() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return consoleMessages;
+}
+
+#endif
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <mutex>
+#include "IApplication.h"
+
+// A host application for running the extension outside of Construct, together with the mock EOS SDK (see
+// MockEOS.h), e.g. for load tests on Linux. Messages the extension sends to JavaScript are recorded rather than
+// sent, so a test can check them. Like MockEOS.cpp this is only compiled in when EPICEXT_MOCK_EOS is defined.
+// Messages can be sent from several threads (e.g. the tick thread in native tick mode, and the logger thread
+// for console messages), so recording is thread-safe.
+// Note the extension's EOS callbacks use g_Extension, which dllmain.cpp sets on Windows, so whatever creates the
+// WrapperExtension with a FakeApplication must also set g_Extension to it.
+#ifdef EPICEXT_MOCK_EOS
+
+struct RecordedWebMessage {
+	std::string messageId;
+	std::map<std::string, ExtensionParameter> params;
+	double asyncId;
+};
+
+class FakeApplication : public IApplication {
+public:
+	// The package JSON provides the exported properties read by WrapperExtension::Init(). If it is empty, a
+	// default is used with placeholder IDs and every other property left at its default.
+	FakeApplication(const std::string& appDataFolder_, const std::string& packageJsonContent_ = "");
+
+	// IApplication
+	bool RegisterComponentId(const char* componentId);
+	void SendWebMessage(const char* messageId, size_t paramCount, const NamedExtensionParameterPOD* paramArr, double asyncId);
+	const char* GetAppFolder();
+	const char* GetWebResourceFolder();
+	const char* GetCurrentAppDataFolder();
+	void SetSdkVersion(int version);
+	void SetSharedPtr(const char* id, void* ptr);
+	void* GetSharedPtr(const char* id);
+	void RemoveSharedPtr(const char* id);
+	const char* GetPathForKnownPickerTag(const char* pickerTag);
+	void LogToConsole(LogLevel level, const char* message);
+	uint32_t GetWrapperApiVersion();
+	const char* GetPackageJsonContent();
+
+	// Recorded traffic. TakeWebMessages() returns the messages recorded so far and clears them.
+	size_t GetWebMessageCount() const;
+	std::vector<RecordedWebMessage> GetWebMessages() const;
+	std::vector<RecordedWebMessage> TakeWebMessages();
+
+	std::vector<std::string> GetConsoleMessages() const;
+
+protected:
+	std::string appDataFolder;
+	std::string packageJsonContent;
+
+	std::map<std::string, void*> sharedPtrs;
+
+	mutable std::mutex mutex;
+
+	// Following members are protected by mutex
+	std::vector<RecordedWebMessage> webMessages;
+	std::vector<std::string> consoleMessages;
+};
+
+#endif
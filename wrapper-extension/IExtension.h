@@ -1,6 +1,6 @@
 #pragma once
 
-#include <windows.h>
+#include "Platform.h"
 #include <string>
 
 // This file mainly includes implementation details of the SDK.
@@ -51,14 +51,14 @@ struct ExtensionParameter {
 
 	ExtensionParameter(const std::string& s)
 		: type(EPT_String),
-		  str(s),
-		  number(0.0)
+		  number(0.0),
+		  str(s)
 	{}
 
 	ExtensionParameter(LPCSTR s)
 		: type(EPT_String),
-		  str(s),
-		  number(0.0)
+		  number(0.0),
+		  str(s)
 	{}
 
 	// Getter methods
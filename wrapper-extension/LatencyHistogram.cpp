@@ -0,0 +1,152 @@
+
+#include "pch.h"
+#include "LatencyHistogram.h"
+
+#include <cmath>
+
+#include "json.hpp"
+
+//////////////////////////////////////////////////////
+// LatencyHistogram
+LatencyHistogram::LatencyHistogram()
+{
+	Clear();
+}
+
+void LatencyHistogram::Clear()
+{
+	std::fill(std::begin(buckets), std::end(buckets), 0);
+	count = 0;
+	totalUs = 0;
+	maxUs = 0;
+}
+
+// Values under 4us have a bucket each. Above that, the bucket is found from the position of the highest set
+// bit, and the next two bits below it select one of 4 sub-buckets.
+size_t LatencyHistogram::GetBucketIndex(uint64_t us)
+{
+	if (us < 4)
+		return static_cast<size_t>(us);
+
+	size_t highBit = 63;
+	while ((us & (1ull << highBit)) == 0)
+		--highBit;
+
+	size_t subBucket = static_cast<size_t>(us >> (highBit - 2)) & 3;
+	return std::min((highBit - 2) * 4 + 4 + subBucket, BUCKET_COUNT - 1);
+}
+
+uint64_t LatencyHistogram::GetBucketUpperBound(size_t index)
+{
+	if (index < 4)
+		return index + 1;
+
+	size_t highBit = (index - 4) / 4 + 2;
+	size_t subBucket = (index - 4) % 4;
+	return (5ull + subBucket) << (highBit - 2);
+}
+
+void LatencyHistogram::Record(std::chrono::steady_clock::duration duration)
+{
+	uint64_t us = static_cast<uint64_t>(std::max<int64_t>(std::chrono::duration_cast<std::chrono::microseconds>(duration).count(), 0));
+
+	buckets[GetBucketIndex(us)]++;
+	count++;
+	totalUs += us;
+	maxUs = std::max(maxUs, us);
+}
+
+uint64_t LatencyHistogram::GetCount() const
+{
+	return count;
+}
+
+double LatencyHistogram::GetMeanMs() const
+{
+	return count == 0 ? 0.0 : static_cast<double>(totalUs) / count / 1000.0;
+}
+
+double LatencyHistogram::GetMaxMs() const
+{
+	return maxUs / 1000.0;
+}
+
+double LatencyHistogram::GetPercentileMs(double percentile) const
+{
+	if (count == 0)
+		return 0.0;
+
+	// Find the bucket containing the value with the given rank, counting from 1.
+	uint64_t rank = std::max<uint64_t>(static_cast<uint64_t>(std::ceil(percentile * count)), 1);
+	uint64_t cumulative = 0;
+
+	for (size_t i = 0; i < BUCKET_COUNT; ++i)
+	{
+		cumulative += buckets[i];
+		if (cumulative >= rank)
+			return i == BUCKET_COUNT - 1 ? GetMaxMs() : std::min(GetBucketUpperBound(i), maxUs) / 1000.0;
+	}
+
+	return GetMaxMs();
+}
+
+//////////////////////////////////////////////////////
+// MessageLatencyMetrics
+const char* GetMessageLatencyStageName(MessageLatencyStage stage)
+{
+	switch (stage) {
+	case MessageLatencyStage::Dispatch:
+		return "dispatch";
+	case MessageLatencyStage::EOSCall:
+		return "eos-call";
+	case MessageLatencyStage::EOSCallback:
+		return "eos-callback";
+	case MessageLatencyStage::Response:
+		return "response";
+	default:
+		return "<unknown>";
+	}
+}
+
+void MessageLatencyMetrics::Clear()
+{
+	for (auto& messageHistograms : histograms)
+	{
+		for (LatencyHistogram& histogram : messageHistograms)
+			histogram.Clear();
+	}
+}
+
+void MessageLatencyMetrics::Record(WebMessageId id, MessageLatencyStage stage, std::chrono::steady_clock::time_point receiptTime)
+{
+	if (id == WebMessageId::Unknown)
+		return;
+
+	histograms[static_cast<size_t>(id)][static_cast<size_t>(stage)].Record(std::chrono::steady_clock::now() - receiptTime);
+}
+
+std::string MessageLatencyMetrics::GetJson() const
+{
+	nlohmann::json ret = nlohmann::json::object();
+
+	for (size_t i = 0; i < WEB_MESSAGE_COUNT; ++i)
+	{
+		for (size_t j = 0; j < MESSAGE_LATENCY_STAGE_COUNT; ++j)
+		{
+			const LatencyHistogram& histogram = histograms[i][j];
+			if (histogram.GetCount() == 0)
+				continue;
+
+			ret[WEB_MESSAGES[i].name][GetMessageLatencyStageName(static_cast<MessageLatencyStage>(j))] = {
+				{ "count", histogram.GetCount() },
+				{ "meanMs", histogram.GetMeanMs() },
+				{ "p50Ms", histogram.GetPercentileMs(0.5) },
+				{ "p90Ms", histogram.GetPercentileMs(0.9) },
+				{ "p99Ms", histogram.GetPercentileMs(0.99) },
+				{ "maxMs", histogram.GetMaxMs() }
+			};
+		}
+	}
+
+	return ret.dump();
+}
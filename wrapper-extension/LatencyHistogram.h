@@ -0,0 +1,65 @@
+#pragma once
+
+#include <stdint.h>
+#include <chrono>
+#include "WebMessages.h"
+
+// A fixed-size histogram of latencies, with log-spaced buckets: times are recorded in whole microseconds,
+// and each power of two is split in to 4 buckets, so a bucket's upper bound is at most 25% above its lower
+// bound. The last bucket covers everything from about 8 minutes up. Recording is a few integer operations and
+// never allocates, so it is cheap enough to do for every message.
+class LatencyHistogram {
+public:
+	static const size_t BUCKET_COUNT = 112;
+
+	LatencyHistogram();
+
+	void Clear();
+	void Record(std::chrono::steady_clock::duration duration);
+
+	uint64_t GetCount() const;
+	double GetMeanMs() const;
+	double GetMaxMs() const;
+
+	// Estimate the given percentile (0-1) from the buckets. This returns the upper bound of the bucket the
+	// percentile falls in, clamped to the maximum recorded value (which is also used for the last bucket).
+	double GetPercentileMs(double percentile) const;
+
+protected:
+	static size_t GetBucketIndex(uint64_t us);
+	static uint64_t GetBucketUpperBound(size_t index);
+
+	uint32_t buckets[BUCKET_COUNT];
+	uint64_t count;
+	uint64_t totalUs;
+	uint64_t maxUs;
+};
+
+// The stages of handling a message that latencies are recorded for. Each one is measured from when
+// OnWebMessage() received the message.
+enum class MessageLatencyStage {
+	Dispatch,		// HandleWebMessage() starts handling it, i.e. the time spent queued for the tick thread or parked
+	EOSCall,		// an async EOS call is issued for it
+	EOSCallback,	// the EOS callback for that call is received
+	Response,		// SendAsyncResponse() sends its response
+
+	Count
+};
+
+const size_t MESSAGE_LATENCY_STAGE_COUNT = static_cast<size_t>(MessageLatencyStage::Count);
+
+const char* GetMessageLatencyStageName(MessageLatencyStage stage);
+
+// A latency histogram for each stage of each kind of message, reported by the "get-metrics" message.
+// This uses fixed memory regardless of how many messages are handled.
+class MessageLatencyMetrics {
+public:
+	void Clear();
+	void Record(WebMessageId id, MessageLatencyStage stage, std::chrono::steady_clock::time_point receiptTime);
+
+	// JSON object keyed by message name then stage name, listing only histograms with something recorded.
+	std::string GetJson() const;
+
+protected:
+	LatencyHistogram histograms[WEB_MESSAGE_COUNT][MESSAGE_LATENCY_STAGE_COUNT];
+};
@@ -0,0 +1,146 @@
+
+#include "pch.h"
+#include "LogRateLimiter.h"
+
+#include <cstring>
+
+// Each message can be logged in a burst of this many times, and then once per refill interval.
+const double BURST_SIZE = 5.0;
+const std::chrono::seconds REFILL_INTERVAL(5);
+
+// Time after a message was last seen that its suppressed repeats are reported by FlushQuiet().
+const std::chrono::seconds QUIET_TIME(10);
+
+LogRateLimiter::LogRateLimiter()
+	: entries(ENTRY_COUNT),
+	  suppressedCount(0)
+{
+}
+
+// FNV-1a hash of the category and message text, skipping digits after the first in each run.
+uint64_t LogRateLimiter::HashMessage(const char* category, const char* message)
+{
+	uint64_t hash = 14695981039346656037ull;
+
+	auto hashChar = [&hash](char ch)
+	{
+		hash ^= static_cast<uint8_t>(ch);
+		hash *= 1099511628211ull;
+	};
+
+	for (const char* p = category; *p != '\0'; ++p)
+		hashChar(*p);
+
+	hashChar('\0');
+
+	bool isInDigits = false;
+	for (const char* p = message; *p != '\0'; ++p)
+	{
+		bool isDigit = (*p >= '0' && *p <= '9');
+
+		// Hash every run of digits as a single '#'.
+		if (isDigit && !isInDigits)
+			hashChar('#');
+		else if (!isDigit)
+			hashChar(*p);
+
+		isInDigits = isDigit;
+	}
+
+	// 0 marks an empty entry, so avoid it as a hash.
+	return hash == 0 ? 1 : hash;
+}
+
+void LogRateLimiter::CopyTruncated(char* dest, size_t destSize, const char* src)
+{
+	size_t length = std::min(strlen(src), destSize - 1);
+	memcpy(dest, src, length);
+	dest[length] = '\0';
+}
+
+bool LogRateLimiter::Allow(const char* category, const char* message, int eosLevel, IApplication::LogLevel level, std::chrono::steady_clock::time_point now,
+	RepeatSummary& repeatSummary, RepeatSummary& evictedSummary)
+{
+	repeatSummary.suppressedCount = 0;
+	evictedSummary.suppressedCount = 0;
+
+	uint64_t hash = HashMessage(category, message);
+
+	std::lock_guard<std::mutex> lock(mutex);
+
+	// Look for the message in the entries it can be in. If it is not there, use the first empty entry, or
+	// otherwise replace the least recently seen one.
+	Entry* entry = nullptr;
+	Entry* replaceEntry = nullptr;
+
+	for (size_t i = 0; i < PROBE_COUNT; ++i)
+	{
+		Entry& e = entries[(hash + i) & (ENTRY_COUNT - 1)];
+		if (e.hash == hash)
+		{
+			entry = &e;
+			break;
+		}
+
+		if (replaceEntry == nullptr || (replaceEntry->hash != 0 && (e.hash == 0 || e.lastSeenTime < replaceEntry->lastSeenTime)))
+			replaceEntry = &e;
+	}
+
+	if (entry == nullptr)
+	{
+		entry = replaceEntry;
+
+		if (entry->hash != 0 && entry->summary.suppressedCount > 0)
+			evictedSummary = entry->summary;
+
+		entry->hash = hash;
+		entry->tokens = BURST_SIZE;
+		entry->lastRefillTime = now;
+		CopyTruncated(entry->summary.category, MAX_CATEGORY_LENGTH, category);
+		CopyTruncated(entry->summary.text, MAX_TEXT_LENGTH, message);
+		entry->summary.eosLevel = eosLevel;
+		entry->summary.level = level;
+		entry->summary.suppressedCount = 0;
+	}
+
+	entry->tokens = std::min(entry->tokens + std::chrono::duration<double>(now - entry->lastRefillTime) / REFILL_INTERVAL, BURST_SIZE);
+	entry->lastRefillTime = now;
+	entry->lastSeenTime = now;
+
+	if (entry->tokens < 1.0)
+	{
+		entry->summary.suppressedCount++;
+		suppressedCount++;
+		return false;
+	}
+
+	entry->tokens -= 1.0;
+
+	if (entry->summary.suppressedCount > 0)
+	{
+		repeatSummary = entry->summary;
+		entry->summary.suppressedCount = 0;
+	}
+
+	return true;
+}
+
+void LogRateLimiter::FlushQuiet(std::chrono::steady_clock::time_point now, const std::function<void(const RepeatSummary&)>& func)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	for (Entry& entry : entries)
+	{
+		if (entry.hash != 0 && entry.summary.suppressedCount > 0 && now - entry.lastSeenTime >= QUIET_TIME)
+		{
+			func(entry.summary);
+			entry.summary.suppressedCount = 0;
+		}
+	}
+}
+
+uint64_t LogRateLimiter::GetSuppressedCount() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return suppressedCount;
+}
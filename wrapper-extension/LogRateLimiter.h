@@ -0,0 +1,64 @@
+#pragma once
+
+#include <stdint.h>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <vector>
+#include "IApplication.h"
+
+// Rate limits repeated EOS log messages, which the EOS SDK can send hundreds of times in a row, e.g. when the
+// network connection drops. Each distinct message (by category and text) has a token bucket allowing a short
+// burst, and after that only one message per refill interval. Repeats beyond that are suppressed and counted,
+// and then reported with a single "suppressed N repeat(s)" summary line: when the message is next allowed,
+// once it has gone quiet, or if its entry is reused for another message.
+// Messages are identified by a hash of their text with runs of digits skipped, so messages that only differ by
+// numbers such as retry counts or timings are treated as repeats. Entries are kept in a small fixed-size table,
+// so memory use is bounded: with too many distinct messages, the least recently seen one is replaced.
+// This is used from the EOS log callback, which may be called on any thread, so is protected by a mutex.
+class LogRateLimiter {
+public:
+	static const size_t ENTRY_COUNT = 128;		// must be a power of two
+	static const size_t PROBE_COUNT = 4;		// number of entries to check for a message
+	static const size_t MAX_CATEGORY_LENGTH = 32;
+	static const size_t MAX_TEXT_LENGTH = 96;	// only used for summaries, so may be truncated
+
+	// Repeats of a message that were suppressed, for logging a summary.
+	struct RepeatSummary {
+		char category[MAX_CATEGORY_LENGTH];
+		char text[MAX_TEXT_LENGTH];
+		int eosLevel;
+		IApplication::LogLevel level;
+		uint64_t suppressedCount;
+	};
+
+	LogRateLimiter();
+
+	// Returns true if the message should be logged. If it is allowed after earlier repeats were suppressed,
+	// repeatSummary has a non-zero suppressedCount. If another message's entry was replaced while it had
+	// unreported repeats, evictedSummary has a non-zero suppressedCount. Both should be logged first.
+	bool Allow(const char* category, const char* message, int eosLevel, IApplication::LogLevel level, std::chrono::steady_clock::time_point now,
+		RepeatSummary& repeatSummary, RepeatSummary& evictedSummary);
+
+	// Report repeats of messages that have not been seen for a while.
+	void FlushQuiet(std::chrono::steady_clock::time_point now, const std::function<void(const RepeatSummary&)>& func);
+
+	// Total number of messages suppressed so far.
+	uint64_t GetSuppressedCount() const;
+
+protected:
+	struct Entry {
+		uint64_t hash;			// 0 means the entry is empty
+		double tokens;
+		std::chrono::steady_clock::time_point lastRefillTime;
+		std::chrono::steady_clock::time_point lastSeenTime;
+		RepeatSummary summary;
+	};
+
+	static uint64_t HashMessage(const char* category, const char* message);
+	static void CopyTruncated(char* dest, size_t destSize, const char* src);
+
+	mutable std::mutex mutex;
+	std::vector<Entry> entries;
+	uint64_t suppressedCount;
+};
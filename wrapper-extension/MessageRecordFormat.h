@@ -0,0 +1,49 @@
+#pragma once
+
+#include <stdint.h>
+
+// The file format of the web message recordings written by MessageRecorder, and read back by the replay driver
+// in tools/ReplayMessages.cpp. This only uses fixed-size types and no Windows or EOS headers.
+// The file starts with a MessageRecordFileHeader, followed by variable-length records until the end of the
+// file. Each record starts with a MessageRecordType byte and the time since the previous record in microseconds.
+// To keep the file compact, integers are written as unsigned LEB128 varints (7 bits per byte, low bits first,
+// with the top bit set on all but the last byte), doubles as 8 little-endian bytes, and strings as a varint
+// length followed by that many bytes. Message and operation names are written once as a String record, and
+// then referred to by ID, which is the number of String records before it.
+// Records are written in the order they happen, so the file can be replayed from start to finish. If the process
+// ended while writing, the last record may be incomplete, and the reader stops there.
+
+const char MESSAGE_RECORD_MAGIC[8] = { 'E', 'X', 'T', 'M', 'S', 'G', 'R', 'C' };
+const uint32_t MESSAGE_RECORD_VERSION = 1;
+
+// Written in place of the value of a string parameter that is a credential, such as an exchange code, or that
+// was passed with an unrecognized message, so could contain anything.
+const char MESSAGE_RECORD_REDACTED[] = "<redacted>";
+
+struct MessageRecordFileHeader {
+	char magic[8];
+	uint32_t version;
+	uint32_t reserved;
+	int64_t startTimeUnixMs;
+};
+
+enum class MessageRecordType : uint8_t {
+	// string: the next string ID's text
+	String = 1,
+
+	// string: the extension settings from the exported properties, as JSON, so a replay uses the same settings.
+	// Only the settings that affect processing are included, not the product IDs and client credentials.
+	Settings = 2,
+
+	// varint: message name string ID
+	// double: asyncId
+	// uint8: parameter count, then for each parameter a uint8 ExtensionParameterType, followed by a double
+	// for booleans and numbers or a string for strings. Credentials are written as MESSAGE_RECORD_REDACTED.
+	WebMessage = 3,
+
+	// varint: operation name string ID
+	// double: asyncId of the message that started the operation, or -1
+	// varint: EOS_EResult code
+	// varint: microseconds from the EOS call to its callback
+	EOSCallback = 4
+};
@@ -0,0 +1,206 @@
+
+#include "pch.h"
+#include "MessageRecorder.h"
+#include "WebMessages.h"
+
+#include <cstring>
+
+MessageRecorder::MessageRecorder()
+	: isOpen(false),
+	  recordCount(0)
+{
+}
+
+MessageRecorder::~MessageRecorder()
+{
+	Close();
+}
+
+bool MessageRecorder::Open(const std::string& path, const std::string& settingsJson)
+{
+	Close();
+
+	std::lock_guard<std::mutex> lock(mutex);
+
+	// Keep the last session's recording, which is the one of interest after a crash.
+	PlatformMoveFile(path, path + ".prev");
+
+	if (!file.Open(path, PlatformFile::Mode::Create))
+		return false;
+
+	MessageRecordFileHeader header = {};
+	memcpy(header.magic, MESSAGE_RECORD_MAGIC, sizeof(header.magic));
+	header.version = MESSAGE_RECORD_VERSION;
+	header.startTimeUnixMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+
+	if (!file.Write(&header, sizeof(header)))
+	{
+		file.Close();
+		return false;
+	}
+
+	buffer.clear();
+	buffer.reserve(BUFFER_SIZE);
+	stringIds.clear();
+	lastRecordTime = std::chrono::steady_clock::now();
+	recordCount = 0;
+
+	BeginRecord(MessageRecordType::Settings);
+	WriteString(settingsJson);
+
+	isOpen = true;
+	return true;
+}
+
+void MessageRecorder::Close()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	if (!isOpen)
+		return;
+
+	isOpen = false;
+	FlushBuffer();
+	file.Close();
+}
+
+bool MessageRecorder::IsOpen() const
+{
+	return isOpen.load(std::memory_order_acquire);
+}
+
+uint64_t MessageRecorder::GetRecordCount() const
+{
+	return recordCount;
+}
+
+void MessageRecorder::RecordWebMessage(std::string_view messageId, const ExtensionParameterArrayView& params, double asyncId)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	if (!isOpen)
+		return;
+
+	uint64_t nameId = GetStringId(messageId);
+	WebMessageId id = LookupWebMessageId(messageId);
+
+	BeginRecord(MessageRecordType::WebMessage);
+	WriteVarint(nameId);
+	WriteDouble(asyncId);
+
+	size_t paramCount = std::min<size_t>(params.size(), UINT8_MAX);
+	WriteByte(static_cast<uint8_t>(paramCount));
+
+	for (size_t i = 0; i < paramCount; ++i)
+	{
+		ExtensionParameterType type = params.GetType(i);
+		WriteByte(static_cast<uint8_t>(type));
+
+		// Never write credentials to disk, where they could be read by anything else, including in the kept
+		// recording of the previous session.
+		if (type == EPT_String && (id == WebMessageId::Unknown || IsWebMessageParamSensitive(id, i)))
+			WriteString(MESSAGE_RECORD_REDACTED);
+		else if (type == EPT_String)
+			WriteString(params.GetString(i));
+		else
+			WriteDouble(params.GetNumber(i));
+	}
+
+	if (buffer.size() >= BUFFER_SIZE)
+		FlushBuffer();
+}
+
+void MessageRecorder::RecordEOSCallback(const char* operationName, double asyncId, EOS_EResult result, std::chrono::steady_clock::duration latency)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	if (!isOpen)
+		return;
+
+	uint64_t nameId = GetStringId(operationName);
+
+	BeginRecord(MessageRecordType::EOSCallback);
+	WriteVarint(nameId);
+	WriteDouble(asyncId);
+	WriteVarint(static_cast<uint32_t>(result));
+	WriteVarint(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(latency).count()));
+
+	if (buffer.size() >= BUFFER_SIZE)
+		FlushBuffer();
+}
+
+void MessageRecorder::Flush()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	if (isOpen)
+		FlushBuffer();
+}
+
+void MessageRecorder::BeginRecord(MessageRecordType type)
+{
+	// Time is recorded as the difference from the previous record, which is usually small, so fits in few bytes.
+	auto now = std::chrono::steady_clock::now();
+	uint64_t deltaUs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(now - lastRecordTime).count());
+
+	// Only advance by whole microseconds, so rounding errors do not build up over many records.
+	lastRecordTime += std::chrono::microseconds(deltaUs);
+
+	WriteByte(static_cast<uint8_t>(type));
+	WriteVarint(deltaUs);
+
+	recordCount++;
+}
+
+uint64_t MessageRecorder::GetStringId(std::string_view str)
+{
+	auto i = stringIds.find(std::string(str));
+	if (i != stringIds.end())
+		return i->second;
+
+	// Write the string before the record that refers to it.
+	uint64_t id = stringIds.size();
+	stringIds.emplace(std::string(str), id);
+
+	BeginRecord(MessageRecordType::String);
+	WriteString(str);
+	return id;
+}
+
+void MessageRecorder::WriteByte(uint8_t value)
+{
+	buffer.push_back(value);
+}
+
+void MessageRecorder::WriteVarint(uint64_t value)
+{
+	while (value >= 0x80)
+	{
+		buffer.push_back(static_cast<uint8_t>(value) | 0x80);
+		value >>= 7;
+	}
+
+	buffer.push_back(static_cast<uint8_t>(value));
+}
+
+void MessageRecorder::WriteDouble(double value)
+{
+	uint8_t bytes[sizeof(double)];
+	memcpy(bytes, &value, sizeof(bytes));
+	buffer.insert(buffer.end(), bytes, bytes + sizeof(bytes));
+}
+
+void MessageRecorder::WriteString(std::string_view str)
+{
+	WriteVarint(str.size());
+	buffer.insert(buffer.end(), str.begin(), str.end());
+}
+
+void MessageRecorder::FlushBuffer()
+{
+	if (buffer.empty())
+		return;
+
+	file.Write(buffer.data(), buffer.size());
+	buffer.clear();
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <unordered_map>
+#include "MessageRecordFormat.h"
+
+// An optional recording of the web messages the extension receives and the results of the EOS callbacks for
+// them, for reproducing problems such as hitches reported by players. tools/ReplayMessages.cpp feeds a
+// recording back in to the extension against the mock EOS SDK (see MockEOS.h), which is scripted with the
+// recorded callback results and latencies.
+// Records are encoded in to a memory buffer (see MessageRecordFormat.h for the format), which is written to the
+// file when it fills up, on Flush() and on Close(), so recording a message does not normally make a system call.
+// The previous session's file is kept alongside with a ".prev" suffix, like the binary trace log.
+// Records can be written from any thread, as EOS callbacks may run on the tick thread.
+class MessageRecorder {
+public:
+	static const size_t BUFFER_SIZE = 64 * 1024;
+
+	MessageRecorder();
+	~MessageRecorder();
+
+	bool Open(const std::string& path, const std::string& settingsJson);
+	void Close();
+
+	bool IsOpen() const;
+
+	void RecordWebMessage(std::string_view messageId, const ExtensionParameterArrayView& params, double asyncId);
+	void RecordEOSCallback(const char* operationName, double asyncId, EOS_EResult result, std::chrono::steady_clock::duration latency);
+
+	// Write everything recorded so far to the file.
+	void Flush();
+
+	uint64_t GetRecordCount() const;
+
+protected:
+	void BeginRecord(MessageRecordType type);
+	uint64_t GetStringId(std::string_view str);
+
+	void WriteByte(uint8_t value);
+	void WriteVarint(uint64_t value);
+	void WriteDouble(double value);
+	void WriteString(std::string_view str);
+	void FlushBuffer();
+
+	std::atomic<bool> isOpen;
+
+	std::mutex mutex;
+
+	// Following members are protected by mutex
+	PlatformFile file;
+	std::vector<uint8_t> buffer;
+	std::unordered_map<std::string, uint64_t> stringIds;
+	std::chrono::steady_clock::time_point lastRecordTime;
+	uint64_t recordCount;
+};
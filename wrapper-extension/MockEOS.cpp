@@ -0,0 +1,756 @@
+
+#include "pch.h"
+#include "MockEOS.h"
+
+#ifdef EPICEXT_MOCK_EOS
+
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <random>
+
+// The SDK only declares its handle and ID types, so the mock defines them. There is one of each.
+struct EOS_PlatformHandle {};
+struct EOS_AuthHandle {};
+struct EOS_ConnectHandle {};
+struct EOS_UserInfoHandle {};
+struct EOS_AchievementsHandle {};
+struct EOS_ContinuanceTokenDetails {};
+
+struct EOS_EpicAccountIdDetails {
+	const char* id;
+};
+
+struct EOS_ProductUserIdDetails {
+	const char* id;
+};
+
+static EOS_PlatformHandle g_MockPlatform;
+static EOS_AuthHandle g_MockAuth;
+static EOS_ConnectHandle g_MockConnect;
+static EOS_UserInfoHandle g_MockUserInfo;
+static EOS_AchievementsHandle g_MockAchievements;
+static EOS_ContinuanceTokenDetails g_MockContinuanceToken;
+
+static EOS_EpicAccountIdDetails g_MockEpicAccountId = { "0123456789abcdef0123456789abcdef" };
+static EOS_ProductUserIdDetails g_MockProductUserId = { "fedcba9876543210fedcba9876543210" };
+
+const size_t MOCK_EOS_CALL_COUNT = static_cast<size_t>(MockEOSCall::Count);
+
+struct MockPlayerAchievementState {
+	std::string achievementId;
+	double progress;
+	int64_t unlockTime;
+};
+
+// Everything the mock SDK and its backend keep track of, protected by mutex. Callbacks are always called with
+// the mutex unlocked, as they may make further EOS calls.
+struct MockEOSState {
+	std::mutex mutex;
+
+	MockEOSBehavior defaultBehaviors[MOCK_EOS_CALL_COUNT];
+	std::deque<MockEOSBehavior> queuedBehaviors[MOCK_EOS_CALL_COUNT];
+	uint64_t callCounts[MOCK_EOS_CALL_COUNT];
+
+	// Callbacks waiting to be delivered, ordered by when they are due and then by the order they were added.
+	std::map<std::pair<std::chrono::steady_clock::time_point, uint64_t>, std::function<void()>> pendingCallbacks;
+	uint64_t nextCallbackSequence = 0;
+
+	std::mt19937 random;
+
+	// Callbacks registered by the extension, which are kept on reset.
+	EOS_LogMessageFunc logCallback = nullptr;
+	EOS_ELogLevel defaultLogLevel = EOS_ELogLevel::EOS_LOG_Info;
+	std::map<EOS_ELogCategory, EOS_ELogLevel> logLevels;
+
+	EOS_Auth_OnLoginStatusChangedCallback loginStatusCallback = nullptr;
+	void* loginStatusClientData = nullptr;
+
+	// The backend state for the single user.
+	EOS_ELoginStatus loginStatus;
+	bool hasProductUser;
+	std::vector<std::string> achievementDefinitions;
+	std::vector<std::pair<std::string, int64_t>> unlockedAchievements;		// ID and unlock time
+
+	// Results of the last queries, which the Copy functions read from like the SDK's cache.
+	std::vector<std::string> queriedDefinitions;
+	std::vector<MockPlayerAchievementState> queriedPlayerAchievements;
+
+	MockEOSState()
+	{
+		ResetLocked();
+	}
+
+	void ResetLocked()
+	{
+		for (size_t i = 0; i < MOCK_EOS_CALL_COUNT; ++i)
+		{
+			defaultBehaviors[i] = { std::chrono::milliseconds(0), EOS_EResult::EOS_Success };
+			queuedBehaviors[i].clear();
+			callCounts[i] = 0;
+		}
+
+		pendingCallbacks.clear();
+
+		loginStatus = EOS_ELoginStatus::EOS_LS_NotLoggedIn;
+		hasProductUser = false;
+		achievementDefinitions.clear();
+		unlockedAchievements.clear();
+		queriedDefinitions.clear();
+		queriedPlayerAchievements.clear();
+	}
+};
+
+static MockEOSState g_MockEOS;
+
+static char* CopyString(const std::string& str)
+{
+	char* ret = new char[str.size() + 1];
+	memcpy(ret, str.c_str(), str.size() + 1);
+	return ret;
+}
+
+// Count a call and get the behavior to use for it.
+static MockEOSBehavior TakeBehavior(MockEOSCall call)
+{
+	size_t index = static_cast<size_t>(call);
+
+	std::lock_guard<std::mutex> lock(g_MockEOS.mutex);
+
+	g_MockEOS.callCounts[index]++;
+
+	std::deque<MockEOSBehavior>& queue = g_MockEOS.queuedBehaviors[index];
+	MockEOSBehavior ret;
+
+	if (queue.empty())
+		ret = g_MockEOS.defaultBehaviors[index];
+	else
+	{
+		ret = queue.front();
+		queue.pop_front();
+	}
+
+	if (ret.latencyJitter.count() > 0)
+	{
+		std::uniform_int_distribution<int64_t> jitter(0, ret.latencyJitter.count());
+		ret.latency += std::chrono::milliseconds(jitter(g_MockEOS.random));
+	}
+
+	return ret;
+}
+
+// Queue a callback to be delivered by the first EOS_Platform_Tick() call after the given delay.
+static void AddPendingCallback(std::chrono::milliseconds latency, std::function<void()> callback)
+{
+	std::lock_guard<std::mutex> lock(g_MockEOS.mutex);
+
+	auto dueTime = std::chrono::steady_clock::now() + latency;
+	g_MockEOS.pendingCallbacks.emplace(std::make_pair(dueTime, g_MockEOS.nextCallbackSequence++), std::move(callback));
+}
+
+static void MockLog(EOS_ELogCategory category, const char* categoryName, EOS_ELogLevel level, const std::string& message)
+{
+	EOS_LogMessageFunc logCallback;
+
+	{
+		std::lock_guard<std::mutex> lock(g_MockEOS.mutex);
+
+		auto i = g_MockEOS.logLevels.find(category);
+		EOS_ELogLevel categoryLevel = (i == g_MockEOS.logLevels.end() ? g_MockEOS.defaultLogLevel : i->second);
+		if (level > categoryLevel)
+			return;
+
+		logCallback = g_MockEOS.logCallback;
+	}
+
+	if (logCallback == nullptr)
+		return;
+
+	EOS_LogMessage logMessage = {};
+	logMessage.Category = categoryName;
+	logMessage.Message = message.c_str();
+	logMessage.Level = level;
+	logCallback(&logMessage);
+}
+
+// Log the result of an async call, as a warning if it failed, which also exercises the extension's logging.
+static void LogCompletion(EOS_ELogCategory category, const char* categoryName, const char* functionName, EOS_EResult result)
+{
+	bool isOk = (result == EOS_EResult::EOS_Success);
+	MockLog(category, categoryName, isOk ? EOS_ELogLevel::EOS_LOG_Verbose : EOS_ELogLevel::EOS_LOG_Warning,
+		std::string(functionName) + " completed with " + EOS_EResult_ToString(result));
+}
+
+static void SetLoginStatus(EOS_ELoginStatus status)
+{
+	EOS_Auth_LoginStatusChangedCallbackInfo info = {};
+	EOS_Auth_OnLoginStatusChangedCallback callback;
+
+	{
+		std::lock_guard<std::mutex> lock(g_MockEOS.mutex);
+
+		if (g_MockEOS.loginStatus == status)
+			return;
+
+		info.ClientData = g_MockEOS.loginStatusClientData;
+		info.LocalUserId = &g_MockEpicAccountId;
+		info.PrevStatus = g_MockEOS.loginStatus;
+		info.CurrentStatus = status;
+
+		g_MockEOS.loginStatus = status;
+		callback = g_MockEOS.loginStatusCallback;
+	}
+
+	if (callback != nullptr)
+		callback(&info);
+}
+
+//////////////////////////////////////////////////////
+// Scripting API
+void MockEOSSetBehavior(MockEOSCall call, MockEOSBehavior behavior)
+{
+	std::lock_guard<std::mutex> lock(g_MockEOS.mutex);
+	g_MockEOS.defaultBehaviors[static_cast<size_t>(call)] = behavior;
+}
+
+void MockEOSQueueBehavior(MockEOSCall call, MockEOSBehavior behavior)
+{
+	std::lock_guard<std::mutex> lock(g_MockEOS.mutex);
+	g_MockEOS.queuedBehaviors[static_cast<size_t>(call)].push_back(behavior);
+}
+
+void MockEOSSetHasProductUser(bool hasProductUser)
+{
+	std::lock_guard<std::mutex> lock(g_MockEOS.mutex);
+	g_MockEOS.hasProductUser = hasProductUser;
+}
+
+void MockEOSSetAchievementDefinitions(std::vector<std::string> achievementIds)
+{
+	std::lock_guard<std::mutex> lock(g_MockEOS.mutex);
+	g_MockEOS.achievementDefinitions = std::move(achievementIds);
+}
+
+std::vector<std::string> MockEOSGetUnlockedAchievements()
+{
+	std::lock_guard<std::mutex> lock(g_MockEOS.mutex);
+
+	std::vector<std::string> ret;
+	for (const auto& unlocked : g_MockEOS.unlockedAchievements)
+		ret.push_back(unlocked.first);
+
+	return ret;
+}
+
+void MockEOSSeedRandom(uint32_t seed)
+{
+	std::lock_guard<std::mutex> lock(g_MockEOS.mutex);
+	g_MockEOS.random.seed(seed);
+}
+
+uint64_t MockEOSGetCallCount(MockEOSCall call)
+{
+	std::lock_guard<std::mutex> lock(g_MockEOS.mutex);
+	return g_MockEOS.callCounts[static_cast<size_t>(call)];
+}
+
+size_t MockEOSGetPendingCallbackCount()
+{
+	std::lock_guard<std::mutex> lock(g_MockEOS.mutex);
+	return g_MockEOS.pendingCallbacks.size();
+}
+
+void MockEOSReset()
+{
+	std::lock_guard<std::mutex> lock(g_MockEOS.mutex);
+	g_MockEOS.ResetLocked();
+}
+
+//////////////////////////////////////////////////////
+// Common
+EOS_DECLARE_FUNC(const char*) EOS_EResult_ToString(EOS_EResult Result)
+{
+#define MOCK_EOS_RESULT_CASE(name) case EOS_EResult::name: return #name;
+
+	switch (Result) {
+	MOCK_EOS_RESULT_CASE(EOS_Success)
+	MOCK_EOS_RESULT_CASE(EOS_NoConnection)
+	MOCK_EOS_RESULT_CASE(EOS_InvalidCredentials)
+	MOCK_EOS_RESULT_CASE(EOS_InvalidUser)
+	MOCK_EOS_RESULT_CASE(EOS_InvalidAuth)
+	MOCK_EOS_RESULT_CASE(EOS_AccessDenied)
+	MOCK_EOS_RESULT_CASE(EOS_TooManyRequests)
+	MOCK_EOS_RESULT_CASE(EOS_AlreadyPending)
+	MOCK_EOS_RESULT_CASE(EOS_InvalidParameters)
+	MOCK_EOS_RESULT_CASE(EOS_InvalidRequest)
+	MOCK_EOS_RESULT_CASE(EOS_NotConfigured)
+	MOCK_EOS_RESULT_CASE(EOS_NotImplemented)
+	MOCK_EOS_RESULT_CASE(EOS_Canceled)
+	MOCK_EOS_RESULT_CASE(EOS_NotFound)
+	MOCK_EOS_RESULT_CASE(EOS_OperationWillRetry)
+	MOCK_EOS_RESULT_CASE(EOS_LimitExceeded)
+	MOCK_EOS_RESULT_CASE(EOS_TimedOut)
+	MOCK_EOS_RESULT_CASE(EOS_UnexpectedError)
+	default:
+		return "EOS_UnknownResult";
+	}
+
+#undef MOCK_EOS_RESULT_CASE
+}
+
+EOS_DECLARE_FUNC(EOS_Bool) EOS_EResult_IsOperationComplete(EOS_EResult Result)
+{
+	return Result == EOS_EResult::EOS_OperationWillRetry ? EOS_FALSE : EOS_TRUE;
+}
+
+EOS_DECLARE_FUNC(EOS_EResult) EOS_EpicAccountId_ToString(EOS_EpicAccountId AccountId, char* OutBuffer, int32_t* InOutBufferLength)
+{
+	if (AccountId == nullptr || OutBuffer == nullptr || InOutBufferLength == nullptr)
+		return EOS_EResult::EOS_InvalidParameters;
+
+	// The length includes the null terminator.
+	int32_t length = static_cast<int32_t>(strlen(AccountId->id)) + 1;
+	if (*InOutBufferLength < length)
+	{
+		*InOutBufferLength = length;
+		return EOS_EResult::EOS_LimitExceeded;
+	}
+
+	memcpy(OutBuffer, AccountId->id, length);
+	*InOutBufferLength = length;
+	return EOS_EResult::EOS_Success;
+}
+
+EOS_DECLARE_FUNC(EOS_EResult) EOS_Logging_SetCallback(EOS_LogMessageFunc Callback)
+{
+	std::lock_guard<std::mutex> lock(g_MockEOS.mutex);
+	g_MockEOS.logCallback = Callback;
+	return EOS_EResult::EOS_Success;
+}
+
+EOS_DECLARE_FUNC(EOS_EResult) EOS_Logging_SetLogLevel(EOS_ELogCategory LogCategory, EOS_ELogLevel LogLevel)
+{
+	std::lock_guard<std::mutex> lock(g_MockEOS.mutex);
+
+	if (LogCategory == EOS_ELogCategory::EOS_LC_ALL_CATEGORIES)
+	{
+		g_MockEOS.defaultLogLevel = LogLevel;
+		g_MockEOS.logLevels.clear();
+	}
+	else
+	{
+		g_MockEOS.logLevels[LogCategory] = LogLevel;
+	}
+
+	return EOS_EResult::EOS_Success;
+}
+
+//////////////////////////////////////////////////////
+// Platform
+EOS_DECLARE_FUNC(EOS_EResult) EOS_Initialize(const EOS_InitializeOptions* Options)
+{
+	return TakeBehavior(MockEOSCall::Initialize).result;
+}
+
+EOS_DECLARE_FUNC(EOS_EResult) EOS_Shutdown()
+{
+	std::lock_guard<std::mutex> lock(g_MockEOS.mutex);
+	g_MockEOS.pendingCallbacks.clear();
+	return EOS_EResult::EOS_Success;
+}
+
+EOS_DECLARE_FUNC(EOS_HPlatform) EOS_Platform_Create(const EOS_Platform_Options* Options)
+{
+	if (TakeBehavior(MockEOSCall::PlatformCreate).result != EOS_EResult::EOS_Success)
+		return nullptr;
+
+	return &g_MockPlatform;
+}
+
+EOS_DECLARE_FUNC(void) EOS_Platform_Release(EOS_HPlatform Handle)
+{
+	// Operations still in progress never complete.
+	std::lock_guard<std::mutex> lock(g_MockEOS.mutex);
+	g_MockEOS.pendingCallbacks.clear();
+}
+
+EOS_DECLARE_FUNC(void) EOS_Platform_Tick(EOS_HPlatform Handle)
+{
+	// Take every callback that is due first, so callbacks for calls made by these callbacks wait until the
+	// next tick, as with the real SDK.
+	std::vector<std::function<void()>> dueCallbacks;
+
+	{
+		std::lock_guard<std::mutex> lock(g_MockEOS.mutex);
+
+		auto now = std::chrono::steady_clock::now();
+		auto& pending = g_MockEOS.pendingCallbacks;
+		while (!pending.empty() && pending.begin()->first.first <= now)
+		{
+			dueCallbacks.push_back(std::move(pending.begin()->second));
+			pending.erase(pending.begin());
+		}
+	}
+
+	for (std::function<void()>& callback : dueCallbacks)
+		callback();
+}
+
+EOS_DECLARE_FUNC(EOS_HAuth) EOS_Platform_GetAuthInterface(EOS_HPlatform Handle)
+{
+	return Handle != nullptr ? &g_MockAuth : nullptr;
+}
+
+EOS_DECLARE_FUNC(EOS_HConnect) EOS_Platform_GetConnectInterface(EOS_HPlatform Handle)
+{
+	return Handle != nullptr ? &g_MockConnect : nullptr;
+}
+
+EOS_DECLARE_FUNC(EOS_HUserInfo) EOS_Platform_GetUserInfoInterface(EOS_HPlatform Handle)
+{
+	return Handle != nullptr ? &g_MockUserInfo : nullptr;
+}
+
+EOS_DECLARE_FUNC(EOS_HAchievements) EOS_Platform_GetAchievementsInterface(EOS_HPlatform Handle)
+{
+	return Handle != nullptr ? &g_MockAchievements : nullptr;
+}
+
+//////////////////////////////////////////////////////
+// Auth
+EOS_DECLARE_FUNC(void) EOS_Auth_Login(EOS_HAuth Handle, const EOS_Auth_LoginOptions* Options, void* ClientData, const EOS_Auth_OnLoginCallback CompletionDelegate)
+{
+	MockEOSBehavior behavior = TakeBehavior(MockEOSCall::AuthLogin);
+
+	AddPendingCallback(behavior.latency, [=]()
+	{
+		EOS_Auth_LoginCallbackInfo info = {};
+		info.ResultCode = behavior.result;
+		info.ClientData = ClientData;
+
+		if (behavior.result == EOS_EResult::EOS_Success)
+			info.LocalUserId = &g_MockEpicAccountId;
+
+		LogCompletion(EOS_ELogCategory::EOS_LC_Auth, "LogEOSAuth", "EOS_Auth_Login", behavior.result);
+		CompletionDelegate(&info);
+
+		if (behavior.result == EOS_EResult::EOS_Success)
+			SetLoginStatus(EOS_ELoginStatus::EOS_LS_LoggedIn);
+	});
+}
+
+EOS_DECLARE_FUNC(void) EOS_Auth_Logout(EOS_HAuth Handle, const EOS_Auth_LogoutOptions* Options, void* ClientData, const EOS_Auth_OnLogoutCallback CompletionDelegate)
+{
+	MockEOSBehavior behavior = TakeBehavior(MockEOSCall::AuthLogout);
+	EOS_EpicAccountId localUserId = Options->LocalUserId;
+
+	AddPendingCallback(behavior.latency, [=]()
+	{
+		EOS_Auth_LogoutCallbackInfo info = {};
+		info.ResultCode = behavior.result;
+		info.ClientData = ClientData;
+		info.LocalUserId = localUserId;
+
+		LogCompletion(EOS_ELogCategory::EOS_LC_Auth, "LogEOSAuth", "EOS_Auth_Logout", behavior.result);
+		CompletionDelegate(&info);
+
+		if (behavior.result == EOS_EResult::EOS_Success)
+			SetLoginStatus(EOS_ELoginStatus::EOS_LS_NotLoggedIn);
+	});
+}
+
+EOS_DECLARE_FUNC(void) EOS_Auth_DeletePersistentAuth(EOS_HAuth Handle, const EOS_Auth_DeletePersistentAuthOptions* Options, void* ClientData, const EOS_Auth_OnDeletePersistentAuthCallback CompletionDelegate)
+{
+	MockEOSBehavior behavior = TakeBehavior(MockEOSCall::AuthDeletePersistentAuth);
+
+	AddPendingCallback(behavior.latency, [=]()
+	{
+		EOS_Auth_DeletePersistentAuthCallbackInfo info = {};
+		info.ResultCode = behavior.result;
+		info.ClientData = ClientData;
+
+		LogCompletion(EOS_ELogCategory::EOS_LC_Auth, "LogEOSAuth", "EOS_Auth_DeletePersistentAuth", behavior.result);
+		CompletionDelegate(&info);
+	});
+}
+
+EOS_DECLARE_FUNC(EOS_NotificationId) EOS_Auth_AddNotifyLoginStatusChanged(EOS_HAuth Handle, const EOS_Auth_AddNotifyLoginStatusChangedOptions* Options, void* ClientData, const EOS_Auth_OnLoginStatusChangedCallback Notification)
+{
+	// Only one notification is supported, which is all the extension uses.
+	std::lock_guard<std::mutex> lock(g_MockEOS.mutex);
+	g_MockEOS.loginStatusCallback = Notification;
+	g_MockEOS.loginStatusClientData = ClientData;
+	return 1;
+}
+
+EOS_DECLARE_FUNC(EOS_EResult) EOS_Auth_CopyIdToken(EOS_HAuth Handle, const EOS_Auth_CopyIdTokenOptions* Options, EOS_Auth_IdToken** OutIdToken)
+{
+	EOS_EResult result = TakeBehavior(MockEOSCall::AuthCopyIdToken).result;
+	if (result != EOS_EResult::EOS_Success)
+		return result;
+
+	EOS_Auth_IdToken* idToken = new EOS_Auth_IdToken();
+	idToken->AccountId = Options->AccountId;
+	idToken->JsonWebToken = "mock.id.token";
+	*OutIdToken = idToken;
+	return EOS_EResult::EOS_Success;
+}
+
+EOS_DECLARE_FUNC(void) EOS_Auth_IdToken_Release(EOS_Auth_IdToken* IdToken)
+{
+	delete IdToken;
+}
+
+//////////////////////////////////////////////////////
+// User info
+EOS_DECLARE_FUNC(EOS_EResult) EOS_UserInfo_CopyUserInfo(EOS_HUserInfo Handle, const EOS_UserInfo_CopyUserInfoOptions* Options, EOS_UserInfo** OutUserInfo)
+{
+	EOS_EResult result = TakeBehavior(MockEOSCall::UserInfoCopyUserInfo).result;
+	if (result != EOS_EResult::EOS_Success)
+		return result;
+
+	EOS_UserInfo* userInfo = new EOS_UserInfo();
+	userInfo->UserId = Options->TargetUserId;
+	userInfo->Country = "GB";
+	userInfo->DisplayName = "Mock User";
+	userInfo->PreferredLanguage = "en";
+	userInfo->Nickname = nullptr;
+	userInfo->DisplayNameSanitized = "Mock User";
+	*OutUserInfo = userInfo;
+	return EOS_EResult::EOS_Success;
+}
+
+EOS_DECLARE_FUNC(void) EOS_UserInfo_Release(EOS_UserInfo* UserInfo)
+{
+	delete UserInfo;
+}
+
+//////////////////////////////////////////////////////
+// Connect
+EOS_DECLARE_FUNC(void) EOS_Connect_Login(EOS_HConnect Handle, const EOS_Connect_LoginOptions* Options, void* ClientData, const EOS_Connect_OnLoginCallback CompletionDelegate)
+{
+	MockEOSBehavior behavior = TakeBehavior(MockEOSCall::ConnectLogin);
+
+	AddPendingCallback(behavior.latency, [=]()
+	{
+		EOS_Connect_LoginCallbackInfo info = {};
+		info.ResultCode = behavior.result;
+		info.ClientData = ClientData;
+
+		if (behavior.result == EOS_EResult::EOS_Success)
+		{
+			bool hasProductUser;
+			{
+				std::lock_guard<std::mutex> lock(g_MockEOS.mutex);
+				hasProductUser = g_MockEOS.hasProductUser;
+			}
+
+			// Until a product user is created, the backend asks for one to be created with a continuance token.
+			if (hasProductUser)
+			{
+				info.LocalUserId = &g_MockProductUserId;
+			}
+			else
+			{
+				info.ResultCode = EOS_EResult::EOS_InvalidUser;
+				info.ContinuanceToken = &g_MockContinuanceToken;
+			}
+		}
+
+		LogCompletion(EOS_ELogCategory::EOS_LC_Connect, "LogEOSConnect", "EOS_Connect_Login", info.ResultCode);
+		CompletionDelegate(&info);
+	});
+}
+
+EOS_DECLARE_FUNC(void) EOS_Connect_CreateUser(EOS_HConnect Handle, const EOS_Connect_CreateUserOptions* Options, void* ClientData, const EOS_Connect_OnCreateUserCallback CompletionDelegate)
+{
+	MockEOSBehavior behavior = TakeBehavior(MockEOSCall::ConnectCreateUser);
+
+	AddPendingCallback(behavior.latency, [=]()
+	{
+		EOS_Connect_CreateUserCallbackInfo info = {};
+		info.ResultCode = behavior.result;
+		info.ClientData = ClientData;
+
+		if (behavior.result == EOS_EResult::EOS_Success)
+		{
+			std::lock_guard<std::mutex> lock(g_MockEOS.mutex);
+			g_MockEOS.hasProductUser = true;
+			info.LocalUserId = &g_MockProductUserId;
+		}
+
+		LogCompletion(EOS_ELogCategory::EOS_LC_Connect, "LogEOSConnect", "EOS_Connect_CreateUser", behavior.result);
+		CompletionDelegate(&info);
+	});
+}
+
+EOS_DECLARE_FUNC(EOS_NotificationId) EOS_Connect_AddNotifyAuthExpiration(EOS_HConnect Handle, const EOS_Connect_AddNotifyAuthExpirationOptions* Options, void* ClientData, const EOS_Connect_OnAuthExpirationCallback Notification)
+{
+	// Mock logins never expire, so the notification is never sent.
+	return 2;
+}
+
+//////////////////////////////////////////////////////
+// Achievements
+EOS_DECLARE_FUNC(void) EOS_Achievements_UnlockAchievements(EOS_HAchievements Handle, const EOS_Achievements_UnlockAchievementsOptions* Options, void* ClientData, const EOS_Achievements_OnUnlockAchievementsCompleteCallback CompletionDelegate)
+{
+	MockEOSBehavior behavior = TakeBehavior(MockEOSCall::AchievementsUnlock);
+	EOS_ProductUserId userId = Options->UserId;
+	std::vector<std::string> achievementIds(Options->AchievementIds, Options->AchievementIds + Options->AchievementsCount);
+
+	AddPendingCallback(behavior.latency, [=]()
+	{
+		EOS_Achievements_OnUnlockAchievementsCompleteCallbackInfo info = {};
+		info.ResultCode = behavior.result;
+		info.ClientData = ClientData;
+		info.UserId = userId;
+		info.AchievementsCount = static_cast<uint32_t>(achievementIds.size());
+
+		if (behavior.result == EOS_EResult::EOS_Success)
+		{
+			std::lock_guard<std::mutex> lock(g_MockEOS.mutex);
+
+			// Once definitions are set, unlocking an achievement without one fails, as it would on the backend.
+			const std::vector<std::string>& definitions = g_MockEOS.achievementDefinitions;
+			for (const std::string& achievementId : achievementIds)
+			{
+				if (!definitions.empty() && std::find(definitions.begin(), definitions.end(), achievementId) == definitions.end())
+					info.ResultCode = EOS_EResult::EOS_NotFound;
+			}
+
+			if (info.ResultCode == EOS_EResult::EOS_Success)
+			{
+				int64_t now = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+
+				std::vector<std::pair<std::string, int64_t>>& unlocked = g_MockEOS.unlockedAchievements;
+				for (const std::string& achievementId : achievementIds)
+				{
+					if (std::find_if(unlocked.begin(), unlocked.end(), [&](const auto& u) { return u.first == achievementId; }) == unlocked.end())
+						unlocked.emplace_back(achievementId, now);
+				}
+			}
+		}
+
+		LogCompletion(EOS_ELogCategory::EOS_LC_Achievements, "LogEOSAchievements", "EOS_Achievements_UnlockAchievements", info.ResultCode);
+		CompletionDelegate(&info);
+	});
+}
+
+EOS_DECLARE_FUNC(void) EOS_Achievements_QueryDefinitions(EOS_HAchievements Handle, const EOS_Achievements_QueryDefinitionsOptions* Options, void* ClientData, const EOS_Achievements_OnQueryDefinitionsCompleteCallback CompletionDelegate)
+{
+	MockEOSBehavior behavior = TakeBehavior(MockEOSCall::AchievementsQueryDefinitions);
+
+	AddPendingCallback(behavior.latency, [=]()
+	{
+		EOS_Achievements_OnQueryDefinitionsCompleteCallbackInfo info = {};
+		info.ResultCode = behavior.result;
+		info.ClientData = ClientData;
+
+		if (behavior.result == EOS_EResult::EOS_Success)
+		{
+			std::lock_guard<std::mutex> lock(g_MockEOS.mutex);
+			g_MockEOS.queriedDefinitions = g_MockEOS.achievementDefinitions;
+		}
+
+		LogCompletion(EOS_ELogCategory::EOS_LC_Achievements, "LogEOSAchievements", "EOS_Achievements_QueryDefinitions", behavior.result);
+		CompletionDelegate(&info);
+	});
+}
+
+EOS_DECLARE_FUNC(uint32_t) EOS_Achievements_GetAchievementDefinitionCount(EOS_HAchievements Handle, const EOS_Achievements_GetAchievementDefinitionCountOptions* Options)
+{
+	std::lock_guard<std::mutex> lock(g_MockEOS.mutex);
+	return static_cast<uint32_t>(g_MockEOS.queriedDefinitions.size());
+}
+
+EOS_DECLARE_FUNC(EOS_EResult) EOS_Achievements_CopyAchievementDefinitionV2ByIndex(EOS_HAchievements Handle, const EOS_Achievements_CopyAchievementDefinitionV2ByIndexOptions* Options, EOS_Achievements_DefinitionV2** OutDefinition)
+{
+	std::lock_guard<std::mutex> lock(g_MockEOS.mutex);
+
+	if (Options->AchievementIndex >= g_MockEOS.queriedDefinitions.size())
+		return EOS_EResult::EOS_NotFound;
+
+	EOS_Achievements_DefinitionV2* definition = new EOS_Achievements_DefinitionV2();
+	definition->AchievementId = CopyString(g_MockEOS.queriedDefinitions[Options->AchievementIndex]);
+	*OutDefinition = definition;
+	return EOS_EResult::EOS_Success;
+}
+
+EOS_DECLARE_FUNC(void) EOS_Achievements_DefinitionV2_Release(EOS_Achievements_DefinitionV2* AchievementDefinition)
+{
+	delete[] AchievementDefinition->AchievementId;
+	delete AchievementDefinition;
+}
+
+EOS_DECLARE_FUNC(void) EOS_Achievements_QueryPlayerAchievements(EOS_HAchievements Handle, const EOS_Achievements_QueryPlayerAchievementsOptions* Options, void* ClientData, const EOS_Achievements_OnQueryPlayerAchievementsCompleteCallback CompletionDelegate)
+{
+	MockEOSBehavior behavior = TakeBehavior(MockEOSCall::AchievementsQueryPlayer);
+	EOS_ProductUserId targetUserId = Options->TargetUserId;
+
+	AddPendingCallback(behavior.latency, [=]()
+	{
+		EOS_Achievements_OnQueryPlayerAchievementsCompleteCallbackInfo info = {};
+		info.ResultCode = behavior.result;
+		info.ClientData = ClientData;
+		info.UserId = targetUserId;
+
+		if (behavior.result == EOS_EResult::EOS_Success)
+		{
+			std::lock_guard<std::mutex> lock(g_MockEOS.mutex);
+
+			// The player has an entry for every definition, plus any unlocked achievements without one.
+			std::vector<MockPlayerAchievementState>& queried = g_MockEOS.queriedPlayerAchievements;
+			queried.clear();
+
+			for (const std::string& achievementId : g_MockEOS.achievementDefinitions)
+				queried.push_back({ achievementId, 0.0, EOS_ACHIEVEMENTS_ACHIEVEMENT_UNLOCKTIME_UNDEFINED });
+
+			for (const auto& unlocked : g_MockEOS.unlockedAchievements)
+			{
+				auto i = std::find_if(queried.begin(), queried.end(), [&](const MockPlayerAchievementState& a) { return a.achievementId == unlocked.first; });
+				if (i == queried.end())
+					queried.push_back({ unlocked.first, 1.0, unlocked.second });
+				else
+				{
+					i->progress = 1.0;
+					i->unlockTime = unlocked.second;
+				}
+			}
+		}
+
+		LogCompletion(EOS_ELogCategory::EOS_LC_Achievements, "LogEOSAchievements", "EOS_Achievements_QueryPlayerAchievements", behavior.result);
+		CompletionDelegate(&info);
+	});
+}
+
+EOS_DECLARE_FUNC(uint32_t) EOS_Achievements_GetPlayerAchievementCount(EOS_HAchievements Handle, const EOS_Achievements_GetPlayerAchievementCountOptions* Options)
+{
+	std::lock_guard<std::mutex> lock(g_MockEOS.mutex);
+	return static_cast<uint32_t>(g_MockEOS.queriedPlayerAchievements.size());
+}
+
+EOS_DECLARE_FUNC(EOS_EResult) EOS_Achievements_CopyPlayerAchievementByIndex(EOS_HAchievements Handle, const EOS_Achievements_CopyPlayerAchievementByIndexOptions* Options, EOS_Achievements_PlayerAchievement** OutAchievement)
+{
+	std::lock_guard<std::mutex> lock(g_MockEOS.mutex);
+
+	if (Options->AchievementIndex >= g_MockEOS.queriedPlayerAchievements.size())
+		return EOS_EResult::EOS_NotFound;
+
+	const MockPlayerAchievementState& state = g_MockEOS.queriedPlayerAchievements[Options->AchievementIndex];
+
+	EOS_Achievements_PlayerAchievement* achievement = new EOS_Achievements_PlayerAchievement();
+	achievement->AchievementId = CopyString(state.achievementId);
+	achievement->Progress = state.progress;
+	achievement->UnlockTime = state.unlockTime;
+	*OutAchievement = achievement;
+	return EOS_EResult::EOS_Success;
+}
+
+EOS_DECLARE_FUNC(void) EOS_Achievements_PlayerAchievement_Release(EOS_Achievements_PlayerAchievement* Achievement)
+{
+	delete[] Achievement->AchievementId;
+	delete Achievement;
+}
+
+#endif
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <chrono>
+
+// A stand-in for the EOS SDK, for running the extension without Epic's backend, e.g. for load tests on Linux.
+// This is only compiled in when EPICEXT_MOCK_EOS is defined (see framework.h), in which case MockEOS.cpp
+// defines every EOS function the extension uses and the EOS SDK library is not linked. The SDK headers are
+// still needed.
+// Like the real SDK, async calls complete from a later EOS_Platform_Tick() call. Each kind of call waits for a
+// scripted delay and then completes with a scripted result, so tests can inject latency and failures. Callbacks
+// that become due in the same tick are delivered in the order the calls were made.
+// The mock backend has a single user, who starts with no product user ID (so the first connect login has to
+// create one) and no unlocked achievements.
+#ifdef EPICEXT_MOCK_EOS
+
+// The EOS calls whose behavior can be scripted. The latency only applies to async calls.
+enum class MockEOSCall {
+	Initialize,
+	PlatformCreate,
+	AuthLogin,
+	AuthLogout,
+	AuthDeletePersistentAuth,
+	AuthCopyIdToken,
+	UserInfoCopyUserInfo,
+	ConnectLogin,
+	ConnectCreateUser,
+	AchievementsUnlock,
+	AchievementsQueryDefinitions,
+	AchievementsQueryPlayer,
+
+	Count
+};
+
+// The delay and result for a call. A result of EOS_Success means the call succeeds as the backend would, so
+// e.g. connect login still returns EOS_InvalidUser if no product user has been created yet.
+// If latencyJitter is set, a random extra delay of up to that much is added to each call, so callbacks for
+// overlapping calls can complete in a different order to the one the calls were made in.
+struct MockEOSBehavior {
+	std::chrono::milliseconds latency;
+	EOS_EResult result;
+	std::chrono::milliseconds latencyJitter = std::chrono::milliseconds(0);
+};
+
+// Set the behavior for every call of the given kind, after any queued behaviors are used up.
+// By default every call succeeds with no delay, completing on the next tick.
+void MockEOSSetBehavior(MockEOSCall call, MockEOSBehavior behavior);
+
+// Queue a behavior for a single call of the given kind. Queued behaviors are used in the order they are queued.
+void MockEOSQueueBehavior(MockEOSCall call, MockEOSBehavior behavior);
+
+// Set whether the user already has a product user ID, so connect login succeeds without creating one.
+void MockEOSSetHasProductUser(bool hasProductUser);
+
+// Set the achievement IDs the backend has definitions for.
+void MockEOSSetAchievementDefinitions(std::vector<std::string> achievementIds);
+
+// The achievement IDs the user has unlocked, in the order they were unlocked.
+std::vector<std::string> MockEOSGetUnlockedAchievements();
+
+// Seed the random numbers used for latency jitter, so a run can be repeated.
+void MockEOSSeedRandom(uint32_t seed);
+
+// The number of calls of the given kind made since the last reset.
+uint64_t MockEOSGetCallCount(MockEOSCall call);
+
+// The number of callbacks waiting to be delivered by EOS_Platform_Tick().
+size_t MockEOSGetPendingCallbackCount();
+
+// Restore the initial state: default behaviors, no definitions, no pending callbacks and a new user. Log and
+// notification callbacks registered by the extension are kept.
+void MockEOSReset();
+
+#endif
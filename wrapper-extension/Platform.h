@@ -0,0 +1,106 @@
+#pragma once
+
+// The platform layer: everything the extension needs from the OS, so the rest of the code is portable and
+// only this header and its implementations depend on Windows. PlatformWin32.cpp implements it for the
+// Windows DLL, and PlatformPosix.cpp for building the same code on Linux, e.g. for running benchmarks and
+// sanitizers. All strings are UTF-8.
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+	#define WIN32_LEAN_AND_MEAN             // Exclude rarely-used stuff from Windows headers
+	#include <windows.h>
+#else
+	// Windows types used by the wrapper extension SDK interface (see IExtension.h and IApplication.h).
+	typedef const char* LPCSTR;
+	typedef void* HWND;
+
+	#define DECLSPEC_NOVTABLE
+#endif
+
+// For joining paths, as a string literal.
+#ifdef _WIN32
+	#define PLATFORM_PATH_SEPARATOR "\\"
+#else
+	#define PLATFORM_PATH_SEPARATOR "/"
+#endif
+
+// Write a message to the debugger output (OutputDebugString() on Windows, stderr elsewhere).
+void PlatformDebugOutput(const std::string& message);
+
+// The process command line, as a single string for logging, and split in to arguments.
+std::string PlatformGetCommandLine();
+std::vector<std::string> PlatformGetCommandLineArgs();
+
+// A numeric ID for the calling thread, as shown by debuggers and profilers.
+uint32_t PlatformGetThreadId();
+
+// Read the whole of a file. Returns false if it does not exist or could not be read.
+bool PlatformReadFile(const std::string& path, std::string& content);
+
+// Rename a file, replacing any existing file at the new path. This is atomic, so after a crash there is either
+// the old or the new file at the new path.
+bool PlatformMoveFile(const std::string& fromPath, const std::string& toPath);
+
+bool PlatformDeleteFile(const std::string& path);
+
+#ifdef _WIN32
+// Conversion between UTF-8 and the UTF-16 strings used by Windows APIs.
+std::wstring Utf8ToWide(const std::string& utf8string);
+std::string WideToUtf8(const std::wstring& widestring);
+#endif
+
+// A file opened for writing, which is closed when destroyed.
+class PlatformFile {
+public:
+	enum class Mode {
+		Create,			// create the file, replacing any existing file
+		Append			// open or create the file, writing to the end
+	};
+
+	PlatformFile();
+	~PlatformFile();
+
+	PlatformFile(const PlatformFile&) = delete;
+	PlatformFile& operator=(const PlatformFile&) = delete;
+
+	bool Open(const std::string& path, Mode mode);
+	void Close();
+
+	bool IsOpen() const;
+
+	bool Write(const void* data, size_t size);
+
+	// Flush written data through to the disk, so it is not lost if the system crashes.
+	bool Flush();
+
+protected:
+	intptr_t handle;		// HANDLE on Windows or file descriptor elsewhere, -1 if not open
+};
+
+// A file of a fixed size mapped in to memory for reading and writing, which is closed when destroyed. The
+// mapped pages belong to the OS, so whatever is written is saved to the file even if the process crashes.
+class PlatformMappedFile {
+public:
+	PlatformMappedFile();
+	~PlatformMappedFile();
+
+	PlatformMappedFile(const PlatformMappedFile&) = delete;
+	PlatformMappedFile& operator=(const PlatformMappedFile&) = delete;
+
+	// Create the file at the given size, replacing any existing file, and map it. It starts zero-filled.
+	bool Open(const std::string& path, size_t size_);
+	void Close();
+
+	bool IsOpen() const;
+
+	uint8_t* GetData() const;
+
+protected:
+	intptr_t fileHandle;		// as for PlatformFile
+	intptr_t mappingHandle;		// file mapping object HANDLE on Windows, unused elsewhere
+	uint8_t* data;
+	size_t size;
+};
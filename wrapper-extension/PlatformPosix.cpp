@@ -0,0 +1,242 @@
+
+#include "pch.h"
+#include "Platform.h"
+
+#ifndef _WIN32
+
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+#ifdef __linux__
+	#include <sys/syscall.h>
+#endif
+
+void PlatformDebugOutput(const std::string& message)
+{
+	fputs(message.c_str(), stderr);
+}
+
+std::vector<std::string> PlatformGetCommandLineArgs()
+{
+	std::vector<std::string> ret;
+
+	// On Linux the arguments are available as null-separated strings. Other systems have no portable way
+	// to get them outside of main(), so have none.
+	std::string cmdline;
+	if (PlatformReadFile("/proc/self/cmdline", cmdline))
+	{
+		size_t start = 0;
+		while (start < cmdline.size())
+		{
+			size_t end = cmdline.find('\0', start);
+			if (end == std::string::npos)
+				end = cmdline.size();
+
+			ret.push_back(cmdline.substr(start, end - start));
+			start = end + 1;
+		}
+	}
+
+	return ret;
+}
+
+std::string PlatformGetCommandLine()
+{
+	std::string ret;
+	for (const std::string& arg : PlatformGetCommandLineArgs())
+	{
+		if (!ret.empty())
+			ret += ' ';
+
+		ret += arg;
+	}
+
+	return ret;
+}
+
+uint32_t PlatformGetThreadId()
+{
+#ifdef __linux__
+	return static_cast<uint32_t>(syscall(SYS_gettid));
+#else
+	return static_cast<uint32_t>(std::hash<std::thread::id>()(std::this_thread::get_id()));
+#endif
+}
+
+bool PlatformReadFile(const std::string& path, std::string& content)
+{
+	int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+		return false;
+
+	// Read until the end rather than relying on the file size, as files in /proc report a size of 0.
+	content.clear();
+
+	char buffer[4096];
+	bool isOk = true;
+	while (true)
+	{
+		ssize_t bytesRead = read(fd, buffer, sizeof(buffer));
+		if (bytesRead < 0)
+		{
+			isOk = false;
+			break;
+		}
+
+		if (bytesRead == 0)
+			break;
+
+		content.append(buffer, static_cast<size_t>(bytesRead));
+	}
+
+	close(fd);
+	return isOk;
+}
+
+bool PlatformMoveFile(const std::string& fromPath, const std::string& toPath)
+{
+	return rename(fromPath.c_str(), toPath.c_str()) == 0;
+}
+
+bool PlatformDeleteFile(const std::string& path)
+{
+	return unlink(path.c_str()) == 0;
+}
+
+//////////////////////////////////////////////////////
+// PlatformFile
+PlatformFile::PlatformFile()
+	: handle(-1)
+{
+}
+
+PlatformFile::~PlatformFile()
+{
+	Close();
+}
+
+bool PlatformFile::Open(const std::string& path, Mode mode)
+{
+	Close();
+
+	int flags = O_WRONLY | O_CREAT | O_CLOEXEC | (mode == Mode::Create ? O_TRUNC : O_APPEND);
+	handle = open(path.c_str(), flags, 0644);
+
+	return IsOpen();
+}
+
+void PlatformFile::Close()
+{
+	if (IsOpen())
+	{
+		close(static_cast<int>(handle));
+		handle = -1;
+	}
+}
+
+bool PlatformFile::IsOpen() const
+{
+	return handle >= 0;
+}
+
+bool PlatformFile::Write(const void* data, size_t size)
+{
+	if (!IsOpen())
+		return false;
+
+	const uint8_t* p = static_cast<const uint8_t*>(data);
+	while (size > 0)
+	{
+		ssize_t written = write(static_cast<int>(handle), p, size);
+		if (written <= 0)
+			return false;
+
+		p += written;
+		size -= static_cast<size_t>(written);
+	}
+
+	return true;
+}
+
+bool PlatformFile::Flush()
+{
+	return IsOpen() && fsync(static_cast<int>(handle)) == 0;
+}
+
+//////////////////////////////////////////////////////
+// PlatformMappedFile
+PlatformMappedFile::PlatformMappedFile()
+	: fileHandle(-1),
+	  mappingHandle(0),
+	  data(nullptr),
+	  size(0)
+{
+}
+
+PlatformMappedFile::~PlatformMappedFile()
+{
+	Close();
+}
+
+bool PlatformMappedFile::Open(const std::string& path, size_t size_)
+{
+	Close();
+
+	int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+	if (fd < 0)
+		return false;
+
+	fileHandle = fd;
+
+	// Extending the file fills it with zeroes.
+	if (ftruncate(fd, static_cast<off_t>(size_)) != 0)
+	{
+		Close();
+		return false;
+	}
+
+	void* ptr = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (ptr == MAP_FAILED)
+	{
+		Close();
+		return false;
+	}
+
+	data = static_cast<uint8_t*>(ptr);
+	size = size_;
+	return true;
+}
+
+void PlatformMappedFile::Close()
+{
+	if (data != nullptr)
+	{
+		// Like FlushViewOfFile(), start writing out the pages without waiting for them.
+		msync(data, size, MS_ASYNC);
+		munmap(data, size);
+		data = nullptr;
+		size = 0;
+	}
+
+	if (fileHandle >= 0)
+	{
+		close(static_cast<int>(fileHandle));
+		fileHandle = -1;
+	}
+}
+
+bool PlatformMappedFile::IsOpen() const
+{
+	return data != nullptr;
+}
+
+uint8_t* PlatformMappedFile::GetData() const
+{
+	return data;
+}
+
+#endif
@@ -0,0 +1,260 @@
+
+#include "pch.h"
+#include "Platform.h"
+
+#ifdef _WIN32
+
+#include <shellapi.h>					// CommandLineToArgv
+
+std::wstring Utf8ToWide(const std::string& utf8string)
+{
+	// Empty strings are equivalent
+	if (utf8string.empty())
+		return std::wstring();
+
+	// Request number of wchars needed to fit this string (note some arguments are int instead of size_t)
+	int wcharcount = MultiByteToWideChar(CP_UTF8, 0, utf8string.data(), (int)utf8string.size(), NULL, 0);
+
+	// Conversion failed or still empty: return empty string
+	if (wcharcount <= 0)
+		return std::wstring();
+
+	// Create a string to return and allocate memory for the content
+	std::wstring buffer;
+	buffer.resize(wcharcount);
+
+	// Do the conversion
+	MultiByteToWideChar(CP_UTF8, 0, utf8string.data(), (int)utf8string.size(), &(buffer.front()), wcharcount);
+
+	// Return converted string
+	return buffer;
+}
+
+std::string WideToUtf8(const std::wstring& widestring)
+{
+	// Empty strings are equivalent
+	if (widestring.empty())
+		return std::string();
+
+	// Calculate bytes required for output buffer (note some arguments are int instead of size_t)
+	int bytecount = WideCharToMultiByte(CP_UTF8, 0, widestring.data(), (int)widestring.size(), NULL, 0, NULL, NULL);
+
+	// Conversion failed or still empty: return empty string
+	if (bytecount <= 0)
+		return std::string();
+
+	// Create a string to return and allocate memory for the content
+	std::string buffer;
+	buffer.resize(bytecount);
+
+	// Do the conversion
+	WideCharToMultiByte(CP_UTF8, 0, widestring.data(), (int)widestring.size(), &(buffer.front()), bytecount, NULL, NULL);
+
+	// Return converted string
+	return buffer;
+}
+
+static HANDLE ToHandle(intptr_t handle)
+{
+	return reinterpret_cast<HANDLE>(handle);
+}
+
+static intptr_t FromHandle(HANDLE handle)
+{
+	return reinterpret_cast<intptr_t>(handle);
+}
+
+void PlatformDebugOutput(const std::string& message)
+{
+	std::wstring messageW = Utf8ToWide(message);
+	OutputDebugStringW(messageW.c_str());
+}
+
+std::string PlatformGetCommandLine()
+{
+	return WideToUtf8(GetCommandLineW());
+}
+
+std::vector<std::string> PlatformGetCommandLineArgs()
+{
+	std::vector<std::string> ret;
+
+	// Use CommandLineToArgvW() to parse the command line for us
+	int argc = 0;
+	LPWSTR* argv = CommandLineToArgvW(GetCommandLineW(), &argc);
+	if (argv != nullptr)
+	{
+		for (int i = 0; i < argc; ++i)
+			ret.push_back(WideToUtf8(argv[i]));
+
+		LocalFree(argv);
+	}
+
+	return ret;
+}
+
+uint32_t PlatformGetThreadId()
+{
+	return GetCurrentThreadId();
+}
+
+bool PlatformReadFile(const std::string& path, std::string& content)
+{
+	HANDLE hFile = CreateFileW(Utf8ToWide(path).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (hFile == INVALID_HANDLE_VALUE)
+		return false;
+
+	content.clear();
+
+	bool isOk = true;
+	LARGE_INTEGER fileSize = {};
+	if (GetFileSizeEx(hFile, &fileSize) && fileSize.QuadPart > 0)
+	{
+		content.resize(static_cast<size_t>(fileSize.QuadPart));
+		DWORD bytesRead = 0;
+		isOk = ReadFile(hFile, &content.front(), static_cast<DWORD>(content.size()), &bytesRead, nullptr);
+		content.resize(bytesRead);
+	}
+
+	CloseHandle(hFile);
+	return isOk;
+}
+
+bool PlatformMoveFile(const std::string& fromPath, const std::string& toPath)
+{
+	return MoveFileExW(Utf8ToWide(fromPath).c_str(), Utf8ToWide(toPath).c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH);
+}
+
+bool PlatformDeleteFile(const std::string& path)
+{
+	return DeleteFileW(Utf8ToWide(path).c_str());
+}
+
+//////////////////////////////////////////////////////
+// PlatformFile
+PlatformFile::PlatformFile()
+	: handle(FromHandle(INVALID_HANDLE_VALUE))
+{
+}
+
+PlatformFile::~PlatformFile()
+{
+	Close();
+}
+
+bool PlatformFile::Open(const std::string& path, Mode mode)
+{
+	Close();
+
+	// Other processes can read the file while it is open, e.g. to inspect the achievement journal.
+	if (mode == Mode::Create)
+		handle = FromHandle(CreateFileW(Utf8ToWide(path).c_str(), GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr));
+	else
+		handle = FromHandle(CreateFileW(Utf8ToWide(path).c_str(), FILE_APPEND_DATA, FILE_SHARE_READ, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr));
+
+	return IsOpen();
+}
+
+void PlatformFile::Close()
+{
+	if (IsOpen())
+	{
+		CloseHandle(ToHandle(handle));
+		handle = FromHandle(INVALID_HANDLE_VALUE);
+	}
+}
+
+bool PlatformFile::IsOpen() const
+{
+	return ToHandle(handle) != INVALID_HANDLE_VALUE;
+}
+
+bool PlatformFile::Write(const void* data, size_t size)
+{
+	DWORD written = 0;
+	return IsOpen() && WriteFile(ToHandle(handle), data, static_cast<DWORD>(size), &written, nullptr) && written == size;
+}
+
+bool PlatformFile::Flush()
+{
+	return IsOpen() && FlushFileBuffers(ToHandle(handle));
+}
+
+//////////////////////////////////////////////////////
+// PlatformMappedFile
+PlatformMappedFile::PlatformMappedFile()
+	: fileHandle(FromHandle(INVALID_HANDLE_VALUE)),
+	  mappingHandle(0),
+	  data(nullptr),
+	  size(0)
+{
+}
+
+PlatformMappedFile::~PlatformMappedFile()
+{
+	Close();
+}
+
+bool PlatformMappedFile::Open(const std::string& path, size_t size_)
+{
+	Close();
+
+	HANDLE hFile = CreateFileW(Utf8ToWide(path).c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (hFile == INVALID_HANDLE_VALUE)
+		return false;
+
+	fileHandle = FromHandle(hFile);
+
+	// Mapping the file at its full size extends it with zeroes.
+	uint64_t size64 = size_;
+	HANDLE hMapping = CreateFileMappingW(hFile, nullptr, PAGE_READWRITE, static_cast<DWORD>(size64 >> 32), static_cast<DWORD>(size64), nullptr);
+	if (hMapping != NULL)
+	{
+		mappingHandle = FromHandle(hMapping);
+		data = static_cast<uint8_t*>(MapViewOfFile(hMapping, FILE_MAP_ALL_ACCESS, 0, 0, size_));
+	}
+
+	if (data == nullptr)
+	{
+		Close();
+		return false;
+	}
+
+	size = size_;
+	return true;
+}
+
+void PlatformMappedFile::Close()
+{
+	if (data != nullptr)
+	{
+		FlushViewOfFile(data, 0);
+		UnmapViewOfFile(data);
+		data = nullptr;
+		size = 0;
+	}
+
+	if (mappingHandle != 0)
+	{
+		CloseHandle(ToHandle(mappingHandle));
+		mappingHandle = 0;
+	}
+
+	if (ToHandle(fileHandle) != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(ToHandle(fileHandle));
+		fileHandle = FromHandle(INVALID_HANDLE_VALUE);
+	}
+}
+
+bool PlatformMappedFile::IsOpen() const
+{
+	return data != nullptr;
+}
+
+uint8_t* PlatformMappedFile::GetData() const
+{
+	return data;
+}
+
+#endif
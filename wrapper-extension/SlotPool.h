@@ -0,0 +1,196 @@
+#pragma once
+
+#include <memory>
+#include <stdint.h>
+
+// A pool of objects allocated in fixed-size slabs, for contexts passed through the EOS SDK as ClientData.
+// Each object is addressed by a handle combining its slot index and a generation number, rather than by
+// pointer. The generation is bumped every time a slot is released, so a handle for a released slot (e.g.
+// from a callback arriving after shutdown) is recognized as stale and safely rejected instead of
+// dangling. Acquire and release are O(1) using a free list, and slabs are never freed or moved, so
+// pointers to objects stay valid while their slot is in use.
+// Handles are packed in to a void* to pass as ClientData, with the low INDEX_BITS holding the index and
+// the remaining bits the generation. The generation is never 0, so a handle is never nullptr.
+template<typename T>
+class SlotPool {
+public:
+	static const uint32_t SLAB_SIZE = 64;
+	static const uint32_t INDEX_BITS = 16;
+	static const uint32_t MAX_SLOTS = 1u << INDEX_BITS;
+
+	SlotPool()
+		: freeListHead(NO_SLOT),
+		  inUseCount(0),
+		  peakInUseCount(0),
+		  totalAcquireCount(0)
+	{}
+
+	// Acquire an object, returning its handle in handleOut. Returns nullptr if the pool is full.
+	T* Acquire(void*& handleOut)
+	{
+		if (freeListHead == NO_SLOT && !AddSlab())
+			return nullptr;
+
+		uint32_t index = freeListHead;
+		Slot& slot = GetSlot(index);
+		freeListHead = slot.nextFree;
+
+		slot.inUse = true;
+		slot.nextFree = NO_SLOT;
+
+		inUseCount++;
+		peakInUseCount = std::max(peakInUseCount, inUseCount);
+		totalAcquireCount++;
+
+		handleOut = MakeHandle(index, slot.generation);
+		return &slot.value;
+	}
+
+	// Release the object for a handle, resetting it for reuse. Returns false if the handle is stale.
+	bool Release(void* handle)
+	{
+		uint32_t index;
+		Slot* slot = FindSlot(handle, index);
+		if (slot == nullptr)
+			return false;
+
+		ReleaseSlot(*slot, index);
+		return true;
+	}
+
+	// Return the object for a handle, or nullptr if the handle is stale.
+	T* Lookup(void* handle)
+	{
+		uint32_t index;
+		Slot* slot = FindSlot(handle, index);
+		return slot == nullptr ? nullptr : &slot->value;
+	}
+
+	// Call a function with every object whose slot is in use.
+	template<typename F>
+	void ForEachInUse(F func)
+	{
+		for (uint32_t index = 0; index < GetCapacity(); ++index)
+		{
+			Slot& slot = GetSlot(index);
+			if (slot.inUse)
+				func(slot.value);
+		}
+	}
+
+	// Release every slot still in use, so any handles still held elsewhere become stale.
+	// Returns the number of slots that were released.
+	size_t ReleaseAll()
+	{
+		size_t releasedCount = 0;
+
+		for (uint32_t index = 0; index < GetCapacity(); ++index)
+		{
+			Slot& slot = GetSlot(index);
+			if (slot.inUse)
+			{
+				ReleaseSlot(slot, index);
+				releasedCount++;
+			}
+		}
+
+		return releasedCount;
+	}
+
+	uint32_t GetCapacity() const
+	{
+		return static_cast<uint32_t>(slabs.size()) * SLAB_SIZE;
+	}
+
+	uint32_t GetInUseCount() const
+	{
+		return inUseCount;
+	}
+
+	uint32_t GetPeakInUseCount() const
+	{
+		return peakInUseCount;
+	}
+
+	uint64_t GetTotalAcquireCount() const
+	{
+		return totalAcquireCount;
+	}
+
+protected:
+	static const uint32_t NO_SLOT = 0xFFFFFFFFu;
+	static const uintptr_t GENERATION_MASK = ~static_cast<uintptr_t>(0) >> INDEX_BITS;
+
+	struct Slot {
+		T value;
+		uint32_t generation = 1;
+		uint32_t nextFree = NO_SLOT;
+		bool inUse = false;
+	};
+
+	Slot& GetSlot(uint32_t index)
+	{
+		return slabs[index / SLAB_SIZE][index % SLAB_SIZE];
+	}
+
+	static void* MakeHandle(uint32_t index, uint32_t generation)
+	{
+		return reinterpret_cast<void*>((static_cast<uintptr_t>(generation) << INDEX_BITS) | index);
+	}
+
+	Slot* FindSlot(void* handle, uint32_t& indexOut)
+	{
+		uintptr_t value = reinterpret_cast<uintptr_t>(handle);
+		uint32_t index = static_cast<uint32_t>(value & (MAX_SLOTS - 1));
+		uint32_t generation = static_cast<uint32_t>(value >> INDEX_BITS);
+
+		if (index >= GetCapacity())
+			return nullptr;
+
+		Slot& slot = GetSlot(index);
+		if (!slot.inUse || slot.generation != generation)
+			return nullptr;
+
+		indexOut = index;
+		return &slot;
+	}
+
+	void ReleaseSlot(Slot& slot, uint32_t index)
+	{
+		slot.value = T();
+		slot.inUse = false;
+
+		// Bump the generation so existing handles to this slot become stale, skipping 0 on wrapping around.
+		slot.generation = static_cast<uint32_t>((slot.generation + 1) & GENERATION_MASK);
+		if (slot.generation == 0)
+			slot.generation = 1;
+
+		slot.nextFree = freeListHead;
+		freeListHead = index;
+		inUseCount--;
+	}
+
+	bool AddSlab()
+	{
+		if (GetCapacity() + SLAB_SIZE > MAX_SLOTS)
+			return false;
+
+		uint32_t firstIndex = GetCapacity();
+		slabs.push_back(std::make_unique<Slot[]>(SLAB_SIZE));
+
+		// Add the new slots to the free list, in order so lower indices are used first.
+		for (uint32_t i = SLAB_SIZE; i-- > 0; )
+		{
+			GetSlot(firstIndex + i).nextFree = freeListHead;
+			freeListHead = firstIndex + i;
+		}
+
+		return true;
+	}
+
+	std::vector<std::unique_ptr<Slot[]>> slabs;
+	uint32_t freeListHead;
+	uint32_t inUseCount;
+	uint32_t peakInUseCount;
+	uint64_t totalAcquireCount;
+};
@@ -0,0 +1,178 @@
+
+#include "pch.h"
+#include "SpanTracer.h"
+
+#include "json.hpp"
+
+// Each thread caches its buffer for the tracer it last recorded a span for, so the lookup only happens once.
+// Tracers are identified by a unique ID rather than their address, in case one is destroyed and another
+// created at the same address.
+struct ThreadSpanBufferCache {
+	uint64_t tracerId;
+	void* buffer;
+};
+
+static thread_local ThreadSpanBufferCache t_SpanBufferCache = { 0, nullptr };
+
+static std::atomic<uint64_t> g_NextTracerId(1);
+
+SpanTracer::SpanTracer()
+	: tracerId(g_NextTracerId.fetch_add(1)),
+	  isTracing(false),
+	  session(0),
+	  droppedCount(0)
+{
+}
+
+void SpanTracer::Start()
+{
+	// Each buffer resets on its next span, as its session is now out of date.
+	traceStartTime = std::chrono::steady_clock::now();
+	droppedCount = 0;
+	session.fetch_add(1, std::memory_order_release);
+	isTracing.store(true, std::memory_order_release);
+}
+
+void SpanTracer::Stop()
+{
+	isTracing.store(false, std::memory_order_release);
+}
+
+bool SpanTracer::IsTracing() const
+{
+	return isTracing.load(std::memory_order_acquire);
+}
+
+uint64_t SpanTracer::GetDroppedCount() const
+{
+	return droppedCount.load(std::memory_order_relaxed);
+}
+
+SpanTracer::ThreadBuffer* SpanTracer::GetThreadBuffer()
+{
+	if (t_SpanBufferCache.tracerId == tracerId)
+		return static_cast<ThreadBuffer*>(t_SpanBufferCache.buffer);
+
+	uint32_t threadId = PlatformGetThreadId();
+
+	std::lock_guard<std::mutex> lock(buffersMutex);
+
+	ThreadBuffer* buffer = nullptr;
+	for (const std::unique_ptr<ThreadBuffer>& b : buffers)
+	{
+		if (b->threadId == threadId)
+		{
+			buffer = b.get();
+			break;
+		}
+	}
+
+	if (buffer == nullptr)
+	{
+		buffers.push_back(std::make_unique<ThreadBuffer>());
+		buffer = buffers.back().get();
+		buffer->threadId = threadId;
+		buffer->session = 0;
+		buffer->count = 0;
+		buffer->spans.reset(new TraceSpan[SPANS_PER_THREAD]);
+	}
+
+	t_SpanBufferCache = { tracerId, buffer };
+	return buffer;
+}
+
+void SpanTracer::AddSpan(const char* name, const char* category, std::chrono::steady_clock::time_point startTime, double asyncId)
+{
+	auto endTime = std::chrono::steady_clock::now();
+
+	// Drop spans that end after tracing stopped, as the buffers may be being read.
+	if (!IsTracing())
+		return;
+
+	ThreadBuffer* buffer = GetThreadBuffer();
+
+	uint64_t currentSession = session.load(std::memory_order_acquire);
+	if (buffer->session.load(std::memory_order_relaxed) != currentSession)
+	{
+		buffer->count.store(0, std::memory_order_relaxed);
+		buffer->session.store(currentSession, std::memory_order_release);
+	}
+
+	size_t count = buffer->count.load(std::memory_order_relaxed);
+	if (count >= SPANS_PER_THREAD)
+	{
+		droppedCount.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	TraceSpan& span = buffer->spans[count];
+	span.name = name;
+	span.category = category;
+	span.startUs = startTime > traceStartTime ? std::chrono::duration_cast<std::chrono::microseconds>(startTime - traceStartTime).count() : 0;
+	span.durationUs = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count();
+	span.asyncId = asyncId;
+
+	buffer->count.store(count + 1, std::memory_order_release);
+}
+
+size_t SpanTracer::GetSpanCount() const
+{
+	uint64_t currentSession = session.load(std::memory_order_acquire);
+	size_t ret = 0;
+
+	std::lock_guard<std::mutex> lock(buffersMutex);
+
+	for (const std::unique_ptr<ThreadBuffer>& buffer : buffers)
+	{
+		if (buffer->session.load(std::memory_order_acquire) == currentSession)
+			ret += buffer->count.load(std::memory_order_acquire);
+	}
+
+	return ret;
+}
+
+std::string SpanTracer::GetJson() const
+{
+	uint64_t currentSession = session.load(std::memory_order_acquire);
+
+	nlohmann::json traceEvents = nlohmann::json::array();
+
+	std::lock_guard<std::mutex> lock(buffersMutex);
+
+	for (const std::unique_ptr<ThreadBuffer>& buffer : buffers)
+	{
+		// Buffers with an older session had no spans since tracing last started.
+		if (buffer->session.load(std::memory_order_acquire) != currentSession)
+			continue;
+
+		size_t count = buffer->count.load(std::memory_order_acquire);
+		for (size_t i = 0; i < count; ++i)
+		{
+			const TraceSpan& span = buffer->spans[i];
+
+			// Complete ("X") events, with times in microseconds.
+			nlohmann::json event = {
+				{ "name", span.name },
+				{ "cat", span.category },
+				{ "ph", "X" },
+				{ "ts", span.startUs },
+				{ "dur", span.durationUs },
+				{ "pid", 1 },
+				{ "tid", buffer->threadId }
+			};
+
+			if (span.asyncId != -1.0)
+				event["args"] = { { "asyncId", span.asyncId } };
+
+			traceEvents.push_back(std::move(event));
+		}
+	}
+
+	nlohmann::json ret = {
+		{ "traceEvents", std::move(traceEvents) },
+		{ "displayTimeUnit", "ms" },
+		{ "otherData", { { "droppedSpanCount", GetDroppedCount() } } }
+	};
+
+	return ret.dump();
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+
+// A timed span of work on one thread, shown as a bar on the trace timeline.
+struct TraceSpan {
+	const char* name;			// string literal, e.g. a message or operation name
+	const char* category;		// string literal, e.g. "message" or "tick"
+	uint64_t startUs;			// relative to when tracing started
+	uint64_t durationUs;
+	double asyncId;				// -1 if none
+};
+
+// Records spans of time spent handling web messages, ticking the EOS SDK, running EOS callbacks and sending
+// messages, to see on one timeline how they interleave across threads. When tracing stops, the spans are
+// written as Chrome trace-event JSON, which can be loaded in chrome://tracing or https://ui.perfetto.dev.
+// Tracing is toggled with the "set-span-tracing" message. When it is off, a Scope only checks a flag.
+// Spans are buffered per thread, so recording one is just a write to the current thread's buffer, with no
+// locking. Each buffer has a fixed capacity, and once it is full further spans on that thread are dropped
+// and counted. The first span on each thread registers a buffer, which takes a lock and allocates.
+class SpanTracer {
+public:
+	static const size_t SPANS_PER_THREAD = 16384;
+
+	SpanTracer();
+
+	void Start();
+	void Stop();
+
+	bool IsTracing() const;
+
+	// Get Chrome trace-event JSON for the spans recorded since tracing last started. Only call this while
+	// tracing is stopped.
+	std::string GetJson() const;
+
+	size_t GetSpanCount() const;
+	uint64_t GetDroppedCount() const;
+
+	// Record a span for the rest of the current scope, if tracing.
+	class Scope {
+	public:
+		Scope(SpanTracer& tracer_, const char* name_, const char* category_, double asyncId_ = -1.0)
+			: tracer(tracer_),
+			  name(name_),
+			  category(category_),
+			  asyncId(asyncId_),
+			  isTracing(tracer_.IsTracing())
+		{
+			if (isTracing)
+				startTime = std::chrono::steady_clock::now();
+		}
+
+		~Scope()
+		{
+			if (isTracing)
+				tracer.AddSpan(name, category, startTime, asyncId);
+		}
+
+	private:
+		SpanTracer& tracer;
+		const char* name;
+		const char* category;
+		double asyncId;
+		bool isTracing;
+		std::chrono::steady_clock::time_point startTime;
+	};
+
+protected:
+	// Spans recorded on one thread. Only that thread writes to it, and it publishes each span by
+	// incrementing the count afterwards. Each buffer is reset by its own thread on the first span after
+	// tracing starts again, identified by the session number.
+	struct ThreadBuffer {
+		uint32_t threadId;
+		std::atomic<uint64_t> session;
+		std::atomic<size_t> count;
+		std::unique_ptr<TraceSpan[]> spans;
+	};
+
+	void AddSpan(const char* name, const char* category, std::chrono::steady_clock::time_point startTime, double asyncId);
+	ThreadBuffer* GetThreadBuffer();
+
+	const uint64_t tracerId;			// identifies this tracer to the thread-local buffer cache
+
+	std::atomic<bool> isTracing;
+	std::atomic<uint64_t> session;
+	std::chrono::steady_clock::time_point traceStartTime;
+	std::atomic<uint64_t> droppedCount;
+
+	mutable std::mutex buffersMutex;
+	std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+};
@@ -0,0 +1,155 @@
+
+#include "pch.h"
+#include "TickProfiler.h"
+
+#include "json.hpp"
+
+// Default threshold for recording a tick as a spike: a quarter of a frame at 60 Hz.
+const std::chrono::microseconds DEFAULT_SPIKE_THRESHOLD(4000);
+
+// The profiler currently running a tick on this thread, so callbacks on other threads are not timed.
+static thread_local TickProfiler* t_TickingProfiler = nullptr;
+
+static double ToMs(std::chrono::steady_clock::duration duration)
+{
+	return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+TickProfiler::TickProfiler()
+	: spikeThreshold(DEFAULT_SPIKE_THRESHOLD),
+	  spikeCount(0),
+	  tickCallbacks{},
+	  tickCallbackCount(0),
+	  tickDroppedCallbackCount(0)
+{
+	spikes.reserve(MAX_SPIKES);
+}
+
+void TickProfiler::SetSpikeThreshold(std::chrono::steady_clock::duration threshold)
+{
+	spikeThreshold = threshold;
+}
+
+void TickProfiler::Clear()
+{
+	tickDurations.Clear();
+	spikeCount = 0;
+	spikes.clear();
+}
+
+void TickProfiler::BeginTick()
+{
+	t_TickingProfiler = this;
+	tickStartTime = std::chrono::steady_clock::now();
+	tickCallbackCount = 0;
+	tickDroppedCallbackCount = 0;
+}
+
+void TickProfiler::EndTick(uint64_t tickIndex)
+{
+	auto duration = std::chrono::steady_clock::now() - tickStartTime;
+	t_TickingProfiler = nullptr;
+
+	tickDurations.Record(duration);
+
+	if (duration >= spikeThreshold)
+	{
+		spikeCount++;
+		AddSpike(tickIndex, duration);
+	}
+}
+
+size_t TickProfiler::BeginCallback(const char* name)
+{
+	if (t_TickingProfiler != this)
+		return SIZE_MAX;
+
+	if (tickCallbackCount == MAX_TICK_CALLBACK_TIMINGS)
+	{
+		tickDroppedCallbackCount++;
+		return SIZE_MAX;
+	}
+
+	// The duration is filled in by EndCallback().
+	TickCallbackTiming& timing = tickCallbacks[tickCallbackCount];
+	timing.name = name;
+	timing.startMs = ToMs(std::chrono::steady_clock::now() - tickStartTime);
+	timing.durationMs = -1.0;
+	return tickCallbackCount++;
+}
+
+void TickProfiler::EndCallback(size_t index)
+{
+	if (index == SIZE_MAX || t_TickingProfiler != this)
+		return;
+
+	TickCallbackTiming& timing = tickCallbacks[index];
+	timing.durationMs = ToMs(std::chrono::steady_clock::now() - tickStartTime) - timing.startMs;
+}
+
+// Keep the spike if there is room, or if it is worse than the least bad spike kept so far.
+void TickProfiler::AddSpike(uint64_t tickIndex, std::chrono::steady_clock::duration duration)
+{
+	if (spikes.size() == MAX_SPIKES)
+	{
+		if (duration <= spikes.back().duration)
+			return;
+
+		spikes.pop_back();
+	}
+
+	auto it = std::find_if(spikes.begin(), spikes.end(), [duration](const TickSpike& spike)
+	{
+		return spike.duration < duration;
+	});
+
+	TickSpike& spike = *spikes.insert(it, TickSpike{});
+	spike.tickIndex = tickIndex;
+	spike.startTime = tickStartTime;
+	spike.duration = duration;
+	spike.callbacks = tickCallbacks;
+	spike.callbackCount = tickCallbackCount;
+	spike.droppedCallbackCount = tickDroppedCallbackCount;
+}
+
+std::string TickProfiler::GetJson() const
+{
+	auto now = std::chrono::steady_clock::now();
+
+	nlohmann::json spikesJson = nlohmann::json::array();
+	for (const TickSpike& spike : spikes)
+	{
+		nlohmann::json callbacksJson = nlohmann::json::array();
+		for (size_t i = 0; i < spike.callbackCount; ++i)
+		{
+			const TickCallbackTiming& timing = spike.callbacks[i];
+			callbacksJson.push_back({
+				{ "name", timing.name },
+				{ "startMs", timing.startMs },
+				{ "durationMs", timing.durationMs }
+			});
+		}
+
+		spikesJson.push_back({
+			{ "tickIndex", spike.tickIndex },
+			{ "ageMs", ToMs(now - spike.startTime) },
+			{ "durationMs", ToMs(spike.duration) },
+			{ "callbacks", callbacksJson },
+			{ "droppedCallbackCount", spike.droppedCallbackCount }
+		});
+	}
+
+	nlohmann::json ret = {
+		{ "tickCount", tickDurations.GetCount() },
+		{ "meanMs", tickDurations.GetMeanMs() },
+		{ "p50Ms", tickDurations.GetPercentileMs(0.5) },
+		{ "p90Ms", tickDurations.GetPercentileMs(0.9) },
+		{ "p99Ms", tickDurations.GetPercentileMs(0.99) },
+		{ "maxMs", tickDurations.GetMaxMs() },
+		{ "spikeThresholdMs", ToMs(spikeThreshold) },
+		{ "spikeCount", spikeCount },
+		{ "spikes", spikesJson }
+	};
+
+	return ret.dump();
+}
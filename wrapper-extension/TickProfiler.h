@@ -0,0 +1,87 @@
+#pragma once
+
+#include <stdint.h>
+#include <array>
+#include <chrono>
+#include "LatencyHistogram.h"
+
+// Time spent in one callback run during a tick, relative to the start of the tick.
+struct TickCallbackTiming {
+	const char* name;			// string literal, e.g. an operation name like "auth-login"
+	double startMs;
+	double durationMs;
+};
+
+const size_t MAX_TICK_CALLBACK_TIMINGS = 32;
+
+// A tick that took longer than the spike threshold, with the callbacks that ran inside it.
+struct TickSpike {
+	uint64_t tickIndex;
+	std::chrono::steady_clock::time_point startTime;
+	std::chrono::steady_clock::duration duration;
+	std::array<TickCallbackTiming, MAX_TICK_CALLBACK_TIMINGS> callbacks;
+	size_t callbackCount;
+	size_t droppedCallbackCount;		// callbacks beyond MAX_TICK_CALLBACK_TIMINGS, which are counted but not timed
+};
+
+// Profiles EOS_Platform_Tick(), which runs every callback due and so can take long enough to cause a frame
+// hitch. Every tick's duration goes in to a histogram. During a tick, each callback is also timed (see
+// CallbackScope), and if the tick takes longer than the spike threshold, those timings are kept as a spike.
+// Only the worst MAX_SPIKES spikes are kept. All storage is fixed, so profiling does not allocate.
+// Note this is only used on the thread using the EOS SDK, so does not need synchronization. Callbacks on
+// any other thread (e.g. EOS log messages from SDK threads) are ignored, as they cannot hold up the tick.
+class TickProfiler {
+public:
+	static const size_t MAX_SPIKES = 8;
+
+	TickProfiler();
+
+	void SetSpikeThreshold(std::chrono::steady_clock::duration threshold);
+	void Clear();
+
+	void BeginTick();
+	void EndTick(uint64_t tickIndex);
+
+	// Returns an index for EndCallback(), or SIZE_MAX if not in a tick or there are too many callbacks to time.
+	size_t BeginCallback(const char* name);
+	void EndCallback(size_t index);
+
+	std::string GetJson() const;
+
+	// Time a callback for the rest of the current scope. This does nothing outside a tick.
+	class CallbackScope {
+	public:
+		CallbackScope(TickProfiler& profiler_, const char* name)
+			: profiler(profiler_),
+			  index(profiler_.BeginCallback(name))
+		{}
+
+		~CallbackScope()
+		{
+			profiler.EndCallback(index);
+		}
+
+		CallbackScope(const CallbackScope&) = delete;
+		CallbackScope& operator=(const CallbackScope&) = delete;
+
+	protected:
+		TickProfiler& profiler;
+		size_t index;
+	};
+
+protected:
+	void AddSpike(uint64_t tickIndex, std::chrono::steady_clock::duration duration);
+
+	LatencyHistogram tickDurations;
+	std::chrono::steady_clock::duration spikeThreshold;
+	uint64_t spikeCount;
+
+	// The tick in progress
+	std::chrono::steady_clock::time_point tickStartTime;
+	std::array<TickCallbackTiming, MAX_TICK_CALLBACK_TIMINGS> tickCallbacks;
+	size_t tickCallbackCount;
+	size_t tickDroppedCallbackCount;
+
+	// The worst spikes so far, in order of decreasing duration.
+	std::vector<TickSpike> spikes;
+};
@@ -0,0 +1,163 @@
+
+#include "pch.h"
+#include "TickThread.h"
+
+// Convert a tick rate to the interval between ticks, clamping to a sensible range.
+static std::chrono::steady_clock::duration RateToInterval(double ticksPerSecond)
+{
+	ticksPerSecond = std::min(std::max(ticksPerSecond, 1.0), 1000.0);
+
+	return std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / ticksPerSecond));
+}
+
+TickThread::TickThread()
+	: isQuitting(false),
+	  tickInterval(RateToInterval(60.0))
+{
+}
+
+TickThread::~TickThread()
+{
+	Stop();
+}
+
+void TickThread::Start(double ticksPerSecond, std::function<void()> tickFunc_)
+{
+	if (thread.joinable())
+		return;		// already running
+
+	tickFunc = tickFunc_;
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		isQuitting = false;
+		tickInterval = RateToInterval(ticksPerSecond);
+	}
+
+	thread = std::thread(&TickThread::ThreadMain, this);
+	threadId = thread.get_id();
+}
+
+void TickThread::Stop()
+{
+	if (!thread.joinable())
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		isQuitting = true;
+	}
+
+	condVar.notify_one();
+	thread.join();
+
+	threadId = std::thread::id();
+
+	// The thread runs every task posted before it was told to quit, and Post() refuses tasks from other threads
+	// after that, so this should already be empty. Clear it anyway (under the lock, as Post() may still be
+	// called concurrently) so nothing posted is left to run on a later Start().
+	std::lock_guard<std::mutex> lock(mutex);
+	pendingTasks.clear();
+}
+
+bool TickThread::IsRunning() const
+{
+	return thread.joinable();
+}
+
+bool TickThread::IsCurrentThread() const
+{
+	return std::this_thread::get_id() == threadId;
+}
+
+bool TickThread::Post(std::function<void()> task)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+
+		// Once Stop() has been called, only tasks posted by the tick thread itself are accepted, as it keeps
+		// running until it has run out of tasks. Tasks from other threads could arrive after it exits, so they
+		// are dropped rather than left with nothing to run them.
+		if (isQuitting && !IsCurrentThread())
+			return false;
+
+		pendingTasks.push_back(std::move(task));
+	}
+
+	// Wake the thread so the task runs without waiting for the next tick.
+	condVar.notify_one();
+	return true;
+}
+
+void TickThread::SetRate(double ticksPerSecond)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		tickInterval = RateToInterval(ticksPerSecond);
+	}
+
+	condVar.notify_one();
+}
+
+double TickThread::GetRate() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return 1.0 / std::chrono::duration<double>(tickInterval).count();
+}
+
+void TickThread::ThreadMain()
+{
+	auto lastTickTime = std::chrono::steady_clock::now() - tickInterval;
+	std::vector<std::function<void()>> runTasks;
+
+	while (true)
+	{
+		bool isQuittingNow;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+
+			// Sleep until the next tick is due, unless woken early by a posted task or quitting.
+			// The due time is recalculated after every wakeup so a change in rate applies immediately.
+			while (!isQuitting && pendingTasks.empty())
+			{
+				auto nextTickTime = lastTickTime + tickInterval;
+				if (std::chrono::steady_clock::now() >= nextTickTime)
+					break;
+
+				condVar.wait_until(lock, nextTickTime);
+			}
+
+			// When quitting, keep going until all the tasks posted so far have run, so that e.g. an async message
+			// posted just before the extension is released still sends its response.
+			if (isQuitting && pendingTasks.empty())
+				break;
+
+			// Take the pending tasks to run them outside the lock, allowing more tasks to be posted meanwhile.
+			runTasks.swap(pendingTasks);
+			isQuittingNow = isQuitting;
+		}
+
+		for (auto& task : runTasks)
+			task();
+
+		runTasks.clear();
+
+		// Don't tick again once quitting, only finish running tasks.
+		if (isQuittingNow)
+			continue;
+
+		// Tick if due, using the current interval in case a task changed the rate.
+		std::chrono::steady_clock::duration interval;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			interval = tickInterval;
+		}
+
+		auto now = std::chrono::steady_clock::now();
+		if (now - lastTickTime >= interval)
+		{
+			lastTickTime = now;
+			tickFunc();
+		}
+	}
+}
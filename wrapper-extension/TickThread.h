@@ -0,0 +1,48 @@
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <chrono>
+
+// A native thread that regularly calls a tick function at a configurable rate, and also runs any
+// tasks posted to it. This is used for the optional native tick mode, where the extension calls
+// EOS_Platform_Tick() itself rather than waiting for a "platform-tick" message from JavaScript.
+// Since the EOS SDK must only be used from a single thread, when the tick thread is running all
+// web messages are posted to it, so every EOS call and callback happens on the tick thread.
+class TickThread {
+public:
+	TickThread();
+	~TickThread();
+
+	void Start(double ticksPerSecond, std::function<void()> tickFunc_);
+	void Stop();
+
+	bool IsRunning() const;
+	bool IsCurrentThread() const;
+
+	// Post a task to run on the tick thread before its next tick. Returns false if the task was dropped
+	// because the thread is stopping.
+	bool Post(std::function<void()> task);
+
+	void SetRate(double ticksPerSecond);
+	double GetRate() const;
+
+protected:
+	void ThreadMain();
+
+	std::thread thread;
+	std::thread::id threadId;
+
+	std::function<void()> tickFunc;
+
+	mutable std::mutex mutex;
+	std::condition_variable condVar;
+
+	// Following members are protected by mutex
+	bool isQuitting;
+	std::chrono::steady_clock::duration tickInterval;
+	std::vector<std::function<void()>> pendingTasks;
+};
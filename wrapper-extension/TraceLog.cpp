@@ -0,0 +1,195 @@
+
+#include "pch.h"
+#include "TraceLog.h"
+
+#include <cstring>
+
+// The string table and records start on page boundaries after the header.
+const uint32_t TRACE_HEADER_SIZE = 4096;
+const uint32_t INTERN_SLOT_COUNT = TraceLog::MAX_STRINGS * 2;		// must be a power of two
+
+void TraceArgs::AddValue(int64_t value)
+{
+	if (count < TRACE_MAX_ARGS)
+		memcpy(&values[count++], &value, sizeof(value));
+}
+
+void TraceArgs::AddValue(double value)
+{
+	if (count < TRACE_MAX_ARGS)
+	{
+		doubleMask |= (1 << count);
+		memcpy(&values[count++], &value, sizeof(value));
+	}
+}
+
+TraceLog::TraceLog()
+	: header(nullptr),
+	  stringTable(nullptr),
+	  records(nullptr),
+	  isOpen(false),
+	  nextIndex(0),
+	  internSlots(INTERN_SLOT_COUNT),
+	  stringTableUsed(0)
+{
+	stringOffsets.reserve(MAX_STRINGS);
+}
+
+TraceLog::~TraceLog()
+{
+	Close();
+}
+
+bool TraceLog::Open(const std::string& path)
+{
+	Close();
+
+	// Keep the last session's trace, which is the one of interest after a crash.
+	PlatformMoveFile(path, path + ".prev");
+
+	// The mapped file starts zero-filled, so every record starts with sequence 0.
+	const uint32_t recordsOffset = TRACE_HEADER_SIZE + STRING_TABLE_SIZE;
+	const uint32_t fileSize = recordsOffset + RECORD_CAPACITY * sizeof(TraceRecord);
+
+	if (!file.Open(path, fileSize))
+		return false;
+
+	uint8_t* view = file.GetData();
+
+	header = reinterpret_cast<TraceFileHeader*>(view);
+	stringTable = view + TRACE_HEADER_SIZE;
+	records = reinterpret_cast<TraceRecord*>(view + recordsOffset);
+
+	memcpy(header->magic, TRACE_FILE_MAGIC, sizeof(header->magic));
+	header->version = TRACE_FILE_VERSION;
+	header->headerSize = sizeof(TraceFileHeader);
+	header->recordSize = sizeof(TraceRecord);
+	header->recordCapacity = RECORD_CAPACITY;
+	header->recordsOffset = recordsOffset;
+	header->stringTableOffset = TRACE_HEADER_SIZE;
+	header->stringTableSize = STRING_TABLE_SIZE;
+	header->stringCount = 0;
+	header->startTimeUnixMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+
+	startTime = std::chrono::steady_clock::now();
+	nextIndex = 0;
+	std::fill(internSlots.begin(), internSlots.end(), 0);
+	stringOffsets.clear();
+	stringTableUsed = 0;
+
+	isOpen = true;
+
+	// ID 0 is the placeholder used when the string table is full.
+	Intern("<string table full>");
+
+	return true;
+}
+
+void TraceLog::Close()
+{
+	isOpen = false;
+
+	file.Close();
+	header = nullptr;
+	stringTable = nullptr;
+	records = nullptr;
+}
+
+bool TraceLog::IsOpen() const
+{
+	return isOpen.load(std::memory_order_acquire);
+}
+
+uint64_t TraceLog::GetRecordCount() const
+{
+	return nextIndex.load(std::memory_order_relaxed);
+}
+
+std::string_view TraceLog::GetString(uint16_t id) const
+{
+	const uint8_t* entry = stringTable + stringOffsets[id];
+
+	uint16_t length;
+	memcpy(&length, entry, sizeof(length));
+	return std::string_view(reinterpret_cast<const char*>(entry + sizeof(length)), length);
+}
+
+uint16_t TraceLog::Intern(std::string_view str)
+{
+	if (!IsOpen())
+		return 0;
+
+	str = str.substr(0, MAX_STRING_LENGTH);
+
+	// FNV-1a
+	uint32_t hash = 2166136261u;
+	for (char ch : str)
+	{
+		hash ^= static_cast<uint8_t>(ch);
+		hash *= 16777619u;
+	}
+
+	std::lock_guard<std::mutex> lock(internMutex);
+
+	size_t slot = hash & (INTERN_SLOT_COUNT - 1);
+	while (internSlots[slot] != 0)
+	{
+		uint16_t id = internSlots[slot] - 1;
+		if (GetString(id) == str)
+			return id;
+
+		slot = (slot + 1) & (INTERN_SLOT_COUNT - 1);
+	}
+
+	uint16_t length = static_cast<uint16_t>(str.size());
+	if (stringOffsets.size() >= MAX_STRINGS || stringTableUsed + sizeof(length) + length > STRING_TABLE_SIZE)
+		return 0;
+
+	uint8_t* entry = stringTable + stringTableUsed;
+	memcpy(entry, &length, sizeof(length));
+	memcpy(entry + sizeof(length), str.data(), length);
+
+	uint16_t id = static_cast<uint16_t>(stringOffsets.size());
+	stringOffsets.push_back(stringTableUsed);
+	stringTableUsed += sizeof(length) + length;
+	internSlots[slot] = id + 1;
+
+	// Publish the string to the file after writing it, so the decoder only reads complete strings.
+	std::atomic_ref<uint32_t>(header->stringCount).store(static_cast<uint32_t>(stringOffsets.size()), std::memory_order_release);
+
+	return id;
+}
+
+void TraceLog::Write(TraceCategory category, uint8_t level, uint16_t messageId, const TraceArgs& args)
+{
+	if (!IsOpen())
+		return;
+
+	// Claim the next record in the ring. Its sequence number is cleared while it is written, so if the
+	// process ends part way through, the decoder skips it rather than reading a mix of old and new records.
+	uint64_t index = nextIndex.fetch_add(1, std::memory_order_relaxed);
+	TraceRecord& record = records[index % RECORD_CAPACITY];
+
+	std::atomic_ref<uint64_t> sequence(record.sequence);
+	sequence.store(0, std::memory_order_relaxed);
+
+	record.timestampUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count();
+	record.threadId = PlatformGetThreadId();
+	record.messageId = messageId;
+	record.category = category;
+	record.level = level;
+	record.argCount = args.count;
+	record.argDoubleMask = args.doubleMask;
+	memcpy(record.args, args.values, sizeof(record.args));
+
+	record.textLength = static_cast<uint8_t>(std::min<size_t>(args.text.size(), TRACE_MAX_TEXT_LENGTH));
+	memcpy(record.text, args.text.data(), record.textLength);
+
+	sequence.store(index + 1, std::memory_order_release);
+}
+
+void TraceLog::Write(TraceCategory category, uint8_t level, std::string_view message, const TraceArgs& args)
+{
+	if (IsOpen())
+		Write(category, level, Intern(message), args);
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <type_traits>
+#include "TraceLogFormat.h"
+
+// The arguments of a trace record, collected from the arguments of a log message without formatting them:
+// the first string literal becomes the message ID, the first other string (such as an error message) is
+// copied as the record's text, and numbers, booleans and enums are stored as arguments. Anything else,
+// including later string literals, is left out.
+struct TraceArgs {
+	const char* message = nullptr;
+	std::string_view text;
+	uint8_t count = 0;
+	uint8_t doubleMask = 0;
+	uint64_t values[TRACE_MAX_ARGS] = {};
+
+	template<typename T>
+	void Add(const T& value)
+	{
+		if constexpr (std::is_array_v<T>)
+		{
+			if (message == nullptr)
+				message = value;
+		}
+		else if constexpr (std::is_convertible_v<const T&, std::string_view>)
+		{
+			if (text.empty())
+				text = value;
+		}
+		else if constexpr (std::is_floating_point_v<T>)
+			AddValue(static_cast<double>(value));
+		else if constexpr (std::is_integral_v<T> || std::is_enum_v<T>)
+			AddValue(static_cast<int64_t>(value));
+	}
+
+	void AddValue(int64_t value);
+	void AddValue(double value);
+};
+
+// An optional binary trace log, for post-mortem analysis of problems such as crashes, where the console and
+// debug output are lost. Rather than formatting text, each event is written as a fixed-size TraceRecord (see
+// TraceLogFormat.h), with strings such as message names interned in a table and referred to by ID.
+// The file is a fixed-size ring mapped in to memory, so writing a record is just copying it to memory, with
+// no system calls. As the mapped pages belong to the OS, whatever was written is still saved to the file if
+// the process crashes. The previous session's file is kept alongside with a ".prev" suffix, so it is not
+// overwritten when the game is restarted after a crash. Use tools/DecodeTraceLog.cpp to turn it back in to text.
+// Records can be written from any thread. Interning a string takes a lock, but it is not normally contended.
+// Note Close() must only be called once nothing else can be writing to the log.
+class TraceLog {
+public:
+	static const uint32_t RECORD_CAPACITY = 16384;			// 2 MB of records
+	static const uint32_t STRING_TABLE_SIZE = 64 * 1024;
+	static const uint32_t MAX_STRINGS = 1024;
+	static const uint32_t MAX_STRING_LENGTH = 256;			// longer strings are truncated
+
+	TraceLog();
+	~TraceLog();
+
+	bool Open(const std::string& path);
+	void Close();
+
+	bool IsOpen() const;
+
+	// Get the ID of a string in the string table, adding it if necessary. If the table is full, this
+	// returns ID 0, which is a placeholder string.
+	uint16_t Intern(std::string_view str);
+
+	void Write(TraceCategory category, uint8_t level, uint16_t messageId, const TraceArgs& args);
+	void Write(TraceCategory category, uint8_t level, std::string_view message, const TraceArgs& args);
+
+	uint64_t GetRecordCount() const;
+
+protected:
+	std::string_view GetString(uint16_t id) const;
+
+	PlatformMappedFile file;
+	TraceFileHeader* header;
+	uint8_t* stringTable;
+	TraceRecord* records;
+
+	std::atomic<bool> isOpen;
+	std::atomic<uint64_t> nextIndex;
+	std::chrono::steady_clock::time_point startTime;
+
+	// Lookup for interned strings, as an open-addressed hash table of string ID + 1 (0 for empty).
+	std::mutex internMutex;
+	std::vector<uint16_t> internSlots;
+	std::vector<uint32_t> stringOffsets;
+	uint32_t stringTableUsed;
+};
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <stdint.h>
+
+// The file format of the binary trace log written by TraceLog. This only uses fixed-size types and no
+// Windows or EOS headers, so it can also be included by the offline decoder in tools/DecodeTraceLog.cpp.
+// The file is laid out as:
+//		TraceFileHeader		at offset 0
+//		string table		at header.stringTableOffset, header.stringTableSize bytes
+//		TraceRecord[]		at header.recordsOffset, header.recordCapacity records
+// The string table holds interned strings such as message names, as a run of entries each made of a
+// uint16_t length followed by that many bytes. A string's ID is its index in that run, and header.stringCount
+// says how many entries are complete.
+// Records are written in a ring, so once it is full the oldest are overwritten. Each record's sequence number
+// says where it comes in the trace, so the decoder sorts by that to recover the order. A sequence number of 0
+// means the record was never written, or was being written when the process ended.
+
+const char TRACE_FILE_MAGIC[8] = { 'E', 'X', 'T', 'T', 'R', 'A', 'C', 'E' };
+const uint32_t TRACE_FILE_VERSION = 1;
+
+const uint32_t TRACE_MAX_ARGS = 4;
+const uint32_t TRACE_MAX_TEXT_LENGTH = 64;
+
+// What a record is about, which says how the decoder shows it.
+enum class TraceCategory : uint8_t {
+	Extension,		// extension log message: message ID is the first string literal logged
+	EOSLog,			// EOS SDK log message: message ID is the EOS log category, level is the EOS log level
+	WebMessage,		// message received: message ID is its name, arg 0 is the asyncId
+	EOSCallback,	// async EOS operation completed: message ID is the operation name, args are asyncId and result code
+	Response,		// async response sent: message ID is the message name, arg 0 is the asyncId
+
+	Count
+};
+
+struct TraceFileHeader {
+	char magic[8];
+	uint32_t version;
+	uint32_t headerSize;
+	uint32_t recordSize;
+	uint32_t recordCapacity;
+	uint32_t recordsOffset;
+	uint32_t stringTableOffset;
+	uint32_t stringTableSize;
+	uint32_t stringCount;
+	int64_t startTimeUnixMs;	// wall clock time the trace started, which record timestamps are relative to
+};
+
+struct TraceRecord {
+	uint64_t sequence;			// 1 + index of the record in the trace, or 0 if not (fully) written
+	uint64_t timestampUs;		// microseconds since the trace started
+	uint32_t threadId;
+	uint16_t messageId;			// ID of a string in the string table
+	TraceCategory category;
+	uint8_t level;				// ExtLogLevel, or EOS log level / 100 for EOSLog records
+	uint8_t argCount;
+	uint8_t argDoubleMask;		// bit N set if arg N is a double, otherwise it is an int64_t
+	uint8_t textLength;
+	uint8_t reserved[5];
+	uint64_t args[TRACE_MAX_ARGS];
+	char text[TRACE_MAX_TEXT_LENGTH];	// optional free text, truncated to fit (not null terminated)
+};
+
+static_assert(sizeof(TraceRecord) == 128, "TraceRecord should be 128 bytes");
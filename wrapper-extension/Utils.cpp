@@ -1,54 +1,6 @@
 
 #include "pch.h"
 
-std::wstring Utf8ToWide(const std::string& utf8string)
-{
-	// Empty strings are equivalent
-	if (utf8string.empty())
-		return std::wstring();
-
-	// Request number of wchars needed to fit this string (note some arguments are int instead of size_t)
-	int wcharcount = MultiByteToWideChar(CP_UTF8, 0, utf8string.data(), (int)utf8string.size(), NULL, 0);
-
-	// Conversion failed or still empty: return empty string
-	if (wcharcount <= 0)
-		return std::wstring();
-
-	// Create a string to return and allocate memory for the content
-	std::wstring buffer;
-	buffer.resize(wcharcount);
-
-	// Do the conversion
-	MultiByteToWideChar(CP_UTF8, 0, utf8string.data(), (int)utf8string.size(), &(buffer.front()), wcharcount);
-
-	// Return converted string
-	return buffer;
-}
-
-std::string WideToUtf8(const std::wstring& widestring)
-{
-	// Empty strings are equivalent
-	if (widestring.empty())
-		return std::string();
-
-	// Calculate bytes required for output buffer (note some arguments are int instead of size_t)
-	int bytecount = WideCharToMultiByte(CP_UTF8, 0, widestring.data(), (int)widestring.size(), NULL, 0, NULL, NULL);
-
-	// Conversion failed or still empty: return empty string
-	if (bytecount <= 0)
-		return std::string();
-
-	// Create a string to return and allocate memory for the content
-	std::string buffer;
-	buffer.resize(bytecount);
-
-	// Do the conversion
-	WideCharToMultiByte(CP_UTF8, 0, widestring.data(), (int)widestring.size(), &(buffer.front()), bytecount, NULL, NULL);
-
-	// Return converted string
-	return buffer;
-}
-
 std::string StrFromPtr(const char* str)
 {
 	if (str == nullptr)
@@ -77,6 +29,8 @@ std::vector<ExtensionParameter> UnpackExtensionParameterArray(size_t paramCount,
 		case EPT_String:
 			ep.str = epRaw.str;
 			break;
+		default:				// EPT_Invalid: leave value empty
+			break;
 		}
 
 		ret.push_back(ep);
@@ -85,6 +39,34 @@ std::vector<ExtensionParameter> UnpackExtensionParameterArray(size_t paramCount,
 	return ret;
 }
 
+std::vector<ExtensionParameterPOD> PackExtensionParameters(const std::vector<ExtensionParameter>& params)
+{
+	std::vector<ExtensionParameterPOD> ret;
+	ret.reserve(params.size());
+
+	for (const ExtensionParameter& ep : params)
+	{
+		ExtensionParameterPOD epRaw = {};
+		epRaw.type = ep.type;
+
+		switch (ep.type) {
+		case EPT_Boolean:		// boolean also stored in number field
+		case EPT_Number:
+			epRaw.number = ep.number;
+			break;
+		case EPT_String:
+			epRaw.str = ep.str.c_str();
+			break;
+		default:				// EPT_Invalid: leave value empty
+			break;
+		}
+
+		ret.push_back(epRaw);
+	}
+
+	return ret;
+}
+
 std::vector<NamedExtensionParameterPOD> PackNamedExtensionParameters(const std::map<std::string, ExtensionParameter>& params)
 {
 	std::vector<NamedExtensionParameterPOD> ret;
@@ -104,6 +86,8 @@ std::vector<NamedExtensionParameterPOD> PackNamedExtensionParameters(const std::
 		case EPT_String:
 			nep.value.str = i->second.str.c_str();
 			break;
+		default:				// EPT_Invalid: leave value empty
+			break;
 		}
 
 		ret.push_back(nep);
@@ -114,8 +98,7 @@ std::vector<NamedExtensionParameterPOD> PackNamedExtensionParameters(const std::
 
 void DebugLog(const std::string& message)
 {
-	std::wstring messageW = Utf8ToWide(message);
-	OutputDebugString(messageW.c_str());
+	PlatformDebugOutput(message);
 }
 
 // Trim whitespace from a string
@@ -138,4 +121,10 @@ void TrimString(std::string& str)
 {
 	TrimStringRight(str);
 	TrimStringLeft(str);
-}
\ No newline at end of file
+}
+
+bool WriteTextFile(const std::string& path, const std::string& data)
+{
+	PlatformFile file;
+	return file.Open(path, PlatformFile::Mode::Create) && file.Write(data.data(), data.size());
+}
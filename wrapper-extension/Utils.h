@@ -2,15 +2,63 @@
 
 #include "IExtension.h"
 
-std::wstring Utf8ToWide(const std::string& utf8string);
-std::string WideToUtf8(const std::wstring& widestring);
-
 // Utility method that returns empty std::string when passed nullptr,
 // as the EOS SDK sometimes returns nullptr when strings are not set.
 std::string StrFromPtr(const char* str);
 
 std::vector<ExtensionParameter> UnpackExtensionParameterArray(size_t paramCount, const ExtensionParameterPOD* paramArr);
+std::vector<ExtensionParameterPOD> PackExtensionParameters(const std::vector<ExtensionParameter>& params);
 std::vector<NamedExtensionParameterPOD> PackNamedExtensionParameters(const std::map<std::string, ExtensionParameter>& params);
 
+// A non-owning view of the parameters passed to OnWebMessage(), for reading them without making copies.
+// It is only valid for the duration of the OnWebMessage() call, so anything that must outlive that
+// (such as strings passed to EOS calls which need a null-terminated string) must be copied.
+class ExtensionParameterArrayView {
+public:
+	ExtensionParameterArrayView(size_t paramCount_, const ExtensionParameterPOD* paramArr_)
+		: paramCount(paramCount_),
+		  paramArr(paramArr_)
+	{}
+
+	size_t size() const
+	{
+		return paramCount;
+	}
+
+	const ExtensionParameterPOD* data() const
+	{
+		return paramArr;
+	}
+
+	// Getter methods
+	ExtensionParameterType GetType(size_t i) const
+	{
+		return paramArr[i].type;
+	}
+
+	bool GetBool(size_t i) const
+	{
+		return paramArr[i].number != 0.0;		// boolean also stored in number field
+	}
+
+	double GetNumber(size_t i) const
+	{
+		return paramArr[i].number;
+	}
+
+	std::string_view GetString(size_t i) const
+	{
+		const char* str = paramArr[i].str;
+		return str == nullptr ? std::string_view() : std::string_view(str);
+	}
+
+protected:
+	size_t paramCount;
+	const ExtensionParameterPOD* paramArr;
+};
+
 void DebugLog(const std::string& message);
 void TrimString(std::string& str);
+
+// Write a whole file, replacing any existing file. Returns false if it could not be written.
+bool WriteTextFile(const std::string& path, const std::string& data);
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <initializer_list>
+#include <cstdlib>
+#include "IExtension.h"
+
+// A single named parameter for an outgoing message, directly in the POD format passed to
+// IApplication::SendWebMessage(). Nothing is copied: keys are expected to be string literals, and
+// string values must outlive the send. Passing a temporary std::string is not allowed, as it would
+// be destroyed before the send if the parameters are built up with Add() over several statements.
+struct WebMessageParam {
+	NamedExtensionParameterPOD pod;
+
+	WebMessageParam(const char* key, bool b)
+	{
+		pod.key = key;
+		pod.value.type = EPT_Boolean;
+		pod.value.number = b ? 1.0 : 0.0;		// just use number to store the boolean
+		pod.value.str = nullptr;
+	}
+
+	WebMessageParam(const char* key, double n)
+	{
+		pod.key = key;
+		pod.value.type = EPT_Number;
+		pod.value.number = n;
+		pod.value.str = nullptr;
+	}
+
+	WebMessageParam(const char* key, int n)
+		: WebMessageParam(key, static_cast<double>(n))
+	{}
+
+	WebMessageParam(const char* key, const char* s)
+	{
+		pod.key = key;
+		pod.value.type = EPT_String;
+		pod.value.number = 0.0;
+		pod.value.str = s;
+	}
+
+	WebMessageParam(const char* key, const std::string& s)
+		: WebMessageParam(key, s.c_str())
+	{}
+
+	WebMessageParam(const char* key, std::string&& s) = delete;
+};
+
+// Parameters for an outgoing message, stored inline with a fixed capacity. This means building and
+// sending a message does not make any heap allocations. It can be built either from an initializer
+// list, e.g. SendAsyncResponse({ { "isOk", true } }, asyncId), or by calling Add() for messages
+// where the set of parameters varies.
+class WebMessageParams {
+public:
+	static const size_t MAX_PARAMS = 32;
+
+	WebMessageParams()
+		: count(0)
+	{}
+
+	WebMessageParams(std::initializer_list<WebMessageParam> list)
+		: count(0)
+	{
+		for (const WebMessageParam& param : list)
+			Add(param);
+	}
+
+	WebMessageParams& Add(const WebMessageParam& param)
+	{
+		// Silently dropping a parameter would send the Construct plugin an incomplete message, which is
+		// hard to diagnose, so treat this as a fatal error. MAX_PARAMS is well above what any message uses.
+		if (count >= MAX_PARAMS)
+		{
+			PlatformDebugOutput("Fatal: too many parameters for WebMessageParams\n");
+			std::abort();
+		}
+
+		params[count++] = param.pod;
+		return *this;
+	}
+
+	template<typename T>
+	WebMessageParams& Add(const char* key, const T& value)
+	{
+		return Add(WebMessageParam(key, value));
+	}
+
+	WebMessageParams& Add(const char* key, std::string&& value) = delete;
+
+	size_t size() const
+	{
+		return count;
+	}
+
+	const NamedExtensionParameterPOD* data() const
+	{
+		return count == 0 ? nullptr : params;
+	}
+
+protected:
+	NamedExtensionParameterPOD params[MAX_PARAMS];
+	size_t count;
+};
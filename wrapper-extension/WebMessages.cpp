@@ -0,0 +1,106 @@
+
+#include "pch.h"
+#include "WebMessages.h"
+
+WebMessageId LookupWebMessageId(std::string_view messageId)
+{
+	size_t slot = WebMessageSlot(messageId.data(), messageId.size(), WEB_MESSAGE_HASH_SEED);
+	WebMessageId id = static_cast<WebMessageId>(WEB_MESSAGE_SLOTS[slot]);
+
+	// Any string can hash to an occupied slot, so check it really is the message in that slot.
+	if (id == WebMessageId::Unknown || messageId != WEB_MESSAGES[static_cast<size_t>(id)].name)
+		return WebMessageId::Unknown;
+
+	return id;
+}
+
+const char* GetWebMessageName(WebMessageId id)
+{
+	if (id == WebMessageId::Unknown)
+		return "<unknown>";
+
+	return WEB_MESSAGES[static_cast<size_t>(id)].name;
+}
+
+bool WebMessageRequiresProductUserId(WebMessageId id)
+{
+	return id != WebMessageId::Unknown && WEB_MESSAGES[static_cast<size_t>(id)].requiresProductUserId;
+}
+
+bool IsWebMessageParamSensitive(WebMessageId id, size_t index)
+{
+	return id != WebMessageId::Unknown && index < MAX_WEB_MESSAGE_PARAMS &&
+		(WEB_MESSAGES[static_cast<size_t>(id)].sensitiveParamMask & (1u << index)) != 0;
+}
+
+static const char* GetParameterTypeName(ExtensionParameterType type)
+{
+	switch (type) {
+	case EPT_Boolean:
+		return "boolean";
+	case EPT_Number:
+		return "number";
+	case EPT_String:
+		return "string";
+	default:
+		return "invalid";
+	}
+}
+
+bool ValidateWebMessageParams(WebMessageId id, const ExtensionParameterArrayView& params, std::string& errorMessage)
+{
+	const WebMessageDesc& desc = WEB_MESSAGES[static_cast<size_t>(id)];
+
+	if (params.size() != desc.paramCount)
+	{
+		std::stringstream ss;
+		ss << "Message '" << desc.name << "' expects " << desc.paramCount << " parameters but received " << params.size();
+		errorMessage = ss.str();
+		return false;
+	}
+
+	for (size_t i = 0; i < desc.paramCount; ++i)
+	{
+		ExtensionParameterType expectedType = desc.paramTypes[i];
+		ExtensionParameterType actualType = params.GetType(i);
+
+		// Allow numbers in place of booleans, since both use the number field.
+		if (actualType != expectedType && !(expectedType == EPT_Boolean && actualType == EPT_Number))
+		{
+			std::stringstream ss;
+			ss << "Message '" << desc.name << "' expects parameter " << i << " to be " << GetParameterTypeName(expectedType)
+				<< " but received " << GetParameterTypeName(actualType);
+			errorMessage = ss.str();
+			return false;
+		}
+	}
+
+	return true;
+}
+
+AuthScopeParams ReadAuthScopeParams(const ExtensionParameterArrayView& params)
+{
+	AuthScopeParams ret;
+	ret.basicProfile = params.GetBool(0);
+	ret.friendsList = params.GetBool(1);
+	ret.presence = params.GetBool(2);
+	ret.country = params.GetBool(3);
+	return ret;
+}
+
+LogInExchangeCodeParams ReadLogInExchangeCodeParams(const ExtensionParameterArrayView& params)
+{
+	LogInExchangeCodeParams ret;
+	ret.scope = ReadAuthScopeParams(params);
+	ret.exchangeCode = params.GetString(4);
+	return ret;
+}
+
+LogInDevAuthToolParams ReadLogInDevAuthToolParams(const ExtensionParameterArrayView& params)
+{
+	LogInDevAuthToolParams ret;
+	ret.scope = ReadAuthScopeParams(params);
+	ret.host = params.GetString(4);
+	ret.credentialName = params.GetString(5);
+	return ret;
+}
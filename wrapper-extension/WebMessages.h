@@ -0,0 +1,199 @@
+#pragma once
+
+#include <array>
+#include <stdint.h>
+#include "IExtension.h"
+#include "Utils.h"
+
+// This file is the single description of every message the Construct plugin can send to the
+// wrapper extension, and the parameters each one takes. HandleWebMessage() dispatches on the
+// WebMessageId found from the message string, after checking the parameters match this table.
+// The Construct plugin has a corresponding WrapperMessageParams type in instance.ts, which must
+// be kept in sync with this table. The CMake build and the Visual Studio project check this with
+// tools/CheckWebMessages.cpp.
+
+enum class WebMessageId {
+	Init,
+	PlatformTick,
+	GetTickStatus,
+	RunBenchmarks,
+	GetMetrics,
+	GetTickProfile,
+	SetEOSLogLevels,
+	SetSpanTracing,
+	LogInPortal,
+	LogInPersistent,
+	LogInExchangeCode,
+	LogInDevAuthTool,
+	LogOut,
+	UnlockAchievement,
+	UnlockAchievements,
+	IsAchievementUnlocked,
+	GetAchievementProgress,
+
+	Unknown
+};
+
+const size_t MAX_WEB_MESSAGE_PARAMS = 6;
+
+struct WebMessageDesc {
+	WebMessageId id;
+	const char* name;
+	size_t paramCount;
+	ExtensionParameterType paramTypes[MAX_WEB_MESSAGE_PARAMS];
+
+	// Messages that need a product user ID are held back while ConnectLogin() is still in progress.
+	bool requiresProductUserId;
+
+	// Bit i is set if parameter i is a credential, such as an exchange code. These are never written to
+	// message recordings (see MessageRecorder).
+	uint8_t sensitiveParamMask;
+};
+
+constexpr WebMessageDesc WEB_MESSAGES[] = {
+	{ WebMessageId::Init,				"init",					0, {}, false, 0 },
+	{ WebMessageId::PlatformTick,		"platform-tick",		0, {}, false, 0 },
+	{ WebMessageId::GetTickStatus,		"get-tick-status",		0, {}, false, 0 },
+	{ WebMessageId::RunBenchmarks,		"run-benchmarks",		0, {}, false, 0 },
+	{ WebMessageId::GetMetrics,			"get-metrics",			1, { EPT_Boolean }, false, 0 },		// reset after reading
+	{ WebMessageId::GetTickProfile,		"get-tick-profile",		1, { EPT_Boolean }, false, 0 },		// reset after reading
+	{ WebMessageId::SetEOSLogLevels,	"set-eos-log-levels",	1, { EPT_String }, false, 0 },		// e.g. "all=warning, auth=verbose"
+	{ WebMessageId::SetSpanTracing,		"set-span-tracing",		1, { EPT_Boolean }, false, 0 },		// enable, or disable and write the trace
+
+	// Log in messages all start with the auth scope flags: basic profile, friends list, presence, country
+	{ WebMessageId::LogInPortal,		"log-in-portal",		4, { EPT_Boolean, EPT_Boolean, EPT_Boolean, EPT_Boolean }, false, 0 },
+	{ WebMessageId::LogInPersistent,	"log-in-persistent",	4, { EPT_Boolean, EPT_Boolean, EPT_Boolean, EPT_Boolean }, false, 0 },
+	{ WebMessageId::LogInExchangeCode,	"log-in-exchange-code",	5, { EPT_Boolean, EPT_Boolean, EPT_Boolean, EPT_Boolean, EPT_String }, false, 1 << 4 },		// exchange code
+	{ WebMessageId::LogInDevAuthTool,	"log-in-devauthtool",	6, { EPT_Boolean, EPT_Boolean, EPT_Boolean, EPT_Boolean, EPT_String, EPT_String }, false, (1 << 4) | (1 << 5) },		// host, credential name
+	{ WebMessageId::LogOut,				"log-out",				0, {}, false, 0 },
+
+	{ WebMessageId::UnlockAchievement,	"unlock-achievement",	1, { EPT_String }, true, 0 },
+	{ WebMessageId::UnlockAchievements,	"unlock-achievements",	1, { EPT_String }, true, 0 },		// JSON array of achievement IDs
+	{ WebMessageId::IsAchievementUnlocked,	"is-achievement-unlocked",	1, { EPT_String }, true, 0 },
+	{ WebMessageId::GetAchievementProgress,	"get-achievement-progress",	1, { EPT_String }, true, 0 }
+};
+
+const size_t WEB_MESSAGE_COUNT = sizeof(WEB_MESSAGES) / sizeof(WEB_MESSAGES[0]);
+
+// The table must list messages in the same order as the WebMessageId enum, so an ID can index it directly.
+constexpr bool IsWebMessageTableOrdered()
+{
+	for (size_t i = 0; i < WEB_MESSAGE_COUNT; ++i)
+	{
+		if (static_cast<size_t>(WEB_MESSAGES[i].id) != i)
+			return false;
+	}
+
+	return WEB_MESSAGE_COUNT == static_cast<size_t>(WebMessageId::Unknown);
+}
+
+static_assert(IsWebMessageTableOrdered(), "WEB_MESSAGES must list every WebMessageId in enum order");
+
+// Message strings are looked up with a perfect hash: a seeded FNV-1a hash indexes a small table of
+// slots, and a seed is found at compile time such that no two messages share a slot. A lookup is
+// then one hash and a single string comparison to reject unknown messages.
+const size_t WEB_MESSAGE_SLOT_COUNT = 128;		// must be a power of two
+
+constexpr uint32_t HashWebMessageName(const char* str, size_t len, uint32_t seed)
+{
+	uint32_t hash = 2166136261u ^ seed;
+	for (size_t i = 0; i < len; ++i)
+	{
+		hash ^= static_cast<uint8_t>(str[i]);
+		hash *= 16777619u;
+	}
+
+	return hash;
+}
+
+constexpr size_t ConstStrLen(const char* str)
+{
+	size_t len = 0;
+	while (str[len] != '\0')
+		++len;
+	return len;
+}
+
+constexpr size_t WebMessageSlot(const char* str, size_t len, uint32_t seed)
+{
+	return HashWebMessageName(str, len, seed) & (WEB_MESSAGE_SLOT_COUNT - 1);
+}
+
+constexpr bool IsPerfectWebMessageSeed(uint32_t seed)
+{
+	std::array<bool, WEB_MESSAGE_SLOT_COUNT> used = {};
+
+	for (size_t i = 0; i < WEB_MESSAGE_COUNT; ++i)
+	{
+		size_t slot = WebMessageSlot(WEB_MESSAGES[i].name, ConstStrLen(WEB_MESSAGES[i].name), seed);
+		if (used[slot])
+			return false;
+
+		used[slot] = true;
+	}
+
+	return true;
+}
+
+constexpr uint32_t FindPerfectWebMessageSeed()
+{
+	uint32_t seed = 0;
+	while (!IsPerfectWebMessageSeed(seed))
+		++seed;
+	return seed;
+}
+
+constexpr uint32_t WEB_MESSAGE_HASH_SEED = FindPerfectWebMessageSeed();
+
+constexpr std::array<uint8_t, WEB_MESSAGE_SLOT_COUNT> BuildWebMessageSlots()
+{
+	// Unused slots point at the Unknown ID.
+	std::array<uint8_t, WEB_MESSAGE_SLOT_COUNT> slots = {};
+	for (size_t i = 0; i < WEB_MESSAGE_SLOT_COUNT; ++i)
+		slots[i] = static_cast<uint8_t>(WebMessageId::Unknown);
+
+	for (size_t i = 0; i < WEB_MESSAGE_COUNT; ++i)
+		slots[WebMessageSlot(WEB_MESSAGES[i].name, ConstStrLen(WEB_MESSAGES[i].name), WEB_MESSAGE_HASH_SEED)] = static_cast<uint8_t>(i);
+
+	return slots;
+}
+
+constexpr std::array<uint8_t, WEB_MESSAGE_SLOT_COUNT> WEB_MESSAGE_SLOTS = BuildWebMessageSlots();
+
+// Look up the ID for a message string, returning WebMessageId::Unknown if not recognized.
+WebMessageId LookupWebMessageId(std::string_view messageId);
+
+const char* GetWebMessageName(WebMessageId id);
+bool WebMessageRequiresProductUserId(WebMessageId id);
+bool IsWebMessageParamSensitive(WebMessageId id, size_t index);
+
+// Check the parameters passed with a message match the types listed in the message table.
+// Returns false with an error message if they do not.
+bool ValidateWebMessageParams(WebMessageId id, const ExtensionParameterArrayView& params, std::string& errorMessage);
+
+// Typed parameters for messages. These must only be read after ValidateWebMessageParams() succeeds.
+// Messages with a single parameter read it directly with e.g. params.GetString(0), as there is no index
+// to get wrong. Strings are views in to the message's parameters, so must be copied to outlive it.
+struct AuthScopeParams {
+	bool basicProfile;
+	bool friendsList;
+	bool presence;
+	bool country;
+};
+
+AuthScopeParams ReadAuthScopeParams(const ExtensionParameterArrayView& params);
+
+struct LogInExchangeCodeParams {
+	AuthScopeParams scope;
+	std::string_view exchangeCode;
+};
+
+LogInExchangeCodeParams ReadLogInExchangeCodeParams(const ExtensionParameterArrayView& params);
+
+struct LogInDevAuthToolParams {
+	AuthScopeParams scope;
+	std::string_view host;
+	std::string_view credentialName;
+};
+
+LogInDevAuthToolParams ReadLogInDevAuthToolParams(const ExtensionParameterArrayView& params);
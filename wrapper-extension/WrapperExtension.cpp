@@ -2,41 +2,117 @@
 #include "pch.h"
 #include "WrapperExtension.h"
 
+#include "EOSAsync.h"
+#include "EOSCoroutine.h"
+#include "Benchmarks.h"
+
 #include "json.hpp"
 
 const char* COMPONENT_ID = "scirra-epic-games";
 
+// Rate to tick the EOS SDK at when no async operations are in flight.
+const double IDLE_TICK_RATE = 10.0;
+
+// Time to keep ticking at the full rate after an async operation completes, as the EOS SDK often
+// has follow-up work such as login status notifications.
+const std::chrono::seconds BUSY_TICK_GRACE_PERIOD(2);
+
+// Most async messages tracked for recording latencies while waiting for their response.
+const size_t MAX_IN_FLIGHT_MESSAGES = 256;
+
+// Delays before retrying journaled achievement unlocks after a temporary failure. The delay doubles after
+// each failed attempt, up to the maximum.
+const std::chrono::seconds JOURNAL_RETRY_MIN_DELAY(5);
+const std::chrono::seconds JOURNAL_RETRY_MAX_DELAY(300);
+
 //////////////////////////////////////////////////////
 // Boilerplate stuff
+// The extension instance, set by WrapperExtInit() in dllmain.cpp, or by whatever else creates the extension
+// when built for another platform.
 WrapperExtension* g_Extension = nullptr;
 
-// Main DLL export function to initialize extension.
-extern "C" {
-	__declspec(dllexport) IExtension* WrapperExtInit(IApplication* iApplication)
-	{
-		g_Extension = new WrapperExtension(iApplication);
-		return g_Extension;
-	}
-}
-
 // Helper method to call HandleWebMessage() with more useful types, as OnWebMessage() must deal with
-// plain-old-data types for crossing a DLL boundary.
+// plain-old-data types for crossing a DLL boundary. The parameters are passed as a view of the POD
+// array, so nothing is copied unless a handler needs to keep it.
 void WrapperExtension::OnWebMessage(LPCSTR messageId_, size_t paramCount, const ExtensionParameterPOD* paramArr, double asyncId)
 {
-	HandleWebMessage(messageId_, UnpackExtensionParameterArray(paramCount, paramArr), asyncId);
+	// In native tick mode, all EOS SDK calls must happen on the tick thread, so post the message
+	// to run there. In this case the parameters must be copied, as the POD array is only valid
+	// during this call.
+	// The receipt time is passed along for recording latencies (see MessageLatencyMetrics).
+	auto receiptTime = std::chrono::steady_clock::now();
+
+	if (messageRecorder.IsOpen())
+		messageRecorder.RecordWebMessage(messageId_, ExtensionParameterArrayView(paramCount, paramArr), asyncId);
+
+	// Only look up the message name for the trace while tracing, to keep the cost negligible otherwise.
+	const char* traceName = spanTracer.IsTracing() ? GetWebMessageName(LookupWebMessageId(messageId_)) : "";
+	SpanTracer::Scope traceScope(spanTracer, traceName, "message", asyncId);
+
+	if (tickThread.IsRunning())
+	{
+		std::string messageId = messageId_;
+		std::vector<ExtensionParameter> params = UnpackExtensionParameterArray(paramCount, paramArr);
+
+		bool isPosted = tickThread.Post([this, messageId, params, asyncId, receiptTime]()
+		{
+			std::vector<ExtensionParameterPOD> paramPods = PackExtensionParameters(params);
+			HandleWebMessage(messageId, ExtensionParameterArrayView(paramPods.size(), paramPods.data()), asyncId, receiptTime);
+		});
+
+		// The tick thread only drops tasks once the extension is being released.
+		if (!isPosted)
+			Log<ExtLogLevel::Warning>("Dropped message '", messageId, "' received while releasing");
+	}
+	else
+	{
+		HandleWebMessage(messageId_, ExtensionParameterArrayView(paramCount, paramArr), asyncId, receiptTime);
+	}
 }
 
-void WrapperExtension::SendWebMessage(const std::string& messageId, const std::map<std::string, ExtensionParameter>& params, double asyncId)
+// Send a message to JavaScript. The parameters are already in POD format in WebMessageParams' inline
+// storage, so they are passed straight through without any copying or heap allocations.
+void WrapperExtension::SendWebMessage(const char* messageId, const WebMessageParams& params, double asyncId)
 {
-	std::vector<NamedExtensionParameterPOD> paramArr = PackNamedExtensionParameters(params);
-	iApplication->SendWebMessage(messageId.c_str(), paramArr.size(), paramArr.empty() ? nullptr : paramArr.data(), asyncId);
+	TickProfiler::CallbackScope profileScope(tickProfiler, "send-web-message");
+	SpanTracer::Scope traceScope(spanTracer, messageId[0] != '\0' ? messageId : "async-response", "send", asyncId);
+
+	iApplication->SendWebMessage(messageId, params.size(), params.data(), asyncId);
 }
 
 // Helper method for sending a response to an async message (when asyncId is not -1.0).
 // In this case the message ID is not used, so this just calls SendWebMessage() with an empty message ID.
-void WrapperExtension::SendAsyncResponse(const std::map<std::string, ExtensionParameter>& params, double asyncId)
+// Responses to messages that were parked waiting for a product user ID also say how long they waited.
+void WrapperExtension::SendAsyncResponse(const WebMessageParams& params, double asyncId)
 {
-	SendWebMessage("", params, asyncId);
+	auto it = std::find_if(inFlightMessages.begin(), inFlightMessages.end(), [asyncId](const InFlightWebMessage& message)
+	{
+		return message.asyncId == asyncId;
+	});
+
+	if (it != inFlightMessages.end() && it->parkedWait.count() > 0)
+	{
+		WebMessageParams paramsWithWait = params;
+		paramsWithWait.Add("parkedWaitMs", std::chrono::duration<double, std::milli>(it->parkedWait).count());
+		SendWebMessage("", paramsWithWait, asyncId);
+	}
+	else
+		SendWebMessage("", params, asyncId);
+
+	// The message is no longer in flight once it has its response.
+	RecordMessageLatency(asyncId, MessageLatencyStage::Response);
+
+	if (it != inFlightMessages.end())
+	{
+		if (traceLog.IsOpen())
+		{
+			TraceArgs traceArgs;
+			traceArgs.AddValue(asyncId);
+			traceLog.Write(TraceCategory::Response, 0, GetWebMessageName(it->id), traceArgs);
+		}
+
+		inFlightMessages.erase(it);
+	}
 }
 
 //////////////////////////////////////////////////////
@@ -44,15 +120,33 @@ void WrapperExtension::SendAsyncResponse(const std::map<std::string, ExtensionPa
 WrapperExtension::WrapperExtension(IApplication* iApplication_)
 	: iApplication(iApplication_),
 	  hWndMain(NULL),
+	  useTraceLog(false),
 	  didEpicGamesInitOk(false),
 	  isEpicLauncher(false),
 	  sharedHandles{},
 	  hAuth(nullptr),
 	  hConnect(nullptr),
 	  hUserInfo(nullptr),
-	  hAchievements(nullptr)
+	  hAchievements(nullptr),
+	  useNativeTick(false),
+	  nativeTickRate(60.0),
+	  pendingOperationCount(0),
+	  totalOperationCount(0),
+	  tickCount(0),
+	  skippedTickCount(0),
+	  staleCallbackCount(0),
+	  achievementBatchWindow(0),
+	  unlockBatchesInFlight(0),
+	  isJournalRetryScheduled(false),
+	  journalRetryDelay(JOURNAL_RETRY_MIN_DELAY),
+	  isConnectLoginPending(false),
+	  parkedMessageCount(0),
+	  parkedWaitTotal(0),
+	  parkedWaitMax(0)
 {
-	LogMessage("Loaded extension");
+	logger.Start(iApplication);
+
+	Log<ExtLogLevel::Info>("Loaded extension");
 
 	// Tell the host application the SDK version used. Don't change this.
 	iApplication->SetSdkVersion(WRAPPER_EXT_SDK_VERSION);
@@ -62,7 +156,14 @@ WrapperExtension::WrapperExtension(IApplication* iApplication_)
 
 	// Set a shared pointer to the EOS_Shared_Handles struct, so companion plugins
 	// can access the handles created by this extension.
+	sharedHandles.RunOnEOSThread = [](void (*func)(void* userData), void* userData)
+	{
+		g_Extension->RunOnEOSThread(func, userData);
+	};
+
 	iApplication->SetSharedPtr("scirra-epic-games-handles", &sharedHandles);
+
+	inFlightMessages.reserve(MAX_IN_FLIGHT_MESSAGES);
 }
 
 void WrapperExtension::Init()
@@ -105,6 +206,35 @@ void WrapperExtension::Init()
 		sandboxId =			epicProps["sandbox-id"].get<std::string>();
 		deploymentId =		epicProps["deployment-id"].get<std::string>();
 
+		// The native tick settings were added later, so use defaults if they are missing.
+		useNativeTick =		epicProps.value("native-tick", false);
+		nativeTickRate =	epicProps.value("native-tick-rate", 60.0);
+		achievementBatchWindow = std::chrono::milliseconds(epicProps.value("achievement-batch-window", 0));
+
+		eosLogLevelsProperty = epicProps.value("eos-log-levels", "");
+		useTraceLog = epicProps.value("binary-trace-log", false);
+
+		if (epicProps.contains("tick-spike-threshold"))
+			tickProfiler.SetSpikeThreshold(std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double, std::milli>(epicProps["tick-spike-threshold"].get<double>())));
+
+		// Start recording web messages before any arrive, if enabled. The settings that affect processing are
+		// saved in the recording so a replay uses the same ones, but the credentials are left out.
+		if (epicProps.value("message-recording", false))
+		{
+			nlohmann::json recordedSettings = nlohmann::json::object();
+			for (const char* key : { "native-tick", "native-tick-rate", "achievement-batch-window", "tick-spike-threshold", "eos-log-levels" })
+			{
+				if (epicProps.contains(key))
+					recordedSettings[key] = epicProps[key];
+			}
+
+			std::string path = std::string(iApplication->GetCurrentAppDataFolder()) + PLATFORM_PATH_SEPARATOR "EOSExtMessages.bin";
+			if (messageRecorder.Open(path, recordedSettings.dump()))
+				Log<ExtLogLevel::Info>("Recording web messages to EOSExtMessages.bin");
+			else
+				Log<ExtLogLevel::Error>("Failed to open web message recording");
+		}
+
 		// Trim whitespace from all the above strings.
 		TrimString(productName);
 		TrimString(productVersion);
@@ -120,14 +250,15 @@ void WrapperExtension::Init()
 		if (productVersion.empty())
 			productVersion = projectVersion;
 
-		std::stringstream ss;
-		ss << "Parsed package JSON (product name '" << productName << "', product version '" << productVersion << "', product id '" << productId << "', client id '"
-			<< clientId << "', client secret '" << clientSecret << "', sandbox id '" << sandboxId << "', deployment id '" << deploymentId << "'";
-		LogMessage(ss.str());
+		Log<ExtLogLevel::Debug>("Parsed package JSON (product name '", productName, "', product version '", productVersion, "', product id '", productId, "', client id '",
+			clientId, "', client secret '", clientSecret, "', sandbox id '", sandboxId, "', deployment id '", deploymentId, "'");
+
+		if (useNativeTick)
+			Log<ExtLogLevel::Info>("Using native tick at ", nativeTickRate, " ticks per second");
 	}
 	catch (...)
 	{
-		LogMessage("Failed to read properties package JSON");
+		Log<ExtLogLevel::Error>("Failed to read properties package JSON");
 		return;
 	}
 
@@ -138,31 +269,22 @@ void WrapperExtension::InitEpicGamesSDK(const std::string& productName, const st
 {
 	// Dump the full command line to the debug log for diagnostic purposes,
 	// as command line parsing is used to activate some features
-	std::wstring commandLine = GetCommandLine();
-	LogMessage(std::string("Command line: ") + WideToUtf8(GetCommandLine()));
+	Log<ExtLogLevel::Debug>("Command line: ", PlatformGetCommandLine());
 
 	// Detect the Epic launcher and the provided exchange code from the command line.
-	// Use CommandLineToArgvW() to parse the command line for us
-	int argc = 0;
-	LPWSTR* argv = CommandLineToArgvW(commandLine.c_str(), &argc);
-	if (argv != nullptr)
+	// For each command line option
+	for (const std::string& arg : PlatformGetCommandLineArgs())
 	{
-		// For each command line option
-		for (int i = 0; i < argc; ++i)
+		// Check for the -EpicPortal argument indicating started from the Epic Games launcher
+		if (arg == "-EpicPortal")
 		{
-			std::wstring arg = argv[i];
-
-			// Check for the -EpicPortal argument indicating started from the Epic Games launcher
-			if (arg == L"-EpicPortal")
-			{
-				isEpicLauncher = true;
-			}
-			// Check for an argument prefixed -AUTH_PASSWORD= and use the provided value as the
-			// launcher exchange code. This can be used for an automatic login.
-			else if (arg.substr(0, 15) == L"-AUTH_PASSWORD=")
-			{
-				launcherExchangeCode = WideToUtf8(arg.substr(15));
-			}
+			isEpicLauncher = true;
+		}
+		// Check for an argument prefixed -AUTH_PASSWORD= and use the provided value as the
+		// launcher exchange code. This can be used for an automatic login.
+		else if (arg.substr(0, 15) == "-AUTH_PASSWORD=")
+		{
+			launcherExchangeCode = arg.substr(15);
 		}
 	}
 
@@ -176,23 +298,53 @@ void WrapperExtension::InitEpicGamesSDK(const std::string& productName, const st
 
 	if (didEpicGamesInitOk)
 	{
-		LogMessage("Successfully initialized Epic Games SDK");
+		Log<ExtLogLevel::Info>("Successfully initialized Epic Games SDK");
 
 		// Initialize logging
 		EOS_Logging_SetCallback([](const EOS_LogMessage* Message) {
+			TickProfiler::CallbackScope profileScope(g_Extension->GetTickProfiler(), "eos-log");
+			SpanTracer::Scope traceScope(g_Extension->GetSpanTracer(), "eos-log", "eos-callback");
 			g_Extension->OnEOSLogMessage(Message);
 		});
 
+		// Start with a default level for all categories, then apply any levels set in the "eos-log-levels"
+		// property on top. These can also be changed later with the "set-eos-log-levels" message.
 #ifdef _DEBUG
-		EOS_Logging_SetLogLevel(EOS_ELogCategory::EOS_LC_ALL_CATEGORIES, EOS_ELogLevel::EOS_LOG_Verbose);
+		eosLogLevels.Apply({ { EOS_ELogCategory::EOS_LC_ALL_CATEGORIES, EOS_ELogLevel::EOS_LOG_Verbose } });
 #else
-		EOS_Logging_SetLogLevel(EOS_ELogCategory::EOS_LC_ALL_CATEGORIES, EOS_ELogLevel::EOS_LOG_Warning);
+		eosLogLevels.Apply({ { EOS_ELogCategory::EOS_LC_ALL_CATEGORIES, EOS_ELogLevel::EOS_LOG_Warning } });
 #endif
 
+		std::vector<EOSLogLevelSetting> logLevelSettings;
+		std::string errorMessage;
+		if (EOSLogLevels::Parse(eosLogLevelsProperty, logLevelSettings, errorMessage))
+			eosLogLevels.Apply(logLevelSettings);
+		else
+			Log<ExtLogLevel::Error>("Invalid EOS log levels property: ", errorMessage);
+
+		Log<ExtLogLevel::Info>("EOS log levels: ", eosLogLevels.ToString());
+
 		// Initialize platform
 		EOS_Platform_Options platOpts = {};
 		std::string appDataFolder = iApplication->GetCurrentAppDataFolder();
-		std::string cacheDir = appDataFolder + "\\EOSCache\\";
+		std::string cacheDir = appDataFolder + PLATFORM_PATH_SEPARATOR "EOSCache" PLATFORM_PATH_SEPARATOR;
+
+		// Open the binary trace log if enabled, so the rest of startup is traced too.
+		if (useTraceLog)
+		{
+			if (traceLog.Open(appDataFolder + PLATFORM_PATH_SEPARATOR "EOSExtTrace.bin"))
+				Log<ExtLogLevel::Info>("Writing binary trace log to EOSExtTrace.bin");
+			else
+				Log<ExtLogLevel::Error>("Failed to open binary trace log");
+		}
+
+		// Open the achievement unlock journal, next to the EOS cache directory.
+		if (!achievementJournal.Open(appDataFolder + PLATFORM_PATH_SEPARATOR "EOSAchievementJournal.txt"))
+			Log<ExtLogLevel::Error>("Failed to open achievement journal");
+		else if (achievementJournal.GetPendingCount() > 0)
+		{
+			Log<ExtLogLevel::Info>("Achievement journal has ", achievementJournal.GetPendingCount(), " pending unlock(s)");
+		}
 
 		platOpts.ApiVersion = EOS_PLATFORM_OPTIONS_API_LATEST;
 		platOpts.ProductId = productId.c_str();
@@ -219,6 +371,8 @@ void WrapperExtension::InitEpicGamesSDK(const std::string& productName, const st
 		nlscOpts.ApiVersion = EOS_AUTH_ADDNOTIFYLOGINSTATUSCHANGED_API_LATEST;
 		EOS_Auth_AddNotifyLoginStatusChanged(hAuth, &nlscOpts, nullptr, [](const EOS_Auth_LoginStatusChangedCallbackInfo* Data)
 		{
+			TickProfiler::CallbackScope profileScope(g_Extension->GetTickProfiler(), "login-status-changed");
+			SpanTracer::Scope traceScope(g_Extension->GetSpanTracer(), "login-status-changed", "eos-callback");
 			g_Extension->OnLogInStatusChanged(Data);
 		});
 
@@ -226,18 +380,52 @@ void WrapperExtension::InitEpicGamesSDK(const std::string& productName, const st
 		Options.ApiVersion = EOS_CONNECT_ADDNOTIFYAUTHEXPIRATION_API_LATEST;
 		EOS_Connect_AddNotifyAuthExpiration(hConnect, &Options, nullptr, [](const EOS_Connect_AuthExpirationCallbackInfo* Data)
 		{
+			TickProfiler::CallbackScope profileScope(g_Extension->GetTickProfiler(), "connect-auth-expiration");
+			SpanTracer::Scope traceScope(g_Extension->GetSpanTracer(), "connect-auth-expiration", "eos-callback");
 			g_Extension->OnConnectAuthExpiration(Data);
 		});
+
+		// In native tick mode, start the tick thread. From now on all web messages are handled on that thread.
+		if (useNativeTick)
+		{
+			tickThread.Start(nativeTickRate, [this]()
+			{
+				PlatformTick();
+			});
+		}
 	}
 	else
 	{
-		LogMessage("Failed to initialize Epic Games SDK");
+		Log<ExtLogLevel::Error>("Failed to initialize Epic Games SDK");
 	}
 }
 
 void WrapperExtension::Release()
 {
-	LogMessage("Releasing extension");
+	Log<ExtLogLevel::Info>("Releasing extension");
+
+	// Stop the tick thread first so nothing is still using the EOS SDK while it is shut down.
+	tickThread.Stop();
+
+	// Any coroutines still suspended waiting on an EOS call will now never be resumed, so destroy their
+	// frames rather than leaking them.
+	callbackPool.ForEachInUse([](ExtCallbackInfo& callbackInfo)
+	{
+		if (callbackInfo.continuation)
+		{
+			std::coroutine_handle<> continuation = callbackInfo.continuation;
+			callbackInfo.continuation = nullptr;
+			continuation.destroy();
+		}
+	});
+
+	// Release callback info for any operations that never completed. Their handles become stale, so if
+	// a callback still arrives after this (e.g. during EOS_Platform_Release()) it is safely dropped.
+	size_t outstandingCount = callbackPool.ReleaseAll();
+	if (outstandingCount > 0)
+	{
+		Log<ExtLogLevel::Warning>("Warning: ", outstandingCount, " async operation(s) still outstanding at release");
+	}
 
 	if (didEpicGamesInitOk)
 	{
@@ -250,30 +438,268 @@ void WrapperExtension::Release()
 		EOS_EResult shutdownResult = EOS_Shutdown();
 		if (shutdownResult != EOS_EResult::EOS_Success)
 		{
-			LogMessage("Warning: EOS_Shutdown() did not complete successfully");
+			Log<ExtLogLevel::Warning>("Warning: EOS_Shutdown() did not complete successfully");
 		}
 	}
+
+	// Save any span trace still being recorded.
+	if (spanTracer.IsTracing())
+		WriteSpanTrace();
+
+	// Nothing else writes to the trace log, message recording or achievement journal after the EOS SDK is
+	// shut down. Closing the journal also compacts it.
+	traceLog.Close();
+	messageRecorder.Close();
+	achievementJournal.Close();
+
+	// Stop the logger last, so everything logged above is still emitted.
+	logger.Stop();
+}
+
+void WrapperExtension::PlatformTick()
+{
+	if (sharedHandles.hPlatform == nullptr)
+		return;
+
+	// When nothing is in flight, back off to the idle tick rate. In native tick mode the tick thread
+	// rate is adjusted, but otherwise "platform-tick" messages still arrive every frame, so skip calling
+	// EOS_Platform_Tick() until the idle interval has elapsed.
+	auto now = std::chrono::steady_clock::now();
+	if (!tickThread.IsRunning() && !IsTickBusy(now) &&
+		now - lastTickTime < std::chrono::duration<double>(1.0 / IDLE_TICK_RATE))
+	{
+		skippedTickCount++;
+		return;
+	}
+
+	lastTickTime = now;
+	tickCount++;
+
+	// Send any achievement unlocks collected since the last tick, if their batch window has elapsed,
+	// along with any journaled unlocks due to be retried.
+	RetryAchievementJournal(now);
+	FlushAchievementUnlocks(now);
+
+	// Time the tick, along with the callbacks it runs, to find the cause of any long ticks.
+	tickProfiler.BeginTick();
+	{
+		SpanTracer::Scope traceScope(spanTracer, "EOS_Platform_Tick", "tick");
+		EOS_Platform_Tick(sharedHandles.hPlatform);
+	}
+	tickProfiler.EndTick(tickCount);
+
+	// Once a second, report repeats of EOS log messages that have since stopped.
+	if (now - lastLogFlushTime >= std::chrono::seconds(1))
+	{
+		lastLogFlushTime = now;
+
+		// Also write out the message recording, so little is lost if the process crashes.
+		if (messageRecorder.IsOpen())
+			messageRecorder.Flush();
+
+		eosLogRateLimiter.FlushQuiet(now, [this](const LogRateLimiter::RepeatSummary& summary)
+		{
+			LogEOSRepeatSummary(summary);
+		});
+	}
+
+	// Callbacks run during the tick may have completed the last pending operation.
+	if (tickThread.IsRunning())
+		tickThread.SetRate(IsTickBusy(std::chrono::steady_clock::now()) ? nativeTickRate : IDLE_TICK_RATE);
 }
 
-void WrapperExtension::LogMessage(const std::string& msg)
+// For companion plugins, which share the EOS platform handle (see EOS_Shared_Handles). In native tick mode the
+// function is posted to the tick thread like web messages are, otherwise the caller is already on the thread
+// that uses the EOS SDK.
+void WrapperExtension::RunOnEOSThread(void (*func)(void* userData), void* userData)
 {
-	// Log messages both to the browser console with the LogToConsole() method, and also to the debug output
-	// with the DebugLog() helper function, to ensure whichever log we're looking at includes the log messages.
-	std::stringstream ss;
-	ss << "[EpicExt] " << msg;
-	iApplication->LogToConsole(IApplication::LogLevel::normal, ss.str().c_str());
+	if (tickThread.IsRunning() && !tickThread.IsCurrentThread())
+	{
+		bool isPosted = tickThread.Post([func, userData]()
+		{
+			func(userData);
+		});
 
-	// Add trailing newline for debug output
-	ss << "\n";
-	DebugLog(ss.str().c_str());
+		if (!isPosted)
+			Log<ExtLogLevel::Warning>("Dropped companion plugin call made while releasing");
+	}
+	else
+	{
+		func(userData);
+	}
 }
 
-void WrapperExtension::OnEOSLogMessage(const EOS_LogMessage* Message)
+bool WrapperExtension::IsTickBusy(std::chrono::steady_clock::time_point now) const
+{
+	return pendingOperationCount > 0 || !pendingAchievementUnlocks.empty() || now < busyUntilTime;
+}
+
+void WrapperExtension::RequestFullTickRate()
+{
+	// Return to the full tick rate right away so new work is processed promptly.
+	if (tickThread.IsRunning())
+		tickThread.SetRate(nativeTickRate);
+}
+
+ExtCallbackInfo* WrapperExtension::NewCallbackInfo(const char* operationName, double asyncId)
+{
+	void* clientData = nullptr;
+	ExtCallbackInfo* callbackInfo = callbackPool.Acquire(clientData);
+
+	// The pool only runs out with tens of thousands of operations in flight, which indicates callbacks
+	// are not being released; there is no sensible way to recover.
+	if (callbackInfo == nullptr)
+	{
+		Log<ExtLogLevel::Error>("Fatal: callback info pool exhausted");
+		logger.Stop();		// emit the message before aborting
+		std::abort();
+	}
+
+	callbackInfo->extension = this;
+	callbackInfo->asyncId = asyncId;
+	callbackInfo->clientData = clientData;
+	callbackInfo->operationName = operationName;
+	callbackInfo->operationIndex = BeginTimedOperation(operationName);
+	callbackInfo->issueTime = std::chrono::steady_clock::now();
+
+	RecordMessageLatency(asyncId, MessageLatencyStage::EOSCall);
+
+	pendingOperationCount++;
+	totalOperationCount++;
+
+	RequestFullTickRate();
+
+	return callbackInfo;
+}
+
+void WrapperExtension::ReleaseCallbackInfo(ExtCallbackInfo* callbackInfo)
 {
-	// As above but outputting EOS logs directly, tagged [EOSLog].
-	std::stringstream ss;
-	ss << "[EOS][" << Message->Category << "/" << std::to_string(static_cast<int>(Message->Level)) << "] " << Message->Message;
+	pendingOperationCount--;
+	busyUntilTime = std::chrono::steady_clock::now() + BUSY_TICK_GRACE_PERIOD;
 
+	callbackPool.Release(callbackInfo->clientData);
+}
+
+ExtCallbackInfo* WrapperExtension::LookupCallbackInfo(void* clientData)
+{
+	ExtCallbackInfo* callbackInfo = callbackPool.Lookup(clientData);
+	if (callbackInfo == nullptr)
+	{
+		Log<ExtLogLevel::Warning>("Dropping stale callback");
+		staleCallbackCount++;
+	}
+
+	return callbackInfo;
+}
+
+// Record the timing and result of an operation when its callback is received.
+void WrapperExtension::CompleteAsyncOperation(ExtCallbackInfo& callbackInfo, EOS_EResult result)
+{
+	EndTimedOperation(callbackInfo.operationIndex, callbackInfo.issueTime, result);
+
+	RecordMessageLatency(callbackInfo.asyncId, MessageLatencyStage::EOSCallback);
+
+	if (traceLog.IsOpen())
+	{
+		TraceArgs traceArgs;
+		traceArgs.AddValue(callbackInfo.asyncId);
+		traceArgs.AddValue(static_cast<int64_t>(result));
+		traceLog.Write(TraceCategory::EOSCallback, 0, callbackInfo.operationName, traceArgs);
+	}
+
+	if (messageRecorder.IsOpen())
+		messageRecorder.RecordEOSCallback(callbackInfo.operationName, callbackInfo.asyncId, result, std::chrono::steady_clock::now() - callbackInfo.issueTime);
+}
+
+size_t WrapperExtension::BeginTimedOperation(const char* operationName)
+{
+	size_t operationIndex = GetAsyncOperationIndex(operationName);
+	asyncOperationStats[operationIndex].issuedCount++;
+	return operationIndex;
+}
+
+void WrapperExtension::EndTimedOperation(size_t operationIndex, std::chrono::steady_clock::time_point startTime, EOS_EResult result)
+{
+	AsyncOperationStats& stats = asyncOperationStats[operationIndex];
+	auto duration = std::chrono::steady_clock::now() - startTime;
+
+	stats.completedCount++;
+	if (result != EOS_EResult::EOS_Success)
+		stats.failedCount++;
+
+	stats.lastResult = result;
+	stats.totalDuration += duration;
+	stats.maxDuration = std::max(stats.maxDuration, duration);
+}
+
+// There are only a few kinds of operation, so they are found with a linear search.
+size_t WrapperExtension::GetAsyncOperationIndex(const char* operationName)
+{
+	for (size_t i = 0; i < asyncOperationStats.size(); ++i)
+	{
+		if (asyncOperationStats[i].name == operationName)
+			return i;
+	}
+
+	asyncOperationStats.push_back({ operationName, 0, 0, 0, EOS_EResult::EOS_Success, {}, {} });
+	return asyncOperationStats.size() - 1;
+}
+
+// Record a stage of handling a message that is still waiting for its response. There are only ever a few in
+// flight, so they are found with a linear search.
+void WrapperExtension::RecordMessageLatency(double asyncId, MessageLatencyStage stage)
+{
+	if (asyncId == -1.0)
+		return;
+
+	for (const InFlightWebMessage& message : inFlightMessages)
+	{
+		if (message.asyncId == asyncId)
+		{
+			messageLatencyMetrics.Record(message.id, stage, message.receiptTime);
+			return;
+		}
+	}
+}
+
+std::string WrapperExtension::GetAsyncOperationStatsJson() const
+{
+	nlohmann::json ret = nlohmann::json::object();
+
+	for (const AsyncOperationStats& stats : asyncOperationStats)
+	{
+		ret[stats.name] = {
+			{ "issued", stats.issuedCount },
+			{ "completed", stats.completedCount },
+			{ "outstanding", stats.issuedCount - stats.completedCount },
+			{ "failed", stats.failedCount },
+			{ "lastResult", EOS_EResult_ToString(stats.lastResult) },
+			{ "averageMs", stats.completedCount == 0 ? 0.0 : std::chrono::duration<double, std::milli>(stats.totalDuration).count() / stats.completedCount },
+			{ "maxMs", std::chrono::duration<double, std::milli>(stats.maxDuration).count() }
+		};
+	}
+
+	return ret.dump();
+}
+
+void WrapperExtension::EmitLog(ExtLogLevel level, std::string_view msg)
+{
+	// Log messages both to the browser console and to the debug output, to ensure whichever log we're looking
+	// at includes the log messages. The logger thread does this, so this only copies the message to its buffer.
+	TickProfiler::CallbackScope profileScope(tickProfiler, "log-message");
+
+	IApplication::LogLevel consoleLevel = IApplication::LogLevel::normal;
+	if (level == ExtLogLevel::Error)
+		consoleLevel = IApplication::LogLevel::error;
+	else if (level == ExtLogLevel::Warning)
+		consoleLevel = IApplication::LogLevel::warning;
+
+	logger.LogExtensionMessage(consoleLevel, msg);
+}
+
+void WrapperExtension::OnEOSLogMessage(const EOS_LogMessage* Message)
+{
+	// As above but outputting EOS logs, tagged with their category and level.
 	// Copy browser log level from the EOS log level.
 	IApplication::LogLevel logLevel = IApplication::LogLevel::normal;
 	if (Message->Level <= EOS_ELogLevel::EOS_LOG_Error)
@@ -281,11 +707,35 @@ void WrapperExtension::OnEOSLogMessage(const EOS_LogMessage* Message)
 	else if (Message->Level <= EOS_ELogLevel::EOS_LOG_Warning)
 		logLevel = IApplication::LogLevel::warning;
 
-	iApplication->LogToConsole(logLevel, ss.str().c_str());
+	// The SDK can log the same message many times in a row, such as when the network connection drops,
+	// so repeats are rate limited. Report any suppressed repeats before the message that follows them.
+	LogRateLimiter::RepeatSummary repeatSummary, evictedSummary;
+	bool allow = eosLogRateLimiter.Allow(Message->Category, Message->Message, static_cast<int>(Message->Level), logLevel,
+		std::chrono::steady_clock::now(), repeatSummary, evictedSummary);
+
+	if (evictedSummary.suppressedCount > 0)
+		LogEOSRepeatSummary(evictedSummary);
+
+	if (repeatSummary.suppressedCount > 0)
+		LogEOSRepeatSummary(repeatSummary);
+
+	if (!allow)
+		return;
+
+	logger.LogEOSMessage(Message->Category, static_cast<int>(Message->Level), logLevel, Message->Message);
+
+	if (traceLog.IsOpen())
+	{
+		TraceArgs traceArgs;
+		traceArgs.text = Message->Message;
+		traceLog.Write(TraceCategory::EOSLog, static_cast<uint8_t>(static_cast<int>(Message->Level) / 100), Message->Category, traceArgs);
+	}
+}
 
-	// Also send to debug output with trailing newline
-	ss << "\n";
-	DebugLog(ss.str().c_str());
+void WrapperExtension::LogEOSRepeatSummary(const LogRateLimiter::RepeatSummary& summary)
+{
+	std::string msg = FormatLogMessage("Suppressed ", summary.suppressedCount, " repeat(s) of: ", summary.text);
+	logger.LogEOSMessage(summary.category, summary.eosLevel, summary.level, msg.c_str());
 }
 
 void WrapperExtension::OnMainWindowCreated(HWND hWnd)
@@ -294,68 +744,147 @@ void WrapperExtension::OnMainWindowCreated(HWND hWnd)
 }
 
 // For handling a message sent from JavaScript.
-// This method mostly just unpacks parameters and calls a dedicated method to handle the message.
-void WrapperExtension::HandleWebMessage(const std::string& messageId, const std::vector<ExtensionParameter>& params, double asyncId)
+// This method looks up the message in the message table (see WebMessages.h), checks its parameters,
+// and then calls a dedicated method to handle the message with typed parameters.
+void WrapperExtension::HandleWebMessage(std::string_view messageId, const ExtensionParameterArrayView& params, double asyncId, std::chrono::steady_clock::time_point receiptTime, std::chrono::steady_clock::duration parkedWait)
 {
-	if (messageId == "init")
-	{
-		OnInitMessage(asyncId);
-	}
-	else if (messageId == "platform-tick")
+	WebMessageId id = LookupWebMessageId(messageId);
+	std::string errorMessage;
+
+	if (id == WebMessageId::Unknown)
+		errorMessage = "Unknown message '" + std::string(messageId) + "'";
+	else
+		ValidateWebMessageParams(id, params, errorMessage);
+
+	if (!errorMessage.empty())
 	{
-		if (sharedHandles.hPlatform != nullptr)
+		Log<ExtLogLevel::Error>(errorMessage);
+
+		// Resolve any promise waiting on the message rather than leaving it pending forever.
+		if (asyncId != -1.0)
 		{
-			EOS_Platform_Tick(sharedHandles.hPlatform);
+			SendAsyncResponse({
+				{ "isOk", false }
+			}, asyncId);
 		}
+
+		return;
+	}
+
+	// If the message needs a product user ID which is still being obtained, park it until ConnectLogin() completes.
+	if (WebMessageRequiresProductUserId(id) && sharedHandles.productUserId == nullptr && isConnectLoginPending)
+	{
+		parkedMessages.push_back({ std::string(messageId), UnpackExtensionParameterArray(params.size(), params.data()), asyncId, receiptTime });
+		return;
+	}
+
+	messageLatencyMetrics.Record(id, MessageLatencyStage::Dispatch, receiptTime);
+
+	// Trace every message other than the constant stream of ticks, which would soon fill the trace log.
+	if (traceLog.IsOpen() && id != WebMessageId::PlatformTick)
+	{
+		TraceArgs traceArgs;
+		traceArgs.AddValue(asyncId);
+		traceLog.Write(TraceCategory::WebMessage, 0, GetWebMessageName(id), traceArgs);
 	}
-	else if (messageId == "log-in-portal")
+
+	// Track the message until it is responded to. Every async message should get a response, but in case one
+	// does not, limit how many are tracked so the list cannot grow indefinitely.
+	if (asyncId != -1.0)
 	{
-		bool basicProfile = params[0].GetBool();
-		bool friendsList = params[1].GetBool();
-		bool presence = params[2].GetBool();
-		bool country = params[3].GetBool();
+		if (inFlightMessages.size() >= MAX_IN_FLIGHT_MESSAGES)
+			inFlightMessages.erase(inFlightMessages.begin());
 
-		OnLogInPortalMessage(basicProfile, friendsList, presence, country, asyncId);
+		inFlightMessages.push_back({ asyncId, id, receiptTime, parkedWait });
 	}
-	else if (messageId == "log-in-persistent")
+
+	switch (id) {
+	case WebMessageId::Init:
+		OnInitMessage(asyncId);
+		break;
+	case WebMessageId::PlatformTick:
+		// Ignore tick messages in native tick mode, since the tick thread is already ticking.
+		if (!tickThread.IsRunning())
+			PlatformTick();
+		break;
+	case WebMessageId::GetTickStatus:
+		OnGetTickStatusMessage(asyncId);
+		break;
+	case WebMessageId::RunBenchmarks:
+		OnRunBenchmarksMessage(asyncId);
+		break;
+	case WebMessageId::GetMetrics:
+		OnGetMetricsMessage(params.GetBool(0), asyncId);
+		break;
+	case WebMessageId::GetTickProfile:
+		OnGetTickProfileMessage(params.GetBool(0), asyncId);
+		break;
+	case WebMessageId::SetEOSLogLevels:
+		OnSetEOSLogLevelsMessage(params.GetString(0), asyncId);
+		break;
+	case WebMessageId::SetSpanTracing:
+		OnSetSpanTracingMessage(params.GetBool(0), asyncId);
+		break;
+	case WebMessageId::LogInPortal:
 	{
-		bool basicProfile = params[0].GetBool();
-		bool friendsList = params[1].GetBool();
-		bool presence = params[2].GetBool();
-		bool country = params[3].GetBool();
+		AuthScopeParams scope = ReadAuthScopeParams(params);
 
-		OnLogInPersistentMessage(basicProfile, friendsList, presence, country, asyncId);
+		OnLogInPortalMessage(scope.basicProfile, scope.friendsList, scope.presence, scope.country, asyncId);
+		break;
 	}
-	else if (messageId == "log-in-exchange-code")
+	case WebMessageId::LogInPersistent:
 	{
-		bool basicProfile = params[0].GetBool();
-		bool friendsList = params[1].GetBool();
-		bool presence = params[2].GetBool();
-		bool country = params[3].GetBool();
-		const std::string& exchangeCode = params[4].GetString();
+		AuthScopeParams scope = ReadAuthScopeParams(params);
 
-		OnLogInExchangeCodeMessage(basicProfile, friendsList, presence, country, exchangeCode, asyncId);
+		OnLogInPersistentMessage(scope.basicProfile, scope.friendsList, scope.presence, scope.country, asyncId);
+		break;
 	}
-	else if (messageId == "log-in-devauthtool")
+	// Note string parameters are copied in to std::string where they are passed to EOS SDK calls,
+	// since those need null-terminated strings.
+	case WebMessageId::LogInExchangeCode:
 	{
-		bool basicProfile = params[0].GetBool();
-		bool friendsList = params[1].GetBool();
-		bool presence = params[2].GetBool();
-		bool country = params[3].GetBool();
-		const std::string& host = params[4].GetString();
-		const std::string& credentialName = params[5].GetString();
+		LogInExchangeCodeParams logIn = ReadLogInExchangeCodeParams(params);
+		const AuthScopeParams& scope = logIn.scope;
+		std::string exchangeCode(logIn.exchangeCode);
 
-		OnLogInDevAuthToolMessage(basicProfile, friendsList, presence, country, host, credentialName, asyncId);
+		OnLogInExchangeCodeMessage(scope.basicProfile, scope.friendsList, scope.presence, scope.country, exchangeCode, asyncId);
+		break;
 	}
-	else if (messageId == "log-out")
+	case WebMessageId::LogInDevAuthTool:
 	{
-		OnLogOutMessage(asyncId);
+		LogInDevAuthToolParams logIn = ReadLogInDevAuthToolParams(params);
+		const AuthScopeParams& scope = logIn.scope;
+		std::string host(logIn.host);
+		std::string credentialName(logIn.credentialName);
+
+		OnLogInDevAuthToolMessage(scope.basicProfile, scope.friendsList, scope.presence, scope.country, host, credentialName, asyncId);
+		break;
 	}
-	else if (messageId == "unlock-achievement")
+	case WebMessageId::LogOut:
+		OnLogOutMessage(asyncId);
+		break;
+	case WebMessageId::UnlockAchievement:
 	{
-		const std::string& achievementId = params[0].str;
+		std::string achievementId(params.GetString(0));
 
 		OnUnlockAchievementMessage(achievementId, asyncId);
+		break;
+	}
+	case WebMessageId::UnlockAchievements:
+	{
+		std::string achievementIdsJson(params.GetString(0));
+
+		OnUnlockAchievementsMessage(achievementIdsJson, asyncId);
+		break;
+	}
+	case WebMessageId::IsAchievementUnlocked:
+		OnIsAchievementUnlockedMessage(params.GetString(0), asyncId);
+		break;
+	case WebMessageId::GetAchievementProgress:
+		OnGetAchievementProgressMessage(params.GetString(0), asyncId);
+		break;
+	default:
+		break;
 	}
 }
 
@@ -382,91 +911,291 @@ void WrapperExtension::OnInitMessage(double asyncId)
 	}
 }
 
-void WrapperExtension::OnLogInStatusChanged(const EOS_Auth_LoginStatusChangedCallbackInfo* Data)
+void WrapperExtension::OnGetTickStatusMessage(double asyncId)
 {
-	// Send message to JavaScript to fire trigger.
-	SendWebMessage("on-login-status-changed", {
-		{ "loginStatus", static_cast<double>(Data->CurrentStatus) }
-	});
-}
+	bool isBusy = IsTickBusy(std::chrono::steady_clock::now());
+	CoroutineFramePoolStats framePoolStats = GetCoroutineFramePoolStats();
+	std::string asyncOperationsJson = GetAsyncOperationStatsJson();
 
-////////////////////////////////////////////////////////////////////////////////////////////////////////////
-// Log in (portal)
+	// Report the current target tick rate. Outside of native tick mode the busy rate is whatever rate
+	// the Construct plugin sends "platform-tick" messages, which is normally the display refresh rate.
+	SendAsyncResponse({
+		{ "isNativeTick", tickThread.IsRunning() },
+		{ "isBusy", isBusy },
+		{ "tickRate", isBusy ? (tickThread.IsRunning() ? nativeTickRate : -1.0) : IDLE_TICK_RATE },
+		{ "pendingOperationCount", static_cast<double>(pendingOperationCount) },
+		{ "totalOperationCount", static_cast<double>(totalOperationCount) },
+		{ "tickCount", static_cast<double>(tickCount) },
+		{ "skippedTickCount", static_cast<double>(skippedTickCount) },
+		{ "parkedMessageCount", static_cast<double>(parkedMessages.size()) },
+		{ "parkedWaitCount", static_cast<double>(parkedMessageCount) },
+		{ "parkedWaitAverageMs", parkedMessageCount == 0 ? 0.0 : std::chrono::duration<double, std::milli>(parkedWaitTotal).count() / parkedMessageCount },
+		{ "parkedWaitMaxMs", std::chrono::duration<double, std::milli>(parkedWaitMax).count() },
+		{ "callbackSlotCapacity", static_cast<double>(callbackPool.GetCapacity()) },
+		{ "callbackSlotsInUse", static_cast<double>(callbackPool.GetInUseCount()) },
+		{ "callbackSlotsPeak", static_cast<double>(callbackPool.GetPeakInUseCount()) },
+		{ "staleCallbackCount", static_cast<double>(staleCallbackCount) },
+		{ "droppedLogCount", static_cast<double>(logger.GetDroppedCount()) },
+		{ "suppressedEOSLogCount", static_cast<double>(eosLogRateLimiter.GetSuppressedCount()) },
+		{ "asyncOperations", asyncOperationsJson },
+		{ "coroutineFramesInUse", static_cast<double>(framePoolStats.framesInUse) },
+		{ "coroutineFramesPooled", static_cast<double>(framePoolStats.pooledAllocationCount) },
+		{ "coroutineFramesFallback", static_cast<double>(framePoolStats.fallbackAllocationCount) }
+	}, asyncId);
+}
 
-// Helper for determining EOS_EAuthScopeFlags
-EOS_EAuthScopeFlags GetAuthScopeFlags(bool basicProfile, bool friendsList, bool presence, bool country)
+void WrapperExtension::OnRunBenchmarksMessage(double asyncId)
 {
-	EOS_EAuthScopeFlags ret = EOS_EAuthScopeFlags::EOS_AS_NoFlags;
+#ifdef EPICEXT_BENCHMARKS
+	Log<ExtLogLevel::Info>("Running benchmarks");
 
-	if (basicProfile)
-		ret |= EOS_EAuthScopeFlags::EOS_AS_BasicProfile;
-	if (friendsList)
-		ret |= EOS_EAuthScopeFlags::EOS_AS_FriendsList;
-	if (presence)
-		ret |= EOS_EAuthScopeFlags::EOS_AS_Presence;
-	if (country)
-		ret |= EOS_EAuthScopeFlags::EOS_AS_Country;
+	// Log each result and also return all results as a JSON string, which is also saved to a file in the app
+	// data folder for comparing between builds.
+	nlohmann::json resultsJson = nlohmann::json::array();
 
-	return ret;
-}
+	for (const BenchmarkResult& result : RunBenchmarks())
+	{
+		Log<ExtLogLevel::Info>("Benchmark '", result.name, "': ", result.nsPerOp, " ns/op, ", result.allocationsPerOp, " allocations/op");
+
+		resultsJson.push_back({
+			{ "name", result.name },
+			{ "inputSize", result.inputSize },
+			{ "iterations", result.iterations },
+			{ "nsPerOp", result.nsPerOp },
+			{ "allocationsPerOp", result.allocationsPerOp }
+		});
+	}
 
-// Callback for EOS_Auth_Login() that forwards to WrapperExtension::OnLogInPortalCallback()
-void EOS_CALL LoginPortalCompleteCallbackFn(const EOS_Auth_LoginCallbackInfo* Data)
-{
-	ExtCallbackInfo* callbackInfo = static_cast<ExtCallbackInfo*>(Data->ClientData);
-	callbackInfo->extension->OnLogInPortalCallback(Data, callbackInfo->asyncId);
-	delete callbackInfo;
-}
+	std::string path = std::string(iApplication->GetCurrentAppDataFolder()) + PLATFORM_PATH_SEPARATOR "EOSExtBenchmarks.json";
+	if (WriteTextFile(path, resultsJson.dump(1, '\t')))
+	{
+		Log<ExtLogLevel::Info>("Wrote benchmark results to ", path);
+	}
+	else
+	{
+		Log<ExtLogLevel::Error>("Failed to write benchmark results to ", path);
+		path = "";
+	}
 
-void WrapperExtension::OnLogInPortalMessage(bool basicProfile, bool friendsList, bool presence, bool country, double asyncId)
-{
-	LogMessage("Starting log in via portal");
+	std::string results = resultsJson.dump();
 
-	EOS_Auth_Credentials Credentials = {};
+	SendAsyncResponse({
+		{ "isOk", true },
+		{ "results", results },
+		{ "path", path }
+	}, asyncId);
+#else
+	Log<ExtLogLevel::Warning>("Benchmarks are not available: rebuild with EPICEXT_BENCHMARKS defined");
+
+	SendAsyncResponse({
+		{ "isOk", false }
+	}, asyncId);
+#endif
+}
+
+// Latency histograms for each stage of handling each kind of message, for reporting percentiles in
+// telemetry. Optionally reset them afterwards, so each call reports the period since the last one.
+void WrapperExtension::OnGetMetricsMessage(bool reset, double asyncId)
+{
+	std::string metricsJson = messageLatencyMetrics.GetJson();
+
+	if (reset)
+		messageLatencyMetrics.Clear();
+
+	SendAsyncResponse({
+		{ "isOk", true },
+		{ "metrics", metricsJson }
+	}, asyncId);
+}
+
+// The tick duration histogram and the worst tick spikes, with the callbacks that ran in them.
+void WrapperExtension::OnGetTickProfileMessage(bool reset, double asyncId)
+{
+	std::string profileJson = tickProfiler.GetJson();
+
+	if (reset)
+		tickProfiler.Clear();
+
+	SendAsyncResponse({
+		{ "isOk", true },
+		{ "profile", profileJson }
+	}, asyncId);
+}
+
+// Change EOS log levels at runtime, e.g. to enable verbose logging for one category in a live build. The
+// response includes the resulting levels for all categories.
+void WrapperExtension::OnSetEOSLogLevelsMessage(std::string_view logLevels, double asyncId)
+{
+	std::vector<EOSLogLevelSetting> logLevelSettings;
+	std::string errorMessage;
+
+	if (!didEpicGamesInitOk)
+		errorMessage = "Epic Games SDK not initialized";
+	else if (EOSLogLevels::Parse(logLevels, logLevelSettings, errorMessage))
+		eosLogLevels.Apply(logLevelSettings);
+
+	if (!errorMessage.empty())
+	{
+		Log<ExtLogLevel::Error>("Failed to set EOS log levels: ", errorMessage);
+
+		SendAsyncResponse({
+			{ "isOk", false }
+		}, asyncId);
+		return;
+	}
+
+	std::string logLevelsStr = eosLogLevels.ToString();
+	Log<ExtLogLevel::Info>("EOS log levels: ", logLevelsStr);
+
+	SendAsyncResponse({
+		{ "isOk", true },
+		{ "logLevels", logLevelsStr }
+	}, asyncId);
+}
+
+// Start or stop recording spans for a timeline of how messages, ticks and callbacks interleave. Stopping
+// writes the trace to the app data folder, and the response includes its path.
+void WrapperExtension::OnSetSpanTracingMessage(bool enable, double asyncId)
+{
+	if (enable)
+	{
+		spanTracer.Start();
+		Log<ExtLogLevel::Info>("Started span tracing");
+
+		SendAsyncResponse({
+			{ "isOk", true }
+		}, asyncId);
+		return;
+	}
+
+	std::string path;
+	if (spanTracer.IsTracing())
+		path = WriteSpanTrace();
+
+	SendAsyncResponse({
+		{ "isOk", !path.empty() },
+		{ "path", path },
+		{ "spanCount", static_cast<double>(spanTracer.GetSpanCount()) },
+		{ "droppedSpanCount", static_cast<double>(spanTracer.GetDroppedCount()) }
+	}, asyncId);
+}
+
+// Stop span tracing and write the spans as Chrome trace-event JSON, which can be loaded in chrome://tracing or
+// Perfetto. Returns the path of the file, or an empty string if it could not be written.
+std::string WrapperExtension::WriteSpanTrace()
+{
+	spanTracer.Stop();
+
+	std::string path = std::string(iApplication->GetCurrentAppDataFolder()) + PLATFORM_PATH_SEPARATOR "EOSExtSpanTrace.json";
+	if (!WriteTextFile(path, spanTracer.GetJson()))
+	{
+		Log<ExtLogLevel::Error>("Failed to write span trace to ", path);
+		return "";
+	}
+
+	Log<ExtLogLevel::Info>("Wrote ", spanTracer.GetSpanCount(), " span(s) to ", path);
+	return path;
+}
+
+void WrapperExtension::OnLogInStatusChanged(const EOS_Auth_LoginStatusChangedCallbackInfo* Data)
+{
+	// Send message to JavaScript to fire trigger.
+	SendWebMessage("on-login-status-changed", {
+		{ "loginStatus", static_cast<double>(Data->CurrentStatus) }
+	});
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Log in (portal)
+
+// Helper for determining EOS_EAuthScopeFlags
+EOS_EAuthScopeFlags GetAuthScopeFlags(bool basicProfile, bool friendsList, bool presence, bool country)
+{
+	EOS_EAuthScopeFlags ret = EOS_EAuthScopeFlags::EOS_AS_NoFlags;
+
+	if (basicProfile)
+		ret |= EOS_EAuthScopeFlags::EOS_AS_BasicProfile;
+	if (friendsList)
+		ret |= EOS_EAuthScopeFlags::EOS_AS_FriendsList;
+	if (presence)
+		ret |= EOS_EAuthScopeFlags::EOS_AS_Presence;
+	if (country)
+		ret |= EOS_EAuthScopeFlags::EOS_AS_Country;
+
+	return ret;
+}
+
+void WrapperExtension::OnLogInPortalMessage(bool basicProfile, bool friendsList, bool presence, bool country, double asyncId)
+{
+	Log<ExtLogLevel::Debug>("Starting log in via portal");
+
+	LogInFlow("portal", EOS_ELoginCredentialType::EOS_LCT_AccountPortal, GetAuthScopeFlags(basicProfile, friendsList, presence, country), "", "", asyncId);
+}
+
+// The whole log in process, shared by all the log in methods: log in with the given credentials, read the
+// user info, and start obtaining a product user ID. The promise is resolved without waiting for the product
+// user ID, so ConnectLoginFlow() continues concurrently.
+EOSTask WrapperExtension::LogInFlow(const char* flowName, EOS_ELoginCredentialType credentialType, EOS_EAuthScopeFlags scopeFlags, std::string id, std::string token, double asyncId)
+{
+	std::string flowOperationName = std::string("flow-log-in-") + flowName;
+	size_t flowIndex = BeginTimedOperation(flowOperationName.c_str());
+	auto flowStartTime = std::chrono::steady_clock::now();
+
+	EOS_Auth_Credentials Credentials = {};
 	Credentials.ApiVersion = EOS_AUTH_CREDENTIALS_API_LATEST;
-	Credentials.Type = EOS_ELoginCredentialType::EOS_LCT_AccountPortal;
+	Credentials.Type = credentialType;
+	Credentials.Id = id.empty() ? nullptr : id.c_str();
+	Credentials.Token = token.empty() ? nullptr : token.c_str();
 
 	EOS_Auth_LoginOptions LoginOptions = {};
 	LoginOptions.ApiVersion = EOS_AUTH_LOGIN_API_LATEST;
-	LoginOptions.ScopeFlags = GetAuthScopeFlags(basicProfile, friendsList, presence, country);
+	LoginOptions.ScopeFlags = scopeFlags;
 	LoginOptions.Credentials = &Credentials;
 
-	ExtCallbackInfo* callbackInfo = new ExtCallbackInfo();
-	callbackInfo->extension = this;
-	callbackInfo->asyncId = asyncId;
+	EOS_Auth_LoginCallbackInfo loginResult = co_await AwaitEOS("auth-login", EOS_Auth_Login, hAuth, LoginOptions, asyncId);
 
-	EOS_Auth_Login(hAuth, &LoginOptions, callbackInfo, LoginPortalCompleteCallbackFn);
-}
-
-void WrapperExtension::OnLogInPortalCallback(const EOS_Auth_LoginCallbackInfo* Data, double asyncId)
-{
-	if (Data->ResultCode == EOS_EResult::EOS_Success)
+	if (loginResult.ResultCode == EOS_EResult::EOS_Success)
 	{
-		LogMessage("OnLogInPortalCallback: success");
+		Log<ExtLogLevel::Debug>("LogInFlow (", flowName, "): success");
 
-		HandleSuccessfulLogIn(Data, asyncId);
+		HandleSuccessfulLogIn(&loginResult, asyncId);
 	}
 	else	// login failed
 	{
-		LogMessage("OnLogInPortalCallback: failed");
+		Log<ExtLogLevel::Error>("LogInFlow (", flowName, "): failed");
+
+		// If persistent login failed, delete the persistent auth so it does not use the same
+		// persisted auth again next time.
+		if (credentialType == EOS_ELoginCredentialType::EOS_LCT_PersistentAuth)
+		{
+			EOS_Auth_DeletePersistentAuthOptions delOpts = {};
+			delOpts.ApiVersion = EOS_AUTH_DELETEPERSISTENTAUTH_API_LATEST;
+			CallEOSAsync<&WrapperExtension::OnDeletePersistentAuthCallback>("auth-delete-persistent", EOS_Auth_DeletePersistentAuth, hAuth, delOpts);
+		}
 
 		SendAsyncResponse({
 			{ "isOk", false }
 		}, asyncId);
 	}
+
+	EndTimedOperation(flowIndex, flowStartTime, loginResult.ResultCode);
 }
 
 void WrapperExtension::HandleSuccessfulLogIn(const EOS_Auth_LoginCallbackInfo* Data, double asyncId)
 {
 	sharedHandles.epicAccountId = Data->LocalUserId;
 
-	// Convert epic account ID to string
-	std::string epicAccountIdStr(EOS_EPICACCOUNTID_MAX_LENGTH + 1, 0);
+	// Convert epic account ID to string. This is also used to record journaled achievement unlocks against the user.
+	epicAccountIdStr.assign(EOS_EPICACCOUNTID_MAX_LENGTH + 1, 0);
 	int32_t outSize = static_cast<int32_t>(epicAccountIdStr.size());
 	if (EOS_EpicAccountId_ToString(Data->LocalUserId, &epicAccountIdStr[0], &outSize) != EOS_EResult::EOS_Success)
 	{
 		epicAccountIdStr = "";
 	}
+	else
+	{
+		epicAccountIdStr = std::string(epicAccountIdStr.c_str());		// trim the unused space
+	}
 
 	// Call EOS_UserInfo_CopyUserInfo to get a EOS_UserInfo struct with details about the user
 	EOS_UserInfo_CopyUserInfoOptions copyOpts = {};
@@ -477,7 +1206,7 @@ void WrapperExtension::HandleSuccessfulLogIn(const EOS_Auth_LoginCallbackInfo* D
 	EOS_UserInfo* userInfo = nullptr;
 	if (EOS_UserInfo_CopyUserInfo(hUserInfo, &copyOpts, &userInfo) == EOS_EResult::EOS_Success)
 	{
-		LogMessage("EOS_UserInfo_CopyUserInfo succeeded");
+		Log<ExtLogLevel::Debug>("EOS_UserInfo_CopyUserInfo succeeded");
 
 		// Copy user info to std::strings. Use a utility method that returns an empty
 		// string if passed nullptr since unavailable fields are set to nullptr.
@@ -492,14 +1221,14 @@ void WrapperExtension::HandleSuccessfulLogIn(const EOS_Auth_LoginCallbackInfo* D
 	}
 	else
 	{
-		LogMessage("EOS_UserInfo_CopyUserInfo failed");
+		Log<ExtLogLevel::Error>("EOS_UserInfo_CopyUserInfo failed");
 	}
 
 	// Use the Connect service to automatically attempt to obtain a Product User ID (PUID) for the
 	// user who just logged in associated with Epic services, in order to use achievements.
 	// Note that for the convenience of the Construct addon, the login process does not wait for this
-	// to complete; instead it's just assumed this will be ready by the time any achievements are
-	// attempted to be activated. If no PUID could be obtained, then unlocking an achievement will fail.
+	// to complete. Instead any achievement messages received in the meantime are parked until it does
+	// (see ResolveParkedMessages()).
 	ConnectLogin();
 
 	// Send async response to resolve JavaScript promise
@@ -517,67 +1246,98 @@ void WrapperExtension::HandleSuccessfulLogIn(const EOS_Auth_LoginCallbackInfo* D
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Log in (persistent)
 
-// Callback for EOS_Auth_Login() that forwards to WrapperExtension::OnLogInPersistentCallback()
-void EOS_CALL LoginPersistentCompleteCallbackFn(const EOS_Auth_LoginCallbackInfo* Data)
-{
-	ExtCallbackInfo* callbackInfo = static_cast<ExtCallbackInfo*>(Data->ClientData);
-	callbackInfo->extension->OnLogInPersistentCallback(Data, callbackInfo->asyncId);
-	delete callbackInfo;
-}
-
 void WrapperExtension::OnDeletePersistentAuthCallback(const EOS_Auth_DeletePersistentAuthCallbackInfo* Data)
 {
 	// Just log the success/failure result for debugging.
 	if (Data->ResultCode == EOS_EResult::EOS_Success)
 	{
-		LogMessage("DeletePersistentAuthCallbackFn: success");
+		Log<ExtLogLevel::Debug>("DeletePersistentAuthCallbackFn: success");
 	}
 	else
 	{
-		LogMessage("DeletePersistentAuthCallbackFn: failed");
+		Log<ExtLogLevel::Error>("DeletePersistentAuthCallbackFn: failed");
 	}
 }
 
 void WrapperExtension::OnLogInPersistentMessage(bool basicProfile, bool friendsList, bool presence, bool country, double asyncId)
 {
-	LogMessage("Starting log in via persistent auth");
+	Log<ExtLogLevel::Debug>("Starting log in via persistent auth");
 
-	EOS_Auth_Credentials Credentials = {};
-	Credentials.ApiVersion = EOS_AUTH_CREDENTIALS_API_LATEST;
-	Credentials.Type = EOS_ELoginCredentialType::EOS_LCT_PersistentAuth;
+	LogInFlow("persistent", EOS_ELoginCredentialType::EOS_LCT_PersistentAuth, GetAuthScopeFlags(basicProfile, friendsList, presence, country), "", "", asyncId);
+}
 
-	EOS_Auth_LoginOptions LoginOptions = {};
-	LoginOptions.ApiVersion = EOS_AUTH_LOGIN_API_LATEST;
-	LoginOptions.ScopeFlags = GetAuthScopeFlags(basicProfile, friendsList, presence, country);
-	LoginOptions.Credentials = &Credentials;
+////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Log in (exchange code)
 
-	ExtCallbackInfo* callbackInfo = new ExtCallbackInfo();
-	callbackInfo->extension = this;
-	callbackInfo->asyncId = asyncId;
+void WrapperExtension::OnLogInExchangeCodeMessage(bool basicProfile, bool friendsList, bool presence, bool country, const std::string& exchangeCode, double asyncId)
+{
+	Log<ExtLogLevel::Debug>("Starting log in via exchange code");
+
+	LogInFlow("exchange-code", EOS_ELoginCredentialType::EOS_LCT_ExchangeCode, GetAuthScopeFlags(basicProfile, friendsList, presence, country), "", exchangeCode, asyncId);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Log in (DevAuthTool)
+
+void WrapperExtension::OnLogInDevAuthToolMessage(bool basicProfile, bool friendsList, bool presence, bool country, const std::string& host, const std::string& credentialName, double asyncId)
+{
+	Log<ExtLogLevel::Debug>("Starting log in via DevAuthTool");
+
+	LogInFlow("devauthtool", EOS_ELoginCredentialType::EOS_LCT_Developer, GetAuthScopeFlags(basicProfile, friendsList, presence, country), host, credentialName, asyncId);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Log out
+
+void WrapperExtension::OnLogOutMessage(double asyncId)
+{
+	Log<ExtLogLevel::Debug>("Starting log out");
+
+	EOS_Auth_LogoutOptions LogoutOptions = {};
+	LogoutOptions.ApiVersion = EOS_AUTH_LOGOUT_API_LATEST;
+	LogoutOptions.LocalUserId = sharedHandles.epicAccountId;
 
-	EOS_Auth_Login(hAuth, &LoginOptions, callbackInfo, LoginPersistentCompleteCallbackFn);
+	CallEOSAsync<&WrapperExtension::OnLogOutCallback>("auth-logout", EOS_Auth_Logout, hAuth, LogoutOptions, asyncId);
 }
 
-void WrapperExtension::OnLogInPersistentCallback(const EOS_Auth_LoginCallbackInfo* Data, double asyncId)
+void WrapperExtension::OnLogOutCallback(const EOS_Auth_LogoutCallbackInfo* Data, double asyncId)
 {
 	if (Data->ResultCode == EOS_EResult::EOS_Success)
 	{
-		LogMessage("OnLogInPersistentCallback: success");
+		Log<ExtLogLevel::Debug>("OnLogOutCallback: success");
 
-		HandleSuccessfulLogIn(Data, asyncId);
-	}
-	else	// login failed
-	{
-		LogMessage("OnLogInPersistentCallback: failed");
+		// Unlocks queued for the next batch belong to the user logging out, so must not be sent.
+		DropPendingAchievementUnlocks();
+		isJournalRetryScheduled = false;
+		journalRetryDelay = JOURNAL_RETRY_MIN_DELAY;
 
-		// Persistent login failed, so delete the persistent auth so it does not use the same
-		// persisted auth again next time.
+		// Drop the user's acknowledged unlocks from the journal, rather than waiting for more to build up.
+		achievementJournal.Compact();
+
+		// Clear details set when logged in
+		sharedHandles.epicAccountId = nullptr;
+		sharedHandles.productUserId = nullptr;
+		epicAccountIdStr = "";
+		userDisplayName = "";
+		userDisplayNameSanitized = "";
+		userNickname = "";
+		userPreferredLanguage = "";
+		userCountry = "";
+		achievementCache.Clear();
+
+		// User logged out OK, so also delete any persisted auth to prevent any future
+		// automatic login.
 		EOS_Auth_DeletePersistentAuthOptions delOpts = {};
 		delOpts.ApiVersion = EOS_AUTH_DELETEPERSISTENTAUTH_API_LATEST;
-		EOS_Auth_DeletePersistentAuth(hAuth, &delOpts, nullptr, [](const EOS_Auth_DeletePersistentAuthCallbackInfo* Data)
-		{
-			g_Extension->OnDeletePersistentAuthCallback(Data);
-		});
+		CallEOSAsync<&WrapperExtension::OnDeletePersistentAuthCallback>("auth-delete-persistent", EOS_Auth_DeletePersistentAuth, hAuth, delOpts);
+
+		SendAsyncResponse({
+			{ "isOk", true }
+		}, asyncId);
+	}
+	else
+	{
+		Log<ExtLogLevel::Error>("OnLogOutCallback: failed");
 
 		SendAsyncResponse({
 			{ "isOk", false }
@@ -586,233 +1346,390 @@ void WrapperExtension::OnLogInPersistentCallback(const EOS_Auth_LoginCallbackInf
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////
-// Log in (exchange code)
+// Achievements
+// Note this assumes ConnectLogin() completed successfully and set a valid productUserId.
 
-// Callback for EOS_Auth_Login() that forwards to WrapperExtension::OnLogInExchangeCodeCallback()
-void EOS_CALL LoginExchangeCodeCompleteCallbackFn(const EOS_Auth_LoginCallbackInfo* Data)
+// Unlock requests are not sent immediately. Instead they are queued and sent together in a single
+// EOS_Achievements_UnlockAchievements() call once the batch window elapses (see FlushAchievementUnlocks()),
+// so unlocking several achievements at once only makes one backend call.
+
+void WrapperExtension::OnUnlockAchievementMessage(const std::string& achievementId, double asyncId)
 {
-	ExtCallbackInfo* callbackInfo = static_cast<ExtCallbackInfo*>(Data->ClientData);
-	callbackInfo->extension->OnLogInExchangeCodeCallback(Data, callbackInfo->asyncId);
-	delete callbackInfo;
+	QueueAchievementUnlock({ achievementId }, asyncId);
 }
 
-void WrapperExtension::OnLogInExchangeCodeMessage(bool basicProfile, bool friendsList, bool presence, bool country, const std::string& exchangeCode, double asyncId)
+void WrapperExtension::OnUnlockAchievementsMessage(const std::string& achievementIdsJson, double asyncId)
 {
-	LogMessage("Starting log in via exchange code");
-
-	EOS_Auth_Credentials Credentials = {};
-	Credentials.ApiVersion = EOS_AUTH_CREDENTIALS_API_LATEST;
-	Credentials.Type = EOS_ELoginCredentialType::EOS_LCT_ExchangeCode;
-	Credentials.Token = exchangeCode.c_str();
+	// The achievement IDs are passed as a JSON array of strings.
+	std::vector<std::string> achievementIds;
 
-	EOS_Auth_LoginOptions LoginOptions = {};
-	LoginOptions.ApiVersion = EOS_AUTH_LOGIN_API_LATEST;
-	LoginOptions.ScopeFlags = GetAuthScopeFlags(basicProfile, friendsList, presence, country);
-	LoginOptions.Credentials = &Credentials;
+	try {
+		achievementIds = nlohmann::json::parse(achievementIdsJson).get<std::vector<std::string>>();
+	}
+	catch (...)
+	{
+		Log<ExtLogLevel::Error>("Failed to parse achievement IDs for unlock-achievements");
 
-	ExtCallbackInfo* callbackInfo = new ExtCallbackInfo();
-	callbackInfo->extension = this;
-	callbackInfo->asyncId = asyncId;
+		SendAsyncResponse({
+			{ "isOk", false }
+		}, asyncId);
+		return;
+	}
 
-	EOS_Auth_Login(hAuth, &LoginOptions, callbackInfo, LoginExchangeCodeCompleteCallbackFn);
+	QueueAchievementUnlock(std::move(achievementIds), asyncId);
 }
 
-void WrapperExtension::OnLogInExchangeCodeCallback(const EOS_Auth_LoginCallbackInfo* Data, double asyncId)
+void WrapperExtension::QueueAchievementUnlock(std::vector<std::string> achievementIds, double asyncId)
 {
-	if (Data->ResultCode == EOS_EResult::EOS_Success)
+	// Skip any achievements the player already has. If that leaves nothing to unlock, the request
+	// succeeds immediately without a backend call.
+	achievementIds.erase(std::remove_if(achievementIds.begin(), achievementIds.end(), [this](const std::string& achievementId)
 	{
-		LogMessage("OnLogInExchangeCodeCallback: success");
+		return achievementCache.IsUnlocked(achievementId);
+	}), achievementIds.end());
 
-		HandleSuccessfulLogIn(Data, asyncId);
+	if (achievementIds.empty())
+	{
+		Log<ExtLogLevel::Debug>("Achievement unlock skipped: already unlocked");
+
+		SendAsyncResponse({
+			{ "isOk", true }
+		}, asyncId);
+		return;
 	}
-	else	// login failed
+
+	// Record the unlock in the journal before sending it, so it is not lost if it cannot be sent now.
+	bool isJournaled = achievementJournal.AddPending(epicAccountIdStr, achievementIds);
+
+	// Without a product user ID the unlock cannot be sent yet. If it was saved to the journal, it will be
+	// sent once ConnectLogin() succeeds, so report it as deferred rather than failed.
+	if (sharedHandles.productUserId == nullptr)
 	{
-		LogMessage("OnLogInExchangeCodeCallback: failed");
+		if (isJournaled)
+			Log<ExtLogLevel::Info>("Achievement unlock deferred: no product user ID");
+		else
+			Log<ExtLogLevel::Error>("Achievement unlock failed: no product user ID");
 
 		SendAsyncResponse({
-			{ "isOk", false }
+			{ "isOk", isJournaled },
+			{ "isDeferred", isJournaled }
 		}, asyncId);
+		return;
 	}
-}
 
-////////////////////////////////////////////////////////////////////////////////////////////////////////////
-// Log in (DevAuthTool)
+	if (pendingAchievementUnlocks.empty())
+		firstPendingAchievementUnlockTime = std::chrono::steady_clock::now();
 
-// Callback for EOS_Auth_Login() that forwards to WrapperExtension::OnLogInDevAuthToolCallback()
-void EOS_CALL LoginDevAuthToolCompleteCallbackFn(const EOS_Auth_LoginCallbackInfo* Data)
-{
-	ExtCallbackInfo* callbackInfo = static_cast<ExtCallbackInfo*>(Data->ClientData);
-	callbackInfo->extension->OnLogInDevAuthToolCallback(Data, callbackInfo->asyncId);
-	delete callbackInfo;
+	pendingAchievementUnlocks.push_back({ std::move(achievementIds), asyncId, epicAccountIdStr });
+
+	RequestFullTickRate();
 }
 
-void WrapperExtension::OnLogInDevAuthToolMessage(bool basicProfile, bool friendsList, bool presence, bool country, const std::string& host, const std::string& credentialName, double asyncId)
+// Queue any unlocks left in the journal from earlier for the logged in user, e.g. made while offline or in a
+// previous session. These are sent in the next batch along with any other unlocks, and have no async response.
+void WrapperExtension::ReplayAchievementJournal()
 {
-	LogMessage("Starting log in via DevAuthTool");
+	std::vector<std::string> pendingIds = achievementJournal.GetPending(epicAccountIdStr);
+	if (pendingIds.empty())
+		return;
 
-	EOS_Auth_Credentials Credentials = {};
-	Credentials.ApiVersion = EOS_AUTH_CREDENTIALS_API_LATEST;
-	Credentials.Type = EOS_ELoginCredentialType::EOS_LCT_Developer;
-	Credentials.Id = host.c_str();
-	Credentials.Token = credentialName.c_str();
+	Log<ExtLogLevel::Info>("Replaying ", pendingIds.size(), " journaled achievement unlock(s)");
 
-	EOS_Auth_LoginOptions LoginOptions = {};
-	LoginOptions.ApiVersion = EOS_AUTH_LOGIN_API_LATEST;
-	LoginOptions.ScopeFlags = GetAuthScopeFlags(basicProfile, friendsList, presence, country);
-	LoginOptions.Credentials = &Credentials;
+	if (pendingAchievementUnlocks.empty())
+		firstPendingAchievementUnlockTime = std::chrono::steady_clock::now();
 
-	ExtCallbackInfo* callbackInfo = new ExtCallbackInfo();
-	callbackInfo->extension = this;
-	callbackInfo->asyncId = asyncId;
+	pendingAchievementUnlocks.push_back({ std::move(pendingIds), -1.0, epicAccountIdStr });
 
-	EOS_Auth_Login(hAuth, &LoginOptions, callbackInfo, LoginDevAuthToolCompleteCallbackFn);
+	RequestFullTickRate();
 }
 
-void WrapperExtension::OnLogInDevAuthToolCallback(const EOS_Auth_LoginCallbackInfo* Data, double asyncId)
+// Called from PlatformTick() to queue the logged in user's journaled unlocks again once their retry is due.
+// This waits until no other unlocks are queued or in flight, so the same unlocks are not sent twice.
+void WrapperExtension::RetryAchievementJournal(std::chrono::steady_clock::time_point now)
 {
-	if (Data->ResultCode == EOS_EResult::EOS_Success)
+	if (!isJournalRetryScheduled || now < journalRetryTime || sharedHandles.productUserId == nullptr ||
+		unlockBatchesInFlight > 0 || !pendingAchievementUnlocks.empty())
 	{
-		LogMessage("OnLogInDevAuthToolCallback: success");
+		return;
+	}
+
+	isJournalRetryScheduled = false;
+	ReplayAchievementJournal();
+}
+
+// Called after an unlock batch completes. If the logged in user still has unlocks in the journal, schedule
+// retrying them, backing off further if the batch failed.
+void WrapperExtension::ScheduleAchievementJournalRetry(bool isFailure)
+{
+	if (!isFailure)
+		journalRetryDelay = JOURNAL_RETRY_MIN_DELAY;
+
+	isJournalRetryScheduled = achievementJournal.HasPending(epicAccountIdStr);
+	if (!isJournalRetryScheduled)
+		return;
 
-		HandleSuccessfulLogIn(Data, asyncId);
+	journalRetryTime = std::chrono::steady_clock::now() + (isFailure ? journalRetryDelay : std::chrono::steady_clock::duration::zero());
+
+	if (isFailure)
+	{
+		Log<ExtLogLevel::Info>("Retrying journaled achievement unlocks in ", std::chrono::duration_cast<std::chrono::seconds>(journalRetryDelay).count(), " s");
+		journalRetryDelay = std::min<std::chrono::steady_clock::duration>(journalRetryDelay * 2, JOURNAL_RETRY_MAX_DELAY);
 	}
-	else	// login failed
+}
+
+// Discard unlocks waiting for the next batch, e.g. when the user logs out. They are still in the journal
+// (unless writing it failed), so are sent the next time the same user logs in, and are reported as deferred.
+void WrapperExtension::DropPendingAchievementUnlocks()
+{
+	if (pendingAchievementUnlocks.empty())
+		return;
+
+	Log<ExtLogLevel::Debug>("Dropping ", pendingAchievementUnlocks.size(), " queued achievement unlock request(s)");
+
+	std::vector<AchievementUnlockRequest> requests;
+	requests.swap(pendingAchievementUnlocks);
+
+	for (const AchievementUnlockRequest& request : requests)
 	{
-		LogMessage("OnLogInDevAuthToolCallback: failed");
+		if (request.asyncId == -1.0)
+			continue;
+
+		bool isDeferred = std::all_of(request.achievementIds.begin(), request.achievementIds.end(), [this, &request](const std::string& achievementId)
+		{
+			return achievementJournal.IsPending(request.accountId, achievementId);
+		});
 
 		SendAsyncResponse({
-			{ "isOk", false }
-		}, asyncId);
+			{ "isOk", isDeferred },
+			{ "isDeferred", isDeferred }
+		}, request.asyncId);
 	}
 }
 
-////////////////////////////////////////////////////////////////////////////////////////////////////////////
-// Log out
-
-// Callback for EOS_Auth_Logout() that forwards to WrapperExtension::OnLogOutCallback()
-void EOS_CALL LogoutCompleteCallbackFn(const EOS_Auth_LogoutCallbackInfo* Data)
+void WrapperExtension::FlushAchievementUnlocks(std::chrono::steady_clock::time_point now)
 {
-	ExtCallbackInfo* callbackInfo = static_cast<ExtCallbackInfo*>(Data->ClientData);
-	callbackInfo->extension->OnLogOutCallback(Data, callbackInfo->asyncId);
-	delete callbackInfo;
-}
+	if (pendingAchievementUnlocks.empty() || now - firstPendingAchievementUnlockTime < achievementBatchWindow)
+		return;
 
-void WrapperExtension::OnLogOutMessage(double asyncId)
-{
-	LogMessage("Starting log out");
+	// Collect all the achievement IDs from every waiting request, skipping duplicates.
+	// Note these point in to the strings in the requests, which are kept alive with the callback info.
+	ExtCallbackInfo* callbackInfo = NewCallbackInfo("achievements-unlock");
+	callbackInfo->unlockRequests.swap(pendingAchievementUnlocks);
 
-	EOS_Auth_LogoutOptions LogoutOptions = {};
-	LogoutOptions.ApiVersion = EOS_AUTH_LOGOUT_API_LATEST;
-	LogoutOptions.LocalUserId = sharedHandles.epicAccountId;
+	std::vector<const char*> achievementIdPtrs;
+	for (const AchievementUnlockRequest& request : callbackInfo->unlockRequests)
+	{
+		for (const std::string& achievementId : request.achievementIds)
+		{
+			auto isSameId = [&achievementId](const char* ptr) { return achievementId == ptr; };
+			if (std::find_if(achievementIdPtrs.begin(), achievementIdPtrs.end(), isSameId) == achievementIdPtrs.end())
+				achievementIdPtrs.push_back(achievementId.c_str());
+		}
+	}
 
-	ExtCallbackInfo* callbackInfo = new ExtCallbackInfo();
-	callbackInfo->extension = this;
-	callbackInfo->asyncId = asyncId;
+	// The batch is a single EOS call, so record its latency stages for each request in it.
+	for (const AchievementUnlockRequest& request : callbackInfo->unlockRequests)
+		RecordMessageLatency(request.asyncId, MessageLatencyStage::EOSCall);
 
-	EOS_Auth_Logout(hAuth, &LogoutOptions, callbackInfo, LogoutCompleteCallbackFn);
+	Log<ExtLogLevel::Debug>("Unlocking ", achievementIdPtrs.size(), " achievement(s) for ", callbackInfo->unlockRequests.size(), " request(s)");
+
+	EOS_Achievements_UnlockAchievementsOptions achievementOpts = {};
+	achievementOpts.ApiVersion = EOS_ACHIEVEMENTS_UNLOCKACHIEVEMENTS_API_LATEST;
+	achievementOpts.UserId = sharedHandles.productUserId;			// from ConnectLogin()
+	achievementOpts.AchievementsCount = static_cast<uint32_t>(achievementIdPtrs.size());
+	achievementOpts.AchievementIds = achievementIdPtrs.data();
+
+	unlockBatchesInFlight++;
+	CallEOSAsync<&WrapperExtension::OnUnlockAchievementsCallback>(callbackInfo, EOS_Achievements_UnlockAchievements, hAchievements, achievementOpts);
 }
 
-void WrapperExtension::OnLogOutCallback(const EOS_Auth_LogoutCallbackInfo* Data, double asyncId)
+void WrapperExtension::OnUnlockAchievementsCallback(const EOS_Achievements_OnUnlockAchievementsCompleteCallbackInfo* Data, const ExtCallbackInfo& callbackInfo)
 {
-	if (Data->ResultCode == EOS_EResult::EOS_Success)
+	const std::vector<AchievementUnlockRequest>& requests = callbackInfo.unlockRequests;
+
+	bool isOk = (Data->ResultCode == EOS_EResult::EOS_Success);
+
+	// Results that mean the unlock can never succeed, such as an unknown achievement ID. Anything else
+	// (e.g. no connection or a timeout) is treated as temporary, and the unlock is kept in the journal to retry.
+	bool isPermanentFailure = (Data->ResultCode == EOS_EResult::EOS_NotFound ||
+							   Data->ResultCode == EOS_EResult::EOS_InvalidParameters ||
+							   Data->ResultCode == EOS_EResult::EOS_InvalidRequest);
+
+	if (isOk)
+		Log<ExtLogLevel::Debug>("OnUnlockAchievementsCallback: success");
+	else
+		Log<ExtLogLevel::Error>("OnUnlockAchievementsCallback: ", EOS_EResult_ToString(Data->ResultCode));
+
+	int64_t unlockTime = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+
+	for (const AchievementUnlockRequest& request : requests)
 	{
-		LogMessage("OnLogOutCallback: success");
+		RecordMessageLatency(request.asyncId, MessageLatencyStage::EOSCallback);
 
-		// Clear details set when logged in
-		sharedHandles.epicAccountId = nullptr;
-		sharedHandles.productUserId = nullptr;
-		userDisplayName = "";
-		userDisplayNameSanitized = "";
-		userNickname = "";
-		userPreferredLanguage = "";
-		userCountry = "";
+		if (isOk || isPermanentFailure)
+			achievementJournal.Acknowledge(request.accountId, request.achievementIds);
 
-		// User logged out OK, so also delete any persisted auth to prevent any future
-		// automatic login.
-		EOS_Auth_DeletePersistentAuthOptions delOpts = {};
-		delOpts.ApiVersion = EOS_AUTH_DELETEPERSISTENTAUTH_API_LATEST;
-		EOS_Auth_DeletePersistentAuth(hAuth, &delOpts, nullptr, [](const EOS_Auth_DeletePersistentAuthCallbackInfo* Data)
+		// Update the cache so later unlocks of the same achievements are skipped, unless the user has since logged out.
+		if (isOk && request.accountId == epicAccountIdStr)
 		{
-			g_Extension->OnDeletePersistentAuthCallback(Data);
-		});
-
-		SendAsyncResponse({
-			{ "isOk", true }
-		}, asyncId);
+			for (const std::string& achievementId : request.achievementIds)
+				achievementCache.SetUnlocked(achievementId, unlockTime);
+		}
 	}
-	else
+
+	unlockBatchesInFlight--;
+	ScheduleAchievementJournalRetry(!isOk && !isPermanentFailure);
+
+	// The batch has a single result, so send the same response to every waiting request. Replayed
+	// unlocks from the journal have no async ID and so no response. Temporary failures are reported
+	// as deferred if the unlocks are still in the journal to be retried later.
+	for (const AchievementUnlockRequest& request : requests)
 	{
-		LogMessage("OnLogOutCallback: failed");
+		if (request.asyncId == -1.0)
+			continue;
+
+		bool isDeferred = !isOk && !isPermanentFailure &&
+			std::all_of(request.achievementIds.begin(), request.achievementIds.end(), [this, &request](const std::string& achievementId)
+			{
+				return achievementJournal.IsPending(request.accountId, achievementId);
+			});
 
 		SendAsyncResponse({
-			{ "isOk", false }
-		}, asyncId);
+			{ "isOk", isOk || isDeferred },
+			{ "isDeferred", isDeferred }
+		}, request.asyncId);
 	}
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////
-// Achievements
-// Note this assumes ConnectLogin() completed successfully and set a valid productUserId.
+// Achievement state
+// Once a product user ID is available, the achievement definitions and the player's achievements are
+// queried once and kept in achievementCache. This is used to skip unlocking achievements the player
+// already has, and to answer the "is-achievement-unlocked" and "get-achievement-progress" messages.
 
-// Callback for EOS_Achievements_UnlockAchievements() that forwards to WrapperExtension::OnUnlockAchievementCallback()
-void EOS_CALL UnlockAchievementCompleteCallbackFn(const EOS_Achievements_OnUnlockAchievementsCompleteCallbackInfo* Data)
+void WrapperExtension::QueryAchievementState()
 {
-	ExtCallbackInfo* callbackInfo = static_cast<ExtCallbackInfo*>(Data->ClientData);
-	callbackInfo->extension->OnUnlockAchievementCallback(Data, callbackInfo->asyncId);
-	delete callbackInfo;
+	Log<ExtLogLevel::Debug>("Querying achievement state");
+
+	EOS_Achievements_QueryDefinitionsOptions defOpts = {};
+	defOpts.ApiVersion = EOS_ACHIEVEMENTS_QUERYDEFINITIONS_API_LATEST;
+	defOpts.LocalUserId = sharedHandles.productUserId;
+
+	CallEOSAsync<&WrapperExtension::OnQueryAchievementDefinitionsCallback>("achievements-query-definitions", EOS_Achievements_QueryDefinitions, hAchievements, defOpts);
+
+	EOS_Achievements_QueryPlayerAchievementsOptions playerOpts = {};
+	playerOpts.ApiVersion = EOS_ACHIEVEMENTS_QUERYPLAYERACHIEVEMENTS_API_LATEST;
+	playerOpts.TargetUserId = sharedHandles.productUserId;
+	playerOpts.LocalUserId = sharedHandles.productUserId;
 
+	CallEOSAsync<&WrapperExtension::OnQueryPlayerAchievementsCallback>("achievements-query-player", EOS_Achievements_QueryPlayerAchievements, hAchievements, playerOpts);
 }
-void WrapperExtension::OnUnlockAchievementMessage(const std::string& achievementId, double asyncId)
+
+void WrapperExtension::OnQueryAchievementDefinitionsCallback(const EOS_Achievements_OnQueryDefinitionsCompleteCallbackInfo* Data)
 {
-	LogMessage("Unlocking achievement");
+	if (Data->ResultCode != EOS_EResult::EOS_Success)
+	{
+		Log<ExtLogLevel::Error>("OnQueryAchievementDefinitionsCallback: failed");
+		return;
+	}
 
-	const char* achievementIdPtr = achievementId.c_str();
+	EOS_Achievements_GetAchievementDefinitionCountOptions countOpts = {};
+	countOpts.ApiVersion = EOS_ACHIEVEMENTS_GETACHIEVEMENTDEFINITIONCOUNT_API_LATEST;
+	uint32_t definitionCount = EOS_Achievements_GetAchievementDefinitionCount(hAchievements, &countOpts);
 
-	EOS_Achievements_UnlockAchievementsOptions achievementOpts = {};
-	achievementOpts.ApiVersion = EOS_ACHIEVEMENTS_UNLOCKACHIEVEMENTS_API_LATEST;
-	achievementOpts.UserId = sharedHandles.productUserId;			// from ConnectLogin()
-	achievementOpts.AchievementsCount = 1;
-	achievementOpts.AchievementIds = &achievementIdPtr;
+	for (uint32_t i = 0; i < definitionCount; ++i)
+	{
+		EOS_Achievements_CopyAchievementDefinitionV2ByIndexOptions copyOpts = {};
+		copyOpts.ApiVersion = EOS_ACHIEVEMENTS_COPYACHIEVEMENTDEFINITIONV2BYINDEX_API_LATEST;
+		copyOpts.AchievementIndex = i;
 
-	ExtCallbackInfo* callbackInfo = new ExtCallbackInfo();
-	callbackInfo->extension = this;
-	callbackInfo->asyncId = asyncId;
+		EOS_Achievements_DefinitionV2* definition = nullptr;
+		if (EOS_Achievements_CopyAchievementDefinitionV2ByIndex(hAchievements, &copyOpts, &definition) == EOS_EResult::EOS_Success)
+		{
+			achievementCache.AddDefinition(definition->AchievementId);
+			EOS_Achievements_DefinitionV2_Release(definition);
+		}
+	}
 
-	EOS_Achievements_UnlockAchievements(hAchievements, &achievementOpts, callbackInfo, UnlockAchievementCompleteCallbackFn);
+	Log<ExtLogLevel::Debug>("OnQueryAchievementDefinitionsCallback: loaded ", definitionCount, " definition(s)");
 }
 
-void WrapperExtension::OnUnlockAchievementCallback(const EOS_Achievements_OnUnlockAchievementsCompleteCallbackInfo* Data, double asyncId)
+void WrapperExtension::OnQueryPlayerAchievementsCallback(const EOS_Achievements_OnQueryPlayerAchievementsCompleteCallbackInfo* Data)
 {
-	if (Data->ResultCode == EOS_EResult::EOS_Success)
+	if (Data->ResultCode != EOS_EResult::EOS_Success)
 	{
-		LogMessage("OnUnlockAchievementCallback: success");
-
-		SendAsyncResponse({
-			{ "isOk", true }
-		}, asyncId);
+		Log<ExtLogLevel::Error>("OnQueryPlayerAchievementsCallback: failed");
+		return;
 	}
-	else
-	{
-		LogMessage("OnUnlockAchievementCallback: failed");
 
-		SendAsyncResponse({
-			{ "isOk", false }
-		}, asyncId);
+	// Ignore the result if the user logged out or changed while the query was in progress.
+	if (Data->UserId != sharedHandles.productUserId)
+		return;
+
+	EOS_Achievements_GetPlayerAchievementCountOptions countOpts = {};
+	countOpts.ApiVersion = EOS_ACHIEVEMENTS_GETPLAYERACHIEVEMENTCOUNT_API_LATEST;
+	countOpts.UserId = sharedHandles.productUserId;
+	uint32_t achievementCount = EOS_Achievements_GetPlayerAchievementCount(hAchievements, &countOpts);
+
+	for (uint32_t i = 0; i < achievementCount; ++i)
+	{
+		EOS_Achievements_CopyPlayerAchievementByIndexOptions copyOpts = {};
+		copyOpts.ApiVersion = EOS_ACHIEVEMENTS_COPYPLAYERACHIEVEMENTBYINDEX_API_LATEST;
+		copyOpts.TargetUserId = sharedHandles.productUserId;
+		copyOpts.LocalUserId = sharedHandles.productUserId;
+		copyOpts.AchievementIndex = i;
+
+		EOS_Achievements_PlayerAchievement* playerAchievement = nullptr;
+		if (EOS_Achievements_CopyPlayerAchievementByIndex(hAchievements, &copyOpts, &playerAchievement) == EOS_EResult::EOS_Success)
+		{
+			achievementCache.SetProgress(playerAchievement->AchievementId, playerAchievement->Progress, playerAchievement->UnlockTime);
+			EOS_Achievements_PlayerAchievement_Release(playerAchievement);
+		}
 	}
+
+	achievementCache.SetReady();
+
+	Log<ExtLogLevel::Debug>("OnQueryPlayerAchievementsCallback: loaded ", achievementCount, " player achievement(s)");
+}
+
+// Both queries are answered from the cache. They respond with isOk false if the player's achievements
+// have not been loaded yet, or the achievement ID is not known.
+void WrapperExtension::OnIsAchievementUnlockedMessage(std::string_view achievementId, double asyncId)
+{
+	const AchievementState* state = achievementCache.IsReady() ? achievementCache.Find(achievementId) : nullptr;
+
+	SendAsyncResponse({
+		{ "isOk", state != nullptr },
+		{ "isUnlocked", state != nullptr && state->IsUnlocked() }
+	}, asyncId);
+}
+
+void WrapperExtension::OnGetAchievementProgressMessage(std::string_view achievementId, double asyncId)
+{
+	const AchievementState* state = achievementCache.IsReady() ? achievementCache.Find(achievementId) : nullptr;
+
+	SendAsyncResponse({
+		{ "isOk", state != nullptr },
+		{ "progress", state != nullptr ? state->progress : 0.0 },
+		{ "unlockTime", state != nullptr ? static_cast<double>(state->unlockTime) : -1.0 }
+	}, asyncId);
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Connect login (to establish Product User ID for achievements)
 
-// Callback for EOS_Connect_Login() that forwards to WrapperExtension::OnConnectLoginCallback()
-void EOS_CALL ConnectLoginCompleteCallbackFn(const EOS_Connect_LoginCallbackInfo* Data)
+void WrapperExtension::ConnectLogin()
 {
-	static_cast<WrapperExtension*>(Data->ClientData)->OnConnectLoginCallback(Data);
+	Log<ExtLogLevel::Debug>("ConnectLogin()");
+
+	ConnectLoginFlow();
 }
 
-void WrapperExtension::ConnectLogin()
+// Obtain a product user ID for the logged in Epic account, creating a new product user if there isn't one yet.
+EOSTask WrapperExtension::ConnectLoginFlow()
 {
-	LogMessage("ConnectLogin()");
+	size_t flowIndex = BeginTimedOperation("flow-connect-login");
+	auto flowStartTime = std::chrono::steady_clock::now();
 
 	// Note the SDK samples use EOS_Auth_CopyUserAuthToken() with EOS_EExternalCredentialType::EOS_ECT_EPIC,
 	// but the documentation states EOS_Auth_CopyIdToken() with EOS_EExternalCredentialType::EOS_ECT_EPIC_ID_TOKEN
@@ -823,73 +1740,122 @@ void WrapperExtension::ConnectLogin()
 	copyIdTokenOpts.ApiVersion = EOS_AUTH_COPYIDTOKEN_API_LATEST;
 	copyIdTokenOpts.AccountId = sharedHandles.epicAccountId;
 
-	if (EOS_Auth_CopyIdToken(hAuth, &copyIdTokenOpts, &authIdToken) == EOS_EResult::EOS_Success)
+	if (EOS_Auth_CopyIdToken(hAuth, &copyIdTokenOpts, &authIdToken) != EOS_EResult::EOS_Success)
 	{
-		EOS_Connect_Credentials Credentials = {};
-		Credentials.ApiVersion = EOS_CONNECT_CREDENTIALS_API_LATEST;
-		Credentials.Token = authIdToken->JsonWebToken;
-		Credentials.Type = EOS_EExternalCredentialType::EOS_ECT_EPIC_ID_TOKEN;
-
-		EOS_Connect_LoginOptions Options = {};
-		Options.ApiVersion = EOS_CONNECT_LOGIN_API_LATEST;
-		Options.Credentials = &Credentials;
-		Options.UserLoginInfo = nullptr;
+		Log<ExtLogLevel::Error>("ConnectLogin(): unable to copy ID token");
 
-		EOS_Connect_Login(hConnect, &Options, this, ConnectLoginCompleteCallbackFn);
-		EOS_Auth_IdToken_Release(authIdToken);
+		isConnectLoginPending = false;
+		ResolveParkedMessages();
+		EndTimedOperation(flowIndex, flowStartTime, EOS_EResult::EOS_InvalidAuth);
+		co_return;
 	}
-}
 
-// Callback for EOS_Connect_CreateUser() that forwards to WrapperExtension::OnConnectCreateUserCallback()
-void EOS_CALL ConnectCreateUserCallbackFn(const EOS_Connect_CreateUserCallbackInfo* Data)
-{
-	static_cast<WrapperExtension*>(Data->ClientData)->OnConnectCreateUserCallback(Data);
-}
+	// Copy the token so it can be released before suspending.
+	std::string idToken = authIdToken->JsonWebToken;
+	EOS_Auth_IdToken_Release(authIdToken);
 
-void WrapperExtension::OnConnectLoginCallback(const EOS_Connect_LoginCallbackInfo* Data)
-{
-	if (Data->ResultCode == EOS_EResult::EOS_Success)
+	EOS_Connect_Credentials Credentials = {};
+	Credentials.ApiVersion = EOS_CONNECT_CREDENTIALS_API_LATEST;
+	Credentials.Token = idToken.c_str();
+	Credentials.Type = EOS_EExternalCredentialType::EOS_ECT_EPIC_ID_TOKEN;
+
+	EOS_Connect_LoginOptions Options = {};
+	Options.ApiVersion = EOS_CONNECT_LOGIN_API_LATEST;
+	Options.Credentials = &Credentials;
+	Options.UserLoginInfo = nullptr;
+
+	isConnectLoginPending = true;
+
+	EOS_Connect_LoginCallbackInfo loginResult = co_await AwaitEOS("connect-login", EOS_Connect_Login, hConnect, Options);
+
+	EOS_EResult result = loginResult.ResultCode;
+	EOS_ProductUserId productUserId = loginResult.LocalUserId;
+
+	if (result == EOS_EResult::EOS_InvalidUser)
 	{
-		LogMessage("OnConnectLoginCallback: success");
+		Log<ExtLogLevel::Debug>("ConnectLoginFlow: creating user");
 
-		// Save the product user ID for use with achievements
-		sharedHandles.productUserId = Data->LocalUserId;
+		// Note always resolve by calling EOS_Connect_CreateUser. (Support for linking accounts is not currently implemented.)
+		// The continuance token is still valid here, as the coroutine is resumed from inside the connect login callback.
+		EOS_Connect_CreateUserOptions createOpts = {};
+		createOpts.ApiVersion = EOS_CONNECT_CREATEUSER_API_LATEST;
+		createOpts.ContinuanceToken = loginResult.ContinuanceToken;
+
+		EOS_Connect_CreateUserCallbackInfo createResult = co_await AwaitEOS("connect-create-user", EOS_Connect_CreateUser, hConnect, createOpts);
+
+		result = createResult.ResultCode;
+		productUserId = createResult.LocalUserId;
 	}
-	else if (Data->ResultCode == EOS_EResult::EOS_InvalidUser)
+
+	isConnectLoginPending = false;
+
+	if (result == EOS_EResult::EOS_Success)
 	{
-		LogMessage("OnConnectLoginCallback: creating user");
+		Log<ExtLogLevel::Info>("ConnectLoginFlow: success");
 
-		// Note always resolve by calling EOS_Connect_CreateUser. (Support for linking accounts is not currently implemented.)
-		EOS_Connect_CreateUserOptions Options = {};
-		Options.ApiVersion = EOS_CONNECT_CREATEUSER_API_LATEST;
-		Options.ContinuanceToken = Data->ContinuanceToken;
+		// Save the product user ID for use with achievements
+		sharedHandles.productUserId = productUserId;
 
-		EOS_Connect_CreateUser(hConnect, &Options, this, ConnectCreateUserCallbackFn);
+		QueryAchievementState();
+		ReplayAchievementJournal();
 	}
 	else
 	{
-		LogMessage("OnConnectLoginCallback: failed");
+		Log<ExtLogLevel::Error>("ConnectLoginFlow: failed");
 	}
+
+	ResolveParkedMessages();
+	EndTimedOperation(flowIndex, flowStartTime, result);
 }
 
-void WrapperExtension::OnConnectCreateUserCallback(const EOS_Connect_CreateUserCallbackInfo* Data)
+// Called once ConnectLogin() definitively succeeds or fails, to handle any messages parked while it was in
+// progress. They are handled in the order they arrived. If it failed, unlocks still take the usual path for having
+// no product user ID, so are saved to the journal and reported as deferred, but every other parked message that
+// expects a response fails. Either way each response includes how long the message waited, as parkedWaitMs.
+void WrapperExtension::ResolveParkedMessages()
 {
-	if (Data->ResultCode == EOS_EResult::EOS_Success)
-	{
-		LogMessage("OnConnectCreateUserCallback: success");
+	if (parkedMessages.empty())
+		return;
 
-		// Save the product user ID for use with achievements
-		sharedHandles.productUserId = Data->LocalUserId;
-	}
-	else
+	std::vector<ParkedWebMessage> messages;
+	messages.swap(parkedMessages);
+
+	bool isConnectLoginOk = (sharedHandles.productUserId != nullptr);
+
+	Log<ExtLogLevel::Debug>("Resolving ", messages.size(), " message(s) parked waiting for product user ID", (isConnectLoginOk ? "" : " (connect login failed)"));
+
+	auto now = std::chrono::steady_clock::now();
+
+	for (const ParkedWebMessage& message : messages)
 	{
-		LogMessage("OnConnectCreateUserCallback: failed");
+		auto waitTime = now - message.parkedTime;
+		parkedMessageCount++;
+		parkedWaitTotal += waitTime;
+		parkedWaitMax = std::max(parkedWaitMax, waitTime);
+
+		Log<ExtLogLevel::Debug>("Message '", message.messageId, "' waited ", std::chrono::duration<double, std::milli>(waitTime).count(), " ms for product user ID");
+
+		WebMessageId id = LookupWebMessageId(message.messageId);
+		bool isUnlock = (id == WebMessageId::UnlockAchievement || id == WebMessageId::UnlockAchievements);
+
+		if (isConnectLoginOk || isUnlock)
+		{
+			std::vector<ExtensionParameterPOD> paramPods = PackExtensionParameters(message.params);
+			HandleWebMessage(message.messageId, ExtensionParameterArrayView(paramPods.size(), paramPods.data()), message.asyncId, message.parkedTime, waitTime);
+		}
+		else if (message.asyncId != -1.0)
+		{
+			SendAsyncResponse({
+				{ "isOk", false },
+				{ "parkedWaitMs", std::chrono::duration<double, std::milli>(waitTime).count() }
+			}, message.asyncId);
+		}
 	}
 }
 
 void WrapperExtension::OnConnectAuthExpiration(const EOS_Connect_AuthExpirationCallbackInfo* Data)
 {
-	LogMessage("OnConnectAuthExpiration()");
+	Log<ExtLogLevel::Info>("OnConnectAuthExpiration()");
 
 	// If still logged in, start ConnectLogin() again to refresh the product user ID
 	if (sharedHandles.epicAccountId != nullptr)
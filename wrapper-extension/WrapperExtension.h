@@ -1,12 +1,95 @@
 
 #include "IApplication.h"
 #include "IExtension.h"
+#include "TickThread.h"
+#include "WebMessages.h"
+#include "WebMessageParams.h"
+#include "AchievementCache.h"
+#include "AchievementJournal.h"
+#include "SlotPool.h"
+#include "LatencyHistogram.h"
+#include "TickProfiler.h"
+#include "AsyncLogger.h"
+#include "EOSLogLevels.h"
+#include "LogRateLimiter.h"
+#include "TraceLog.h"
+#include "MessageRecorder.h"
+#include "SpanTracer.h"
+#include "ExtLog.h"
+
+#include <coroutine>
+
+class WrapperExtension;
+struct EOSTask;
+
+// A request to unlock one or more achievements, waiting to be sent in the next batch.
+struct AchievementUnlockRequest {
+	std::vector<std::string> achievementIds;
+	double asyncId;
+	std::string accountId;		// Epic account ID of the user who made the request, for the journal
+};
+
+// A message held back until ConnectLogin() completes, as it needs a product user ID. The parameters
+// are copied since the message is handled later.
+struct ParkedWebMessage {
+	std::string messageId;
+	std::vector<ExtensionParameter> params;
+	double asyncId;
+	std::chrono::steady_clock::time_point parkedTime;
+};
+
+// A message waiting for its async response, for recording the latency of each stage of handling it.
+struct InFlightWebMessage {
+	double asyncId;
+	WebMessageId id;
+	std::chrono::steady_clock::time_point receiptTime;
+	std::chrono::steady_clock::duration parkedWait;		// time spent parked waiting for a product user ID, if any
+};
+
+// For passing to callbacks. These are allocated from a SlotPool, and the ClientData passed to the EOS SDK is
+// the slot handle (clientData) rather than a pointer, so stale callbacks can be detected and dropped.
+struct ExtCallbackInfo {
+	WrapperExtension* extension;
+	double asyncId;
+	void* clientData;
+	const char* operationName;
+
+	// For AsyncOperationStats
+	size_t operationIndex;
+	std::chrono::steady_clock::time_point issueTime;
+
+	// For operations awaited in a coroutine (see EOSCoroutine.h), the coroutine to resume and where to
+	// write the EOS callback info.
+	std::coroutine_handle<> continuation;
+	void* awaitResult;
+
+	// For batched achievement unlocks, all the requests waiting on the result.
+	std::vector<AchievementUnlockRequest> unlockRequests;
+};
+
+// Timing and result statistics for each kind of async EOS operation, recorded by CallEOSAsync() and
+// AwaitEOS(). Coroutine flows are also recorded, timing the whole flow end-to-end.
+struct AsyncOperationStats {
+	std::string name;
+	uint64_t issuedCount;
+	uint64_t completedCount;
+	uint64_t failedCount;
+	EOS_EResult lastResult;
+	std::chrono::steady_clock::duration totalDuration;
+	std::chrono::steady_clock::duration maxDuration;
+};
 
 // Handles shared with other extensions via the shared pointer API
 struct EOS_Shared_Handles {
 	EOS_HPlatform hPlatform;
 	EOS_EpicAccountId epicAccountId;
 	EOS_ProductUserId productUserId;
+
+	// Run a function on the thread that uses the EOS SDK, as the SDK must only be used from a single thread.
+	// With the "Native tick" property enabled this is the tick thread, so companion plugins must make all their
+	// EOS calls through this, and the function runs before the next tick. Otherwise it runs immediately.
+	// This comes after the handles so their layout is unchanged for companion plugins that predate it.
+	void (*RunOnEOSThread)(void (*func)(void* userData), void* userData);
 };
 
 class WrapperExtension : public IExtension {
@@ -14,8 +97,33 @@ public:
 	WrapperExtension(IApplication* iApplication_);
 
 	void InitEpicGamesSDK(const std::string& productName, const std::string& productVersion);
-	void LogMessage(const std::string& msg);
+	void PlatformTick();
+	void RunOnEOSThread(void (*func)(void* userData), void* userData);
+	bool IsTickBusy(std::chrono::steady_clock::time_point now) const;
+	void EmitLog(ExtLogLevel level, std::string_view msg);
+
+	// Log a message at the given level, concatenating the arguments. This compiles to nothing for levels below
+	// EPICEXT_MIN_LOG_LEVEL (see ExtLog.h).
+	template<ExtLogLevel Level, typename... Args>
+	void Log(const Args&... args)
+	{
+		if constexpr (IsExtLogLevelEnabled(Level))
+		{
+			if (traceLog.IsOpen())
+			{
+				TraceArgs traceArgs;
+				(traceArgs.Add(args), ...);
+				traceLog.Write(TraceCategory::Extension, static_cast<uint8_t>(Level), traceArgs.message != nullptr ? traceArgs.message : "", traceArgs);
+			}
+
+			if constexpr (sizeof...(Args) == 1 && (std::is_convertible_v<const Args&, std::string_view> && ...))
+				EmitLog(Level, std::string_view(args...));
+			else
+				EmitLog(Level, FormatLogMessage(args...));
+		}
+	}
 	void OnEOSLogMessage(const EOS_LogMessage* Message);
+	void LogEOSRepeatSummary(const LogRateLimiter::RepeatSummary& summary);
 
 	// IExtension overrides
 	void Init();
@@ -24,44 +132,106 @@ public:
 
 	// Web messaging methods	
 	void OnWebMessage(LPCSTR messageId, size_t paramCount, const ExtensionParameterPOD* paramArr, double asyncId);
-	void HandleWebMessage(const std::string& messageId, const std::vector<ExtensionParameter>& params, double asyncId);
+	void HandleWebMessage(std::string_view messageId, const ExtensionParameterArrayView& params, double asyncId, std::chrono::steady_clock::time_point receiptTime, std::chrono::steady_clock::duration parkedWait = {});
+
+	void SendWebMessage(const char* messageId, const WebMessageParams& params, double asyncId = -1.0);
+	void SendAsyncResponse(const WebMessageParams& params, double asyncId);
+
+	// Async EOS calls are made with CallEOSAsync() (see EOSAsync.h), which tracks in-flight operations.
+	// Their callback info is allocated with NewCallbackInfo() and its clientData passed to the EOS SDK.
+	// The callback then looks it up with LookupCallbackInfo(), which returns nullptr for stale callbacks,
+	// and releases it with ReleaseCallbackInfo() once complete.
+	template<auto Handler, typename HandleT, typename OptionsT, typename CallbackFnT>
+	void CallEOSAsync(const char* operationName, void (EOS_CALL* eosFunc)(HandleT, const OptionsT*, void*, CallbackFnT), HandleT handle, const OptionsT& options, double asyncId = -1.0);
+	template<auto Handler, typename HandleT, typename OptionsT, typename CallbackFnT>
+	void CallEOSAsync(ExtCallbackInfo* callbackInfo, void (EOS_CALL* eosFunc)(HandleT, const OptionsT*, void*, CallbackFnT), HandleT handle, const OptionsT& options);
+
+	// Awaitable version of an async EOS call, for use in coroutines (see EOSCoroutine.h).
+	template<typename HandleT, typename OptionsT, typename CallbackFnT>
+	auto AwaitEOS(const char* operationName, void (EOS_CALL* eosFunc)(HandleT, const OptionsT*, void*, CallbackFnT), HandleT handle, const OptionsT& options, double asyncId = -1.0);
+
+	ExtCallbackInfo* NewCallbackInfo(const char* operationName, double asyncId = -1.0);
+	ExtCallbackInfo* LookupCallbackInfo(void* clientData);
+	void CompleteAsyncOperation(ExtCallbackInfo& callbackInfo, EOS_EResult result);
+	void ReleaseCallbackInfo(ExtCallbackInfo* callbackInfo);
+	size_t GetAsyncOperationIndex(const char* operationName);
+	size_t BeginTimedOperation(const char* operationName);
+	void EndTimedOperation(size_t operationIndex, std::chrono::steady_clock::time_point startTime, EOS_EResult result);
+	std::string GetAsyncOperationStatsJson() const;
+	void RecordMessageLatency(double asyncId, MessageLatencyStage stage);
 
-	void SendWebMessage(const std::string& messageId, const std::map<std::string, ExtensionParameter>& params, double asyncId = -1.0);
-	void SendAsyncResponse(const std::map<std::string, ExtensionParameter>& params, double asyncId);
+	TickProfiler& GetTickProfiler()
+	{
+		return tickProfiler;
+	}
+	SpanTracer& GetSpanTracer()
+	{
+		return spanTracer;
+	}
+	void RequestFullTickRate();
 
 	// Handler methods for specific kinds of message, and associated callback methods
 	void OnInitMessage(double asyncId);
+	void OnGetTickStatusMessage(double asyncId);
+	void OnRunBenchmarksMessage(double asyncId);
+	void OnGetMetricsMessage(bool reset, double asyncId);
+	void OnGetTickProfileMessage(bool reset, double asyncId);
+	void OnSetEOSLogLevelsMessage(std::string_view logLevels, double asyncId);
+	void OnSetSpanTracingMessage(bool enable, double asyncId);
+	std::string WriteSpanTrace();
 	void OnLogInStatusChanged(const EOS_Auth_LoginStatusChangedCallbackInfo* Data);
 
 	void OnLogInPortalMessage(bool basicProfile, bool friendsList, bool presence, bool country, double asyncId);
-	void OnLogInPortalCallback(const EOS_Auth_LoginCallbackInfo* Data, double asyncId);
-	void HandleSuccessfulLogIn(const EOS_Auth_LoginCallbackInfo* Data, double asyncId);
-
 	void OnLogInPersistentMessage(bool basicProfile, bool friendsList, bool presence, bool country, double asyncId);
-	void OnLogInPersistentCallback(const EOS_Auth_LoginCallbackInfo* Data, double asyncId);
-	void OnDeletePersistentAuthCallback(const EOS_Auth_DeletePersistentAuthCallbackInfo* Data);
-
 	void OnLogInExchangeCodeMessage(bool basicProfile, bool friendsList, bool presence, bool country, const std::string& exchangeCode, double asyncId);
-	void OnLogInExchangeCodeCallback(const EOS_Auth_LoginCallbackInfo* Data, double asyncId);
-
 	void OnLogInDevAuthToolMessage(bool basicProfile, bool friendsList, bool presence, bool country, const std::string& host, const std::string& credentialName, double asyncId);
-	void OnLogInDevAuthToolCallback(const EOS_Auth_LoginCallbackInfo* Data, double asyncId);
+	EOSTask LogInFlow(const char* flowName, EOS_ELoginCredentialType credentialType, EOS_EAuthScopeFlags scopeFlags, std::string id, std::string token, double asyncId);
+	void HandleSuccessfulLogIn(const EOS_Auth_LoginCallbackInfo* Data, double asyncId);
+	void OnDeletePersistentAuthCallback(const EOS_Auth_DeletePersistentAuthCallbackInfo* Data);
 
 	void OnLogOutMessage(double asyncId);
 	void OnLogOutCallback(const EOS_Auth_LogoutCallbackInfo* Data, double asyncId);
 
 	void OnUnlockAchievementMessage(const std::string& achievementId, double asyncId);
-	void OnUnlockAchievementCallback(const EOS_Achievements_OnUnlockAchievementsCompleteCallbackInfo* Data, double asyncId);
+	void OnUnlockAchievementsMessage(const std::string& achievementIdsJson, double asyncId);
+	void QueueAchievementUnlock(std::vector<std::string> achievementIds, double asyncId);
+	void FlushAchievementUnlocks(std::chrono::steady_clock::time_point now);
+	void ReplayAchievementJournal();
+	void RetryAchievementJournal(std::chrono::steady_clock::time_point now);
+	void ScheduleAchievementJournalRetry(bool isFailure);
+	void DropPendingAchievementUnlocks();
+	void OnUnlockAchievementsCallback(const EOS_Achievements_OnUnlockAchievementsCompleteCallbackInfo* Data, const ExtCallbackInfo& callbackInfo);
+
+	void QueryAchievementState();
+	void OnQueryAchievementDefinitionsCallback(const EOS_Achievements_OnQueryDefinitionsCompleteCallbackInfo* Data);
+	void OnQueryPlayerAchievementsCallback(const EOS_Achievements_OnQueryPlayerAchievementsCompleteCallbackInfo* Data);
+	void OnIsAchievementUnlockedMessage(std::string_view achievementId, double asyncId);
+	void OnGetAchievementProgressMessage(std::string_view achievementId, double asyncId);
 
 	void ConnectLogin();
-	void OnConnectLoginCallback(const EOS_Connect_LoginCallbackInfo* Data);
-	void OnConnectCreateUserCallback(const EOS_Connect_CreateUserCallbackInfo* Data);
+	EOSTask ConnectLoginFlow();
+	void ResolveParkedMessages();
 	void OnConnectAuthExpiration(const EOS_Connect_AuthExpirationCallbackInfo* Data);
 
 protected:
 	IApplication* iApplication;
 	HWND hWndMain;
 
+	// Log messages are sent to the console from a background thread, so logging does not hold up the caller.
+	AsyncLogger logger;
+
+	// Repeated EOS log messages are rate limited, and summaries of suppressed repeats are logged instead.
+	LogRateLimiter eosLogRateLimiter;
+	std::chrono::steady_clock::time_point lastLogFlushTime;
+
+	// Optional binary trace log in the app data folder, enabled by the "binary-trace-log" property.
+	bool useTraceLog;
+	TraceLog traceLog;
+
+	// Optional recording of web messages and EOS callback results for replaying with tools/ReplayMessages.cpp,
+	// enabled by the "message-recording" property.
+	MessageRecorder messageRecorder;
+
 	bool didEpicGamesInitOk;
 	bool isEpicLauncher;
 	std::string launcherExchangeCode;
@@ -83,16 +253,74 @@ protected:
 	std::string sandboxId;
 	std::string deploymentId;
 
+	// EOS log levels per category: the exported property, and the levels currently in use.
+	std::string eosLogLevelsProperty;
+	EOSLogLevels eosLogLevels;
+
+	// Native tick mode: when enabled, the extension calls EOS_Platform_Tick() from its own thread
+	// at the given rate, instead of the Construct plugin sending a "platform-tick" message every frame.
+	bool useNativeTick;
+	double nativeTickRate;
+	TickThread tickThread;
+
+	// Adaptive tick rate: tick at the full rate while any async EOS operations are in flight, or shortly
+	// after one completes when follow-up notifications are likely. Otherwise back off to a low idle rate.
+	// Note these are only accessed on the thread using the EOS SDK, so do not need synchronization.
+	int pendingOperationCount;
+	uint64_t totalOperationCount;
+	uint64_t tickCount;
+	uint64_t skippedTickCount;
+	std::chrono::steady_clock::time_point lastTickTime;
+	std::chrono::steady_clock::time_point busyUntilTime;
+
+	// Durations of every EOS_Platform_Tick() call, and the callbacks run in the worst ones.
+	TickProfiler tickProfiler;
+
+	// Spans of messages, ticks, callbacks and sends on every thread, written as a Chrome trace when tracing stops.
+	SpanTracer spanTracer;
+
+	// Callback info for in-flight async EOS operations.
+	SlotPool<ExtCallbackInfo> callbackPool;
+	uint64_t staleCallbackCount;
+	std::vector<AsyncOperationStats> asyncOperationStats;
+
+	// Latency histograms for each stage of handling each kind of message, and the messages still waiting
+	// for their async response. Stages after the dispatch are attributed to a message by its async ID.
+	MessageLatencyMetrics messageLatencyMetrics;
+	std::vector<InFlightWebMessage> inFlightMessages;
+
+	// Achievement unlocks are collected over a short window and then sent together in a single
+	// EOS_Achievements_UnlockAchievements() call. A window of 0 sends them on the next tick.
+	std::chrono::milliseconds achievementBatchWindow;
+	std::vector<AchievementUnlockRequest> pendingAchievementUnlocks;
+	std::chrono::steady_clock::time_point firstPendingAchievementUnlockTime;
+
+	// Achievement definitions and the player's achievement state, loaded after ConnectLogin().
+	AchievementCache achievementCache;
+
+	// Unlocks not yet confirmed by the backend, saved to disk so they can be retried in a later session.
+	AchievementJournal achievementJournal;
+
+	// While the logged in user has unlocks in the journal, e.g. after failing to send them while offline,
+	// they are retried from PlatformTick(), with the delay doubling after each failed attempt.
+	int unlockBatchesInFlight;
+	bool isJournalRetryScheduled;
+	std::chrono::steady_clock::time_point journalRetryTime;
+	std::chrono::steady_clock::duration journalRetryDelay;
+
+	// Readiness gate for messages needing a product user ID. While ConnectLogin() is in progress these
+	// are parked, then handled in order once it completes, along with stats about how long they waited.
+	bool isConnectLoginPending;
+	std::vector<ParkedWebMessage> parkedMessages;
+	uint64_t parkedMessageCount;
+	std::chrono::steady_clock::duration parkedWaitTotal;
+	std::chrono::steady_clock::duration parkedWaitMax;
+
 	// Local user information
+	std::string epicAccountIdStr;
 	std::string userDisplayName;
 	std::string userDisplayNameSanitized;
 	std::string userNickname;
 	std::string userPreferredLanguage;
 	std::string userCountry;
 };
-
-// For passing to callbacks
-struct ExtCallbackInfo {
-	WrapperExtension* extension;
-	double asyncId;
-};
\ No newline at end of file
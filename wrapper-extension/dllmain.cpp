@@ -1,5 +1,11 @@
 // dllmain.cpp : Defines the entry point for the DLL application.
+// This and PlatformWin32.cpp are the only Windows-specific parts of the wrapper extension.
 #include "pch.h"
+#include "WrapperExtension.h"
+
+#ifdef _WIN32
+
+extern WrapperExtension* g_Extension;
 
 BOOL APIENTRY DllMain( HMODULE hModule,
                        DWORD  ul_reason_for_call,
@@ -17,3 +23,13 @@ BOOL APIENTRY DllMain( HMODULE hModule,
     return TRUE;
 }
 
+// Main DLL export function to initialize extension.
+extern "C" {
+	__declspec(dllexport) IExtension* WrapperExtInit(IApplication* iApplication)
+	{
+		g_Extension = new WrapperExtension(iApplication);
+		return g_Extension;
+	}
+}
+
+#endif
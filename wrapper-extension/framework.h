@@ -1,30 +1,33 @@
 #pragma once
 
-// Windows header files
-#define WIN32_LEAN_AND_MEAN             // Exclude rarely-used stuff from Windows headers
-#include <windows.h>
-#include <shellapi.h>					// CommandLineToArgv
+// Platform layer, which includes the Windows header files on Windows
+#include "Platform.h"
 
 // STL includes
 #include <vector>		// std::vector
 #include <map>			// std::map
 #include <string>		// std::string, std::wstring
+#include <string_view>	// std::string_view
 #include <sstream>		// std::stringstream
+#include <algorithm>		// std::min, std::max, std::find_if
 
 // Include Epic Games SDK.
 // Add a compile check for the header as it's not shipped with this codebase.
 // The SDK should be extracted in a subfolder named "epic-games-sdk", such that the include path below exists.
-#if __has_include("epic-games-sdk\\Include\\eos_sdk.h")
+// Forward slashes are used so the paths also work on other platforms.
+#if __has_include("epic-games-sdk/Include/eos_sdk.h")
 
-	#include "epic-games-sdk\\Include\\eos_sdk.h"
+	#include "epic-games-sdk/Include/eos_sdk.h"
 
-	#include "epic-games-sdk\\Include\\eos_logging.h"
-	#include "epic-games-sdk\\Include\\eos_auth.h"
-	#include "epic-games-sdk\\Include\\eos_userinfo.h"
-	#include "epic-games-sdk\\Include\\eos_connect.h"
-	#include "epic-games-sdk\\Include\\eos_achievements.h"
+	#include "epic-games-sdk/Include/eos_logging.h"
+	#include "epic-games-sdk/Include/eos_auth.h"
+	#include "epic-games-sdk/Include/eos_userinfo.h"
+	#include "epic-games-sdk/Include/eos_connect.h"
+	#include "epic-games-sdk/Include/eos_achievements.h"
 
-	// Link Epic Games lib file
+	// Link Epic Games lib file. On other platforms the EOS SDK library must be linked by the build instead.
+	// The mock EOS SDK replaces the library, so it is not linked then.
+#if defined(_WIN32) && !defined(EPICEXT_MOCK_EOS)
 #if defined(_M_X64)
 	#pragma comment(lib, "epic-games-sdk\\Lib\\EOSSDK-Win64-Shipping.lib")
 #elif defined(_M_IX86)
@@ -32,10 +35,30 @@
 #else
 	#error "Unable to identify architecture for EOS SDK lib file"
 #endif
+#endif
 
 #else
 	#error "Unable to find eos_sdk.h. Make sure the Epic Games SDK is extracted in the epic-games-sdk subfolder such that the file 'epic-games-sdk\\Include\\eos_sdk.h' exists."
 #endif
 
+// Build options
+// Uncomment to compile in the benchmarks run by the "run-benchmarks" message (see Benchmarks.cpp).
+// Note this also replaces the global allocation functions in order to count heap allocations.
+//#define EPICEXT_BENCHMARKS
+
+// Uncomment to build against the mock EOS SDK in MockEOS.cpp instead of the real one, with FakeApplication as a
+// stand-in host application, so the extension can run without Epic's backend (e.g. for load tests).
+//#define EPICEXT_MOCK_EOS
+
+// Minimum severity of the extension's own log messages to compile in (see ExtLog.h): 0 = debug, 1 = info,
+// 2 = warning, 3 = error. By default debug messages are only compiled in to debug builds.
+#ifndef EPICEXT_MIN_LOG_LEVEL
+	#ifdef _DEBUG
+		#define EPICEXT_MIN_LOG_LEVEL 0
+	#else
+		#define EPICEXT_MIN_LOG_LEVEL 1
+	#endif
+#endif
+
 // SDK utilities
 #include "Utils.h"